@@ -0,0 +1,200 @@
+#include "distance_kernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DISTANCE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline float Squared(float dx, float dy) { return dx * dx + dy * dy; }
+
+void SquaredDistancesScalar(const float *xs, const float *ys, std::size_t n, float x, float y, float *out) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Squared(xs[i] - x, ys[i] - y);
+}
+
+void SquaredDistancesGatherScalar(const float *xs, const float *ys, const int *indices, std::size_t n,
+                                  float x, float y, float *out) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Squared(xs[indices[i]] - x, ys[indices[i]] - y);
+}
+
+std::size_t ArgMinScalar(const float *xs, const float *ys, std::size_t begin, std::size_t n, float x, float y,
+                         std::size_t best, float best_distance) {
+    for (std::size_t i = begin; i < n; ++i) {
+        const float distance = Squared(xs[i] - x, ys[i] - y);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::size_t ArgMinSquaredDistanceScalar(const float *xs, const float *ys, std::size_t n, float x, float y) {
+    if (n == 0)
+        return 0;
+    return ArgMinScalar(xs, ys, 1, n, x, y, 0, Squared(xs[0] - x, ys[0] - y));
+}
+
+#ifdef DISTANCE_KERNELS_X86
+
+void SquaredDistancesSSE2(const float *xs, const float *ys, std::size_t n, float x, float y, float *out) {
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+    }
+    SquaredDistancesScalar(xs + i, ys + i, n - i, x, y, out + i);
+}
+
+std::size_t ArgMinSquaredDistanceSSE2(const float *xs, const float *ys, std::size_t n, float x, float y) {
+    if (n < 8)
+        return ArgMinSquaredDistanceScalar(xs, ys, n, x, y);
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    __m128 best = _mm_set1_ps(__builtin_inff());
+    __m128i best_index = _mm_setzero_si128();
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+        const __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 less = _mm_cmplt_ps(distance, best);
+        best = _mm_or_ps(_mm_and_ps(less, distance), _mm_andnot_ps(less, best));
+        const __m128i mask = _mm_castps_si128(less);
+        best_index = _mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, best_index));
+        index = _mm_add_epi32(index, step);
+    }
+
+    alignas(16) float lane_best[4];
+    alignas(16) int lane_index[4];
+    _mm_store_ps(lane_best, best);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lane_index), best_index);
+    std::size_t result = lane_index[0];
+    float result_distance = lane_best[0];
+    for (int lane = 1; lane < 4; ++lane) {
+        if (lane_best[lane] < result_distance ||
+            (lane_best[lane] == result_distance && (std::size_t)lane_index[lane] < result)) {
+            result_distance = lane_best[lane];
+            result = lane_index[lane];
+        }
+    }
+    return ArgMinScalar(xs, ys, i, n, x, y, result, result_distance);
+}
+
+__attribute__((target("avx2"))) void SquaredDistancesAVX2(const float *xs, const float *ys, std::size_t n,
+                                                           float x, float y, float *out) {
+    const __m256 px = _mm256_set1_ps(x);
+    const __m256 py = _mm256_set1_ps(y);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), px);
+        const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), py);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    }
+    SquaredDistancesScalar(xs + i, ys + i, n - i, x, y, out + i);
+}
+
+__attribute__((target("avx2"))) void SquaredDistancesGatherAVX2(const float *xs, const float *ys,
+                                                                 const int *indices, std::size_t n,
+                                                                 float x, float y, float *out) {
+    const __m256 px = _mm256_set1_ps(x);
+    const __m256 py = _mm256_set1_ps(y);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices + i));
+        const __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(xs, index, 4), px);
+        const __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(ys, index, 4), py);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    }
+    SquaredDistancesGatherScalar(xs, ys, indices + i, n - i, x, y, out + i);
+}
+
+__attribute__((target("avx2"))) std::size_t ArgMinSquaredDistanceAVX2(const float *xs, const float *ys,
+                                                                       std::size_t n, float x, float y) {
+    if (n < 16)
+        return ArgMinSquaredDistanceScalar(xs, ys, n, x, y);
+    const __m256 px = _mm256_set1_ps(x);
+    const __m256 py = _mm256_set1_ps(y);
+    __m256 best = _mm256_set1_ps(__builtin_inff());
+    __m256i best_index = _mm256_setzero_si256();
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), px);
+        const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), py);
+        const __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        const __m256 less = _mm256_cmp_ps(distance, best, _CMP_LT_OQ);
+        best = _mm256_blendv_ps(best, distance, less);
+        best_index = _mm256_blendv_epi8(best_index, index, _mm256_castps_si256(less));
+        index = _mm256_add_epi32(index, step);
+    }
+
+    alignas(32) float lane_best[8];
+    alignas(32) int lane_index[8];
+    _mm256_store_ps(lane_best, best);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_index), best_index);
+    std::size_t result = lane_index[0];
+    float result_distance = lane_best[0];
+    for (int lane = 1; lane < 8; ++lane) {
+        if (lane_best[lane] < result_distance ||
+            (lane_best[lane] == result_distance && (std::size_t)lane_index[lane] < result)) {
+            result_distance = lane_best[lane];
+            result = lane_index[lane];
+        }
+    }
+    return ArgMinScalar(xs, ys, i, n, x, y, result, result_distance);
+}
+
+#endif  // DISTANCE_KERNELS_X86
+
+struct Dispatch {
+    decltype(&SquaredDistancesScalar) squared_distances = SquaredDistancesScalar;
+    decltype(&SquaredDistancesGatherScalar) squared_distances_gather = SquaredDistancesGatherScalar;
+    decltype(&ArgMinSquaredDistanceScalar) arg_min = ArgMinSquaredDistanceScalar;
+    const char *name = "scalar";
+
+    Dispatch() {
+#ifdef DISTANCE_KERNELS_X86
+        squared_distances = SquaredDistancesSSE2;
+        arg_min = ArgMinSquaredDistanceSSE2;
+        name = "sse2";
+        if (__builtin_cpu_supports("avx2")) {
+            squared_distances = SquaredDistancesAVX2;
+            squared_distances_gather = SquaredDistancesGatherAVX2;
+            arg_min = ArgMinSquaredDistanceAVX2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+const Dispatch &Kernels() {
+    static const Dispatch dispatch;
+    return dispatch;
+}
+
+}  // namespace
+
+void DistanceKernels::SquaredDistances(const float *xs, const float *ys, std::size_t n, float x, float y, float *out) {
+    Kernels().squared_distances(xs, ys, n, x, y, out);
+}
+
+void DistanceKernels::SquaredDistancesGather(const float *xs, const float *ys, const int *indices, std::size_t n,
+                                             float x, float y, float *out) {
+    Kernels().squared_distances_gather(xs, ys, indices, n, x, y, out);
+}
+
+std::size_t DistanceKernels::ArgMinSquaredDistance(const float *xs, const float *ys, std::size_t n, float x, float y) {
+    return Kernels().arg_min(xs, ys, n, x, y);
+}
+
+const char *DistanceKernels::ActiveInstructionSet() { return Kernels().name; }
@@ -0,0 +1,28 @@
+#ifndef DISTANCE_KERNELS_H
+#define DISTANCE_KERNELS_H
+
+#include <cstddef>
+
+// Batch squared-distance kernels over structure-of-arrays float coordinates.
+// On x86-64 the AVX2 variants (8 lanes) are selected at runtime when the CPU
+// supports them, SSE2 (4 lanes) otherwise; other targets use the scalar loop.
+// All variants produce bit-identical results.
+namespace DistanceKernels {
+
+// out[i] = (xs[i] - x)^2 + (ys[i] - y)^2 for i in [0, n).
+void SquaredDistances(const float *xs, const float *ys, std::size_t n, float x, float y, float *out);
+
+// Same as SquaredDistances, reading the coordinates of xs[indices[i]], ys[indices[i]].
+void SquaredDistancesGather(const float *xs, const float *ys, const int *indices, std::size_t n,
+                            float x, float y, float *out);
+
+// Index of the smallest squared distance to (x, y); the first one on ties.
+// Returns 0 when n == 0, which callers must not use as an index.
+std::size_t ArgMinSquaredDistance(const float *xs, const float *ys, std::size_t n, float x, float y);
+
+// Name of the instruction set the dispatcher picked ("avx2", "sse2" or "scalar").
+const char *ActiveInstructionSet();
+
+}  // namespace DistanceKernels
+
+#endif
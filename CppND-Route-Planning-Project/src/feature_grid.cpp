@@ -0,0 +1,96 @@
+#include "feature_grid.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+FeatureGrid::Box EmptyBox()
+{
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    return {inf, inf, -inf, -inf};
+}
+
+void Extend(FeatureGrid::Box &box, const Model &model, const Model::Way &way)
+{
+    const auto &nodes = model.Nodes();
+    for (int node : way.nodes) {
+        box.min_x = std::min(box.min_x, (float)nodes[node].x);
+        box.min_y = std::min(box.min_y, (float)nodes[node].y);
+        box.max_x = std::max(box.max_x, (float)nodes[node].x);
+        box.max_y = std::max(box.max_y, (float)nodes[node].y);
+    }
+}
+
+FeatureGrid::Box WayBox(const Model &model, int way)
+{
+    auto box = EmptyBox();
+    Extend(box, model, model.Ways()[way]);
+    return box;
+}
+
+// Inner rings lie inside the outer ones, so the outer rings bound the shape.
+FeatureGrid::Box PolygonBox(const Model &model, const Model::Multipolygon &mp)
+{
+    auto box = EmptyBox();
+    for (int way : mp.outer)
+        Extend(box, model, model.Ways()[way]);
+    return box;
+}
+
+}  // namespace
+
+FeatureGrid::FeatureGrid(const Model &model, int cells_per_side)
+    : m_CellsPerSide(std::max(1, cells_per_side)), m_Cells((std::size_t)m_CellsPerSide * m_CellsPerSide)
+{
+    m_Extent = 1.f;
+    for (const auto &node : model.Nodes())
+        m_Extent = std::max({m_Extent, (float)node.x, (float)node.y});
+
+    for (const auto &landuse : model.Landuses())
+        Insert(Landuses, PolygonBox(model, landuse));
+    for (const auto &leisure : model.Leisures())
+        Insert(Leisures, PolygonBox(model, leisure));
+    for (const auto &water : model.Waters())
+        Insert(Waters, PolygonBox(model, water));
+    for (const auto &railway : model.Railways())
+        Insert(Railways, WayBox(model, railway.way));
+    for (const auto &road : model.Roads())
+        Insert(Roads, WayBox(model, road.way));
+    for (const auto &building : model.Buildings())
+        Insert(Buildings, PolygonBox(model, building));
+}
+
+int FeatureGrid::Cell(float coordinate) const noexcept
+{
+    const int cell = (int)(coordinate / m_Extent * (float)m_CellsPerSide);
+    return std::clamp(cell, 0, m_CellsPerSide - 1);
+}
+
+void FeatureGrid::Insert(Layer layer, const Box &box)
+{
+    const int item = (int)m_Bounds[layer].size();
+    m_Bounds[layer].push_back(box);
+    if (box.min_x > box.max_x)
+        return;  // No nodes, nothing to draw.
+    for (int cy = Cell(box.min_y); cy <= Cell(box.max_y); ++cy)
+        for (int cx = Cell(box.min_x); cx <= Cell(box.max_x); ++cx)
+            m_Cells[(std::size_t)cy * m_CellsPerSide + cx].push_back(Entry{layer, item});
+}
+
+void FeatureGrid::Query(const Box &box, Selection &out) const
+{
+    for (auto &items : out.items)
+        items.clear();
+
+    for (int cy = Cell(box.min_y); cy <= Cell(box.max_y); ++cy)
+        for (int cx = Cell(box.min_x); cx <= Cell(box.max_x); ++cx)
+            for (const auto &entry : m_Cells[(std::size_t)cy * m_CellsPerSide + cx])
+                if (m_Bounds[entry.layer][entry.item].Intersects(box))
+                    out.items[entry.layer].push_back(entry.item);
+
+    // Features spanning several cells are found once per cell.
+    for (auto &items : out.items) {
+        std::sort(items.begin(), items.end());
+        items.erase(std::unique(items.begin(), items.end()), items.end());
+    }
+}
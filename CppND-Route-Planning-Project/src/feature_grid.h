@@ -0,0 +1,57 @@
+#ifndef FEATURE_GRID_H
+#define FEATURE_GRID_H
+
+#include <array>
+#include <vector>
+#include "model.h"
+
+// Uniform grid over the drawable features of a Model, used to find what
+// intersects a map tile without walking every way. Each feature is stored in
+// every cell its bounding box overlaps; queries test the boxes of the
+// candidates in the covered cells. The grid is immutable after construction
+// and can be queried from several threads at once.
+class FeatureGrid
+{
+public:
+    // Layers in the order Render draws them.
+    enum Layer { Landuses, Leisures, Waters, Railways, Roads, Buildings, LayerCount };
+
+    struct Box {
+        float min_x, min_y, max_x, max_y;
+        bool Intersects(const Box &other) const noexcept {
+            return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y;
+        }
+    };
+
+    // Indices into Model::Landuses(), Leisures(), ... per layer, ascending so
+    // features keep the model's drawing order.
+    struct Selection {
+        std::array<std::vector<int>, LayerCount> items;
+    };
+
+    explicit FeatureGrid(const Model &model, int cells_per_side = 64);
+
+    // Replaces `out` with every feature whose bounding box intersects `box`.
+    void Query(const Box &box, Selection &out) const;
+
+    // Side of the square, anchored at the origin, that covers all nodes.
+    float Extent() const noexcept { return m_Extent; }
+    const Box &Bounds(Layer layer, int item) const noexcept { return m_Bounds[layer][item]; }
+    int Size(Layer layer) const noexcept { return (int)m_Bounds[layer].size(); }
+
+private:
+    struct Entry {
+        int layer;
+        int item;
+    };
+
+    void Insert(Layer layer, const Box &box);
+    int Cell(float coordinate) const noexcept;
+
+    int m_CellsPerSide;
+    float m_Extent = 0.f;
+    std::array<std::vector<Box>, LayerCount> m_Bounds;
+    std::vector<std::vector<Entry>> m_Cells;
+};
+
+#endif
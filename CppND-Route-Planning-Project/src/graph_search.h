@@ -0,0 +1,95 @@
+#ifndef GRAPH_SEARCH_H
+#define GRAPH_SEARCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A node of a (possibly partitioned) road graph. `tile` tells a tiled graph
+// where to find the node; in-memory graphs ignore it.
+struct GraphNodeRef {
+    int node = -1;
+    int tile = 0;
+};
+
+// An outgoing edge as reported by Graph::ForEachEdge. The target's coordinates
+// are carried on the edge so the heuristic never has to look the target up.
+struct GraphEdge {
+    int target;
+    int tile;
+    float length;
+    float x;
+    float y;
+};
+
+struct GraphPath {
+    bool found = false;
+    float distance = 0.0f;        // In normalized map units, like RouteModel.
+    std::vector<int> nodes;       // Start first, goal last.
+};
+
+// A* with a binary heap and lazy deletion over any graph that provides
+//   float X(GraphNodeRef), float Y(GraphNodeRef)
+//   void ForEachEdge(GraphNodeRef, Visitor)   calling Visitor(const GraphEdge &)
+// Edge lengths must be at least the straight-line distance between their ends,
+// which keeps the Euclidean heuristic consistent and the result optimal.
+// Search state is keyed by node id so only touched nodes cost memory.
+template <typename Graph>
+GraphPath AStarShortestPath(Graph &graph, GraphNodeRef start, GraphNodeRef goal)
+{
+    struct State {
+        float g;
+        int parent;
+        int tile;
+        bool closed;
+    };
+    using Entry = std::pair<float, int>;  // (f, node)
+
+    const float goal_x = graph.X(goal);
+    const float goal_y = graph.Y(goal);
+    auto heuristic = [&](float x, float y) { return std::hypot(x - goal_x, y - goal_y); };
+
+    std::unordered_map<int, State> states;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    states[start.node] = State{0.0f, -1, start.tile, false};
+    open.emplace(heuristic(graph.X(start), graph.Y(start)), start.node);
+
+    GraphPath result;
+    while (!open.empty()) {
+        const int current = open.top().second;
+        open.pop();
+        State &state = states[current];
+        if (state.closed)
+            continue;
+        state.closed = true;
+
+        if (current == goal.node) {
+            result.found = true;
+            result.distance = state.g;
+            for (int node = current; node != -1; node = states[node].parent)
+                result.nodes.push_back(node);
+            std::reverse(result.nodes.begin(), result.nodes.end());
+            return result;
+        }
+
+        const float g = state.g;
+        graph.ForEachEdge(GraphNodeRef{current, state.tile}, [&](const GraphEdge &edge) {
+            const float tentative = g + edge.length;
+            auto [it, inserted] = states.try_emplace(edge.target, State{tentative, current, edge.tile, false});
+            if (!inserted) {
+                if (it->second.closed || tentative >= it->second.g)
+                    return;
+                it->second.g = tentative;
+                it->second.parent = current;
+            }
+            open.emplace(tentative + heuristic(edge.x, edge.y), edge.target);
+        });
+    }
+    return result;
+}
+
+#endif
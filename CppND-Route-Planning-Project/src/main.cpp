@@ -1,45 +1,172 @@
+#include <algorithm>
+#include <charconv>
 #include <optional>
-#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <string>
+#include <thread>
+#include <csignal>
 #include <io2d.h>
 #include "route_model.h"
 #include "render.h"
 #include "route_planner.h"
+#include "route_server.h"
+#include "parallel_search.h"
+#include "tile_renderer.h"
+#include "read_file.h"
 
 using namespace std::experimental;
 
-static std::optional<std::vector<std::byte>> ReadFile(const std::string &path)
+static void PrintUsage()
 {
-    std::ifstream is{path, std::ios::binary | std::ios::ate};
-    if (!is)
-        return std::nullopt;
+    std::cout << "Usage: [executable] [-f filename.osm|filename.osm.pbf] [-p search_threads] [-s socket [-w workers] [-c cached_routes]] [-r tile_dir [-z max_zoom] [-w workers]]" << std::endl;
+}
 
-    auto size = is.tellg();
-    std::vector<std::byte> contents(size);
+// Parses a whole decimal argument no smaller than `min`.
+static bool ParseCount(std::string_view arg, std::size_t min, std::size_t &value)
+{
+    std::size_t parsed = 0;
+    auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), parsed);
+    if (ec != std::errc{} || end != arg.data() + arg.size() || parsed < min)
+        return false;
+    value = parsed;
+    return true;
+}
 
-    is.seekg(0);
-    is.read((char *)contents.data(), size);
+// Serves route queries until SIGINT or SIGTERM. The signals are blocked in
+// every thread and consumed by a dedicated waiter, which stops the server.
+static int Serve(RouteModel &model, const std::string &socket_path, std::size_t workers, std::size_t cache_capacity,
+                 unsigned search_threads)
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
 
-    if (contents.empty())
-        return std::nullopt;
-    return std::move(contents);
+    try
+    {
+        RouteServer server{model, socket_path, workers, cache_capacity, search_threads};
+        std::thread waiter([&] {
+            int signal = 0;
+            sigwait(&signals, &signal);
+            server.Stop();
+        });
+        std::cout << "Serving routes on " << socket_path << " with " << workers << " workers." << std::endl;
+        try
+        {
+            server.Run();
+        }
+        catch (...)
+        {
+            pthread_kill(waiter.native_handle(), SIGTERM);
+            waiter.join();
+            throw;
+        }
+        waiter.join();
+        std::cout << "Server stopped." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A path point at a road projection, for drawing a snapped route's ends.
+static RouteModel::Node PathPoint(const SegmentSnap &snap)
+{
+    RouteModel::Node point;
+    point.x = snap.x;
+    point.y = snap.y;
+    return point;
+}
+
+// Renders the map into a PNG tile pyramid without opening a window.
+static int RenderTiles(RouteModel &model, TilePyramidOptions options)
+{
+    try
+    {
+        std::cout << "Rendering zoom levels " << options.min_zoom << "-" << options.max_zoom << " into " << options.output_dir
+                  << std::endl;
+        auto count = RenderTilePyramid(model, options);
+        std::cout << "Wrote " << count << " tiles." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
 }
 
 int main(int argc, const char **argv)
 {
     std::string osm_data_file = "";
+    std::string socket_path = "";
+    std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t cache_capacity = 4096;
+    std::size_t search_threads = 0;
+    TilePyramidOptions tiles;
     if (argc > 1)
     {
         for (int i = 1; i < argc; ++i)
-            if (std::string_view{argv[i]} == "-f" && ++i < argc)
+        {
+            auto arg = std::string_view{argv[i]};
+            if (arg == "-f" && ++i < argc)
                 osm_data_file = argv[i];
+            else if (arg == "-s" && ++i < argc)
+                socket_path = argv[i];
+            else if (arg == "-w" && ++i < argc)
+            {
+                if (!ParseCount(argv[i], 1, workers))
+                {
+                    std::cout << "-w needs a positive number of workers." << std::endl;
+                    PrintUsage();
+                    return 1;
+                }
+            }
+            else if (arg == "-c" && ++i < argc)
+            {
+                if (!ParseCount(argv[i], 1, cache_capacity))
+                {
+                    std::cout << "-c needs a positive number of cached routes." << std::endl;
+                    PrintUsage();
+                    return 1;
+                }
+            }
+            else if (arg == "-p" && ++i < argc)
+            {
+                if (!ParseCount(argv[i], 1, search_threads))
+                {
+                    std::cout << "-p needs a positive number of search threads." << std::endl;
+                    PrintUsage();
+                    return 1;
+                }
+            }
+            else if (arg == "-r" && ++i < argc)
+                tiles.output_dir = argv[i];
+            else if (arg == "-z" && ++i < argc)
+            {
+                std::size_t zoom = 0;
+                if (!ParseCount(argv[i], 0, zoom) || zoom > (std::size_t)kMaxTileZoom)
+                {
+                    std::cout << "-z needs a zoom level from 0 to " << kMaxTileZoom << "." << std::endl;
+                    PrintUsage();
+                    return 1;
+                }
+                tiles.max_zoom = (int)zoom;
+            }
+        }
+        if (osm_data_file.empty())
+            osm_data_file = "../map.osm";
     }
     else
     {
         std::cout << "To specify a map file use the following format: " << std::endl;
-        std::cout << "Usage: [executable] [-f filename.osm]" << std::endl;
+        PrintUsage();
         osm_data_file = "../map.osm";
     }
 
@@ -55,6 +182,21 @@ int main(int argc, const char **argv)
             osm_data = std::move(*data);
     }
 
+    // Headless server mode: load the model once and answer queries over a socket.
+    if (!socket_path.empty())
+    {
+        RouteModel model{osm_data};
+        return Serve(model, socket_path, workers, cache_capacity, (unsigned)search_threads);
+    }
+
+    // Headless tile mode: render the basemap into z/x/y PNG files.
+    if (!tiles.output_dir.empty())
+    {
+        RouteModel model{osm_data};
+        tiles.threads = (unsigned)workers;
+        return RenderTiles(model, tiles);
+    }
+
     // TODO 1: Declare floats `start_x`, `start_y`, `end_x`, and `end_y` and get
     // user input for these values using std::cin. Pass the user input to the
     // RoutePlanner object below in place of 10, 10, 90, 90.
@@ -72,11 +214,47 @@ int main(int argc, const char **argv)
     // Build Model.
     RouteModel model{osm_data};
 
-    // Create RoutePlanner object and perform A* search.
-    RoutePlanner route_planner{model, start_x, start_y, end_x, end_y};
-    route_planner.AStarSearch();
+    if (search_threads > 0)
+    {
+        // Parallel HDA* over the static road graph, between the points
+        // projected onto the nearest roads.
+        const RoadGraph &graph = model.Graph();
+        const auto start = model.SnapToRoad(start_x * 0.01f, start_y * 0.01f);
+        const auto end = model.SnapToRoad(end_x * 0.01f, end_y * 0.01f);
+        GraphPath result;
+        if (start && end)
+            result = ParallelSnappedShortestPath(graph, *start, *end, (unsigned)search_threads);
+        if (result.found)
+        {
+            model.path.push_back(PathPoint(*start));
+            for (int index : result.nodes)
+                model.path.push_back(model.SNodes()[index]);
+            model.path.push_back(PathPoint(*end));
+            std::cout << "Distance: " << result.distance * graph.MetricScale() << " meters. \n";
+        }
+        else
+        {
+            std::cout << "No route found." << std::endl;
+        }
+    }
+    else
+    {
+        // Create RoutePlanner object and perform A* search.
+        try
+        {
+            RoutePlanner route_planner{model, start_x, start_y, end_x, end_y};
+            route_planner.AStarSearch();
 
-    std::cout << "Distance: " << route_planner.GetDistance() << " meters. \n";
+            if (model.path.empty())
+                std::cout << "No route found." << std::endl;
+            else
+                std::cout << "Distance: " << route_planner.GetDistance() << " meters. \n";
+        }
+        catch (const std::logic_error &e)
+        {
+            std::cout << e.what() << std::endl;
+        }
+    }
 
     // Render results of search.
     Render render{model};
@@ -1,4 +1,5 @@
 #include "model.h"
+#include "osm_pbf.h"
 #include "pugixml.hpp"
 #include <iostream>
 #include <string_view>
@@ -39,7 +40,10 @@ static Model::Landuse::Type String2LanduseType(std::string_view type)
 
 Model::Model( const std::vector<std::byte> &xml )
 {
-    LoadData(xml);
+    if( OsmPbf::LooksLikePbf(xml) )
+        LoadPbf(xml);
+    else
+        LoadData(xml);
 
     AdjustCoordinates();
 
@@ -93,50 +97,14 @@ void Model::LoadData(const std::vector<std::byte> &xml)
             else if( name == "tag" ) {
                 auto category = std::string_view{child.attribute("k").as_string()};
                 auto type = std::string_view{child.attribute("v").as_string()};
-                if( category == "highway" ) {
-                    if( auto road_type = String2RoadType(type); road_type != Road::Invalid ) {
-                        m_Roads.emplace_back();
-                        m_Roads.back().way = way_num;
-                        m_Roads.back().type = road_type;
-                    }
-                }
-                if( category == "railway" ) {
-                    m_Railways.emplace_back();
-                    m_Railways.back().way = way_num;
-                }                
-                else if( category == "building" ) {
-                    m_Buildings.emplace_back();
-                    m_Buildings.back().outer = {way_num};
-                }
-                else if( category == "leisure" ||
-                        (category == "natural" && (type == "wood"  || type == "tree_row" || type == "scrub" || type == "grassland")) ||
-                        (category == "landcover" && type == "grass" ) ) {
-                    m_Leisures.emplace_back();
-                    m_Leisures.back().outer = {way_num};
-                }
-                else if( category == "natural" && type == "water" ) {
-                    m_Waters.emplace_back();
-                    m_Waters.back().outer = {way_num};
-                }
-                else if( category == "landuse" ) {
-                    if( auto landuse_type = String2LanduseType(type); landuse_type != Landuse::Invalid ) {
-                        m_Landuses.emplace_back();
-                        m_Landuses.back().outer = {way_num};
-                        m_Landuses.back().type = landuse_type;
-                    }                    
-                }
+                ClassifyWayTag(way_num, category, type);
             }
         }
     }
     
     for( const auto &relation: doc.select_nodes("/osm/relation") ) {
         auto node = relation.node();
-        auto noode_id = std::string_view{node.attribute("id").as_string()};
         std::vector<int> outer, inner;
-        auto commit = [&](Multipolygon &mp) {
-            mp.outer = std::move(outer);
-            mp.inner = std::move(inner);
-        };
         for( auto child: node.children() ) {
             auto name = std::string_view{child.name()}; 
             if( name == "member" ) {
@@ -153,28 +121,147 @@ void Model::LoadData(const std::vector<std::byte> &xml)
             else if( name == "tag" ) { 
                 auto category = std::string_view{child.attribute("k").as_string()};
                 auto type = std::string_view{child.attribute("v").as_string()};
-                if( category == "building" ) {
-                    commit( m_Buildings.emplace_back() );
-                    break;
-                }
-                if( category == "natural" && type == "water" ) {
-                    commit( m_Waters.emplace_back() );
-                    BuildRings(m_Waters.back());
-                    break;
-                }
-                if( category == "landuse" ) {
-                    if( auto landuse_type = String2LanduseType(type); landuse_type != Landuse::Invalid ) {
-                        commit( m_Landuses.emplace_back() );
-                        m_Landuses.back().type = landuse_type;
-                        BuildRings(m_Landuses.back());
-                    }
+                if( ClassifyRelationTag(category, type, outer, inner) )
                     break;
-                }
             }
         }
     }
 }
 
+void Model::LoadPbf(const std::vector<std::byte> &pbf)
+{
+    const auto file = OsmPbf::Decode(pbf);
+
+    std::size_t node_count = 0, way_count = 0;
+    for( const auto &block: file.blocks ) {
+        node_count += block.nodes.size();
+        way_count += block.ways.size();
+    }
+
+    std::unordered_map<std::int64_t, int> node_id_to_num;
+    node_id_to_num.reserve(node_count);
+    m_Nodes.reserve(node_count);
+    for( const auto &block: file.blocks )
+        for( const auto &node: block.nodes ) {
+            node_id_to_num[node.id] = (int)m_Nodes.size();
+            m_Nodes.emplace_back();
+            m_Nodes.back().y = node.lat;
+            m_Nodes.back().x = node.lon;
+        }
+
+    if( file.has_bounds ) {
+        m_MinLat = file.min_lat;
+        m_MaxLat = file.max_lat;
+        m_MinLon = file.min_lon;
+        m_MaxLon = file.max_lon;
+    }
+    else if( !m_Nodes.empty() ) {
+        auto [min_x, max_x] = std::minmax_element(m_Nodes.begin(), m_Nodes.end(), [](auto &a, auto &b){ return a.x < b.x; });
+        auto [min_y, max_y] = std::minmax_element(m_Nodes.begin(), m_Nodes.end(), [](auto &a, auto &b){ return a.y < b.y; });
+        m_MinLon = min_x->x;
+        m_MaxLon = max_x->x;
+        m_MinLat = min_y->y;
+        m_MaxLat = max_y->y;
+    }
+    else
+        throw std::logic_error("map's bounds are not defined");
+
+    std::unordered_map<std::int64_t, int> way_id_to_num;
+    way_id_to_num.reserve(way_count);
+    m_Ways.reserve(way_count);
+    for( const auto &block: file.blocks )
+        for( const auto &way: block.ways ) {
+            const auto way_num = (int)m_Ways.size();
+            way_id_to_num[way.id] = way_num;
+            auto &new_way = m_Ways.emplace_back();
+            new_way.nodes.reserve(way.refs.size());
+            for( auto ref: way.refs )
+                if( auto it = node_id_to_num.find(ref); it != end(node_id_to_num) )
+                    new_way.nodes.emplace_back(it->second);
+            for( const auto &tag: way.tags )
+                ClassifyWayTag(way_num, tag.key, tag.value);
+        }
+
+    for( const auto &block: file.blocks )
+        for( const auto &relation: block.relations ) {
+            std::vector<int> outer, inner;
+            for( const auto &member: relation.members ) {
+                if( member.type != OsmPbf::Member::WayMember )
+                    continue;
+                auto it = way_id_to_num.find(member.ref);
+                if( it == end(way_id_to_num) )
+                    continue;
+                (member.role == "outer" ? outer : inner).emplace_back(it->second);
+            }
+            for( const auto &tag: relation.tags )
+                if( ClassifyRelationTag(tag.key, tag.value, outer, inner) )
+                    break;
+        }
+}
+
+void Model::ClassifyWayTag(int way_num, std::string_view category, std::string_view type)
+{
+    if( category == "highway" ) {
+        if( auto road_type = String2RoadType(type); road_type != Road::Invalid ) {
+            m_Roads.emplace_back();
+            m_Roads.back().way = way_num;
+            m_Roads.back().type = road_type;
+        }
+    }
+    if( category == "railway" ) {
+        m_Railways.emplace_back();
+        m_Railways.back().way = way_num;
+    }                
+    else if( category == "building" ) {
+        m_Buildings.emplace_back();
+        m_Buildings.back().outer = {way_num};
+    }
+    else if( category == "leisure" ||
+            (category == "natural" && (type == "wood"  || type == "tree_row" || type == "scrub" || type == "grassland")) ||
+            (category == "landcover" && type == "grass" ) ) {
+        m_Leisures.emplace_back();
+        m_Leisures.back().outer = {way_num};
+    }
+    else if( category == "natural" && type == "water" ) {
+        m_Waters.emplace_back();
+        m_Waters.back().outer = {way_num};
+    }
+    else if( category == "landuse" ) {
+        if( auto landuse_type = String2LanduseType(type); landuse_type != Landuse::Invalid ) {
+            m_Landuses.emplace_back();
+            m_Landuses.back().outer = {way_num};
+            m_Landuses.back().type = landuse_type;
+        }                    
+    }
+}
+
+bool Model::ClassifyRelationTag(std::string_view category, std::string_view type,
+                                std::vector<int> &outer, std::vector<int> &inner)
+{
+    auto commit = [&](Multipolygon &mp) {
+        mp.outer = std::move(outer);
+        mp.inner = std::move(inner);
+    };
+    if( category == "building" ) {
+        commit( m_Buildings.emplace_back() );
+        return true;
+    }
+    if( category == "natural" && type == "water" ) {
+        commit( m_Waters.emplace_back() );
+        BuildRings(m_Waters.back());
+        return true;
+    }
+    if( category == "landuse" ) {
+        if( auto landuse_type = String2LanduseType(type); landuse_type != Landuse::Invalid ) {
+            commit( m_Landuses.emplace_back() );
+            m_Landuses.back().type = landuse_type;
+            BuildRings(m_Landuses.back());
+        }
+        return true;
+    }
+    return false;
+}
+
 void Model::AdjustCoordinates()
 {    
     const auto pi = 3.14159265358979323846264338327950288;
@@ -3,6 +3,7 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <cstddef>
 
 class Model
@@ -44,6 +45,7 @@ public:
         Type type;
     };
     
+    // Accepts either an .osm XML document or an .osm.pbf file.
     Model( const std::vector<std::byte> &xml );
     
     auto MetricScale() const noexcept { return m_MetricScale; }    
@@ -61,6 +63,10 @@ private:
     void AdjustCoordinates();
     void BuildRings( Multipolygon &mp );
     void LoadData(const std::vector<std::byte> &xml);
+    void LoadPbf(const std::vector<std::byte> &pbf);
+    void ClassifyWayTag(int way_num, std::string_view category, std::string_view type);
+    bool ClassifyRelationTag(std::string_view category, std::string_view type,
+                             std::vector<int> &outer, std::vector<int> &inner);
     
     std::vector<Node> m_Nodes;
     std::vector<Way> m_Ways;
@@ -0,0 +1,443 @@
+#include "osm_pbf.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <zlib.h>
+
+namespace
+{
+    // The format caps an uncompressed blob at 32 MiB; readers reject larger ones.
+    constexpr std::uint64_t kMaxBlobSize = 32u << 20;
+
+    [[noreturn]] void Fail(const std::string &what)
+    {
+        throw std::logic_error("failed to parse the pbf file: " + what);
+    }
+
+    struct Span {
+        const std::uint8_t *begin = nullptr;
+        const std::uint8_t *end = nullptr;
+        std::size_t size() const { return end - begin; }
+        std::string_view view() const { return {reinterpret_cast<const char *>(begin), size()}; }
+    };
+
+    std::int64_t ZigZag(std::uint64_t value)
+    {
+        return (std::int64_t)(value >> 1) ^ -(std::int64_t)(value & 1);
+    }
+
+    // Minimal protobuf wire-format reader.
+    class Reader
+    {
+    public:
+        enum Wire { Varint = 0, Fixed64 = 1, Bytes = 2, Fixed32 = 5 };
+
+        explicit Reader(Span span) : m_Pos(span.begin), m_End(span.end) {}
+
+        // Advances to the next field; false at the end of the message.
+        bool Next()
+        {
+            if( m_Pos >= m_End )
+                return false;
+            const auto key = ReadVarint();
+            m_Field = (int)(key >> 3);
+            m_Wire = (int)(key & 7);
+            return true;
+        }
+
+        int Field() const noexcept { return m_Field; }
+        int WireType() const noexcept { return m_Wire; }
+        bool AtEnd() const noexcept { return m_Pos >= m_End; }
+
+        std::uint64_t ReadVarint()
+        {
+            std::uint64_t value = 0;
+            for( int shift = 0; shift < 64; shift += 7 ) {
+                if( m_Pos >= m_End )
+                    Fail("truncated varint");
+                const std::uint8_t byte = *m_Pos++;
+                value |= (std::uint64_t)(byte & 0x7f) << shift;
+                if( !(byte & 0x80) )
+                    return value;
+            }
+            Fail("varint is too long");
+        }
+
+        std::int64_t ReadSVarint() { return ZigZag(ReadVarint()); }
+
+        Span ReadBytes()
+        {
+            const auto size = ReadVarint();
+            if( size > (std::uint64_t)(m_End - m_Pos) )
+                Fail("truncated field");
+            Span span{m_Pos, m_Pos + size};
+            m_Pos += size;
+            return span;
+        }
+
+        void Skip()
+        {
+            switch( m_Wire ) {
+                case Varint:  ReadVarint(); break;
+                case Bytes:   ReadBytes(); break;
+                case Fixed64: Advance(8); break;
+                case Fixed32: Advance(4); break;
+                default:      Fail("unsupported wire type " + std::to_string(m_Wire));
+            }
+        }
+
+        // Calls `f(value)` for a repeated varint field, packed or not.
+        template <typename F>
+        void ForEachVarint(F &&f)
+        {
+            if( m_Wire == Varint ) {
+                f(ReadVarint());
+                return;
+            }
+            Reader packed{ReadBytes()};
+            while( !packed.AtEnd() )
+                f(packed.ReadVarint());
+        }
+
+    private:
+        void Advance(std::size_t n)
+        {
+            if( n > (std::size_t)(m_End - m_Pos) )
+                Fail("truncated field");
+            m_Pos += n;
+        }
+
+        const std::uint8_t *m_Pos;
+        const std::uint8_t *m_End;
+        int m_Field = 0;
+        int m_Wire = 0;
+    };
+
+    // Inflates (or copies) the payload of a Blob message.
+    std::vector<std::byte> Unpack(Span blob)
+    {
+        Reader reader{blob};
+        Span raw, zlib_data;
+        std::uint64_t raw_size = 0;
+        while( reader.Next() ) {
+            switch( reader.Field() ) {
+                case 1: raw = reader.ReadBytes(); break;
+                case 2: raw_size = reader.ReadVarint(); break;
+                case 3: zlib_data = reader.ReadBytes(); break;
+                case 4: case 5: case 6: case 7:
+                    Fail("only raw and zlib compressed blobs are supported");
+                default: reader.Skip();
+            }
+        }
+        if( raw.begin ) {
+            std::vector<std::byte> out(raw.size());
+            std::memcpy(out.data(), raw.begin, raw.size());
+            return out;
+        }
+        if( !zlib_data.begin )
+            Fail("empty blob");
+        // Checked before allocating: raw_size comes straight from the file.
+        if( raw_size > kMaxBlobSize )
+            Fail("blob larger than 32 MiB");
+
+        std::vector<std::byte> out(raw_size);
+        uLongf out_size = (uLongf)raw_size;
+        if( uncompress(reinterpret_cast<Bytef *>(out.data()), &out_size, zlib_data.begin, (uLong)zlib_data.size()) != Z_OK ||
+            out_size != raw_size )
+            Fail("corrupt zlib data");
+        return out;
+    }
+
+    void DecodeHeader(Span blob, OsmPbf::File &file)
+    {
+        const auto data = Unpack(blob);
+        Reader reader{Span{reinterpret_cast<const std::uint8_t *>(data.data()),
+                           reinterpret_cast<const std::uint8_t *>(data.data()) + data.size()}};
+        while( reader.Next() ) {
+            if( reader.Field() == 1 ) {
+                Reader bbox{reader.ReadBytes()};
+                while( bbox.Next() ) {
+                    const double degrees = bbox.ReadSVarint() / 1e9;
+                    switch( bbox.Field() ) {
+                        case 1: file.min_lon = degrees; break;
+                        case 2: file.max_lon = degrees; break;
+                        case 3: file.max_lat = degrees; break;
+                        case 4: file.min_lat = degrees; break;
+                    }
+                }
+                file.has_bounds = true;
+            }
+            else if( reader.Field() == 4 ) {
+                auto feature = reader.ReadBytes().view();
+                if( feature != "OsmSchema-V0.6" && feature != "DenseNodes" )
+                    Fail("unsupported required feature " + std::string(feature));
+            }
+            else
+                reader.Skip();
+        }
+    }
+
+    class BlockDecoder
+    {
+    public:
+        explicit BlockDecoder(OsmPbf::Block &block) : m_Block(block) {}
+
+        void Decode()
+        {
+            const auto *begin = reinterpret_cast<const std::uint8_t *>(m_Block.raw.data());
+            Reader reader{Span{begin, begin + m_Block.raw.size()}};
+            std::vector<Span> groups;
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1: {
+                        Reader table{reader.ReadBytes()};
+                        while( table.Next() ) {
+                            if( table.Field() == 1 )
+                                m_Strings.push_back(table.ReadBytes().view());
+                            else
+                                table.Skip();
+                        }
+                        break;
+                    }
+                    case 2:  groups.push_back(reader.ReadBytes()); break;
+                    case 17: m_Granularity = (std::int64_t)reader.ReadVarint(); break;
+                    case 19: m_LatOffset = (std::int64_t)reader.ReadVarint(); break;
+                    case 20: m_LonOffset = (std::int64_t)reader.ReadVarint(); break;
+                    default: reader.Skip();
+                }
+            }
+            // Groups are decoded last because granularity and offsets follow them.
+            for( auto group : groups )
+                DecodeGroup(group);
+        }
+
+    private:
+        std::string_view String(std::uint64_t index) const
+        {
+            if( index >= m_Strings.size() )
+                Fail("string index out of range");
+            return m_Strings[index];
+        }
+
+        double Lat(std::int64_t value) const { return (m_LatOffset + m_Granularity * value) / 1e9; }
+        double Lon(std::int64_t value) const { return (m_LonOffset + m_Granularity * value) / 1e9; }
+
+        void DecodeGroup(Span group)
+        {
+            Reader reader{group};
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1:  DecodeNode(reader.ReadBytes()); break;
+                    case 2:  DecodeDenseNodes(reader.ReadBytes()); break;
+                    case 3:  DecodeWay(reader.ReadBytes()); break;
+                    case 4:  DecodeRelation(reader.ReadBytes()); break;
+                    default: reader.Skip();
+                }
+            }
+        }
+
+        void DecodeNode(Span message)
+        {
+            Reader reader{message};
+            OsmPbf::Node node{0, 0., 0.};
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1:  node.id = reader.ReadSVarint(); break;
+                    case 8:  node.lat = Lat(reader.ReadSVarint()); break;
+                    case 9:  node.lon = Lon(reader.ReadSVarint()); break;
+                    default: reader.Skip();
+                }
+            }
+            m_Block.nodes.push_back(node);
+        }
+
+        void DecodeDenseNodes(Span message)
+        {
+            Reader reader{message};
+            std::vector<std::int64_t> ids, lats, lons;
+            auto delta = [](std::vector<std::int64_t> &out) {
+                return [&out](std::uint64_t value) {
+                    out.push_back((out.empty() ? 0 : out.back()) + ZigZag(value));
+                };
+            };
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1:  reader.ForEachVarint(delta(ids)); break;
+                    case 8:  reader.ForEachVarint(delta(lats)); break;
+                    case 9:  reader.ForEachVarint(delta(lons)); break;
+                    default: reader.Skip();
+                }
+            }
+            if( lats.size() != ids.size() || lons.size() != ids.size() )
+                Fail("dense node arrays differ in length");
+            m_Block.nodes.reserve(m_Block.nodes.size() + ids.size());
+            for( std::size_t i = 0; i < ids.size(); ++i )
+                m_Block.nodes.push_back(OsmPbf::Node{ids[i], Lat(lats[i]), Lon(lons[i])});
+        }
+
+        std::vector<OsmPbf::Tag> Tags(const std::vector<std::uint64_t> &keys, const std::vector<std::uint64_t> &vals) const
+        {
+            if( keys.size() != vals.size() )
+                Fail("tag keys and values differ in length");
+            std::vector<OsmPbf::Tag> tags;
+            tags.reserve(keys.size());
+            for( std::size_t i = 0; i < keys.size(); ++i )
+                tags.push_back(OsmPbf::Tag{String(keys[i]), String(vals[i])});
+            return tags;
+        }
+
+        void DecodeWay(Span message)
+        {
+            Reader reader{message};
+            OsmPbf::Way way;
+            way.id = 0;
+            std::vector<std::uint64_t> keys, vals;
+            auto append = [](std::vector<std::uint64_t> &out) { return [&out](std::uint64_t v) { out.push_back(v); }; };
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1:  way.id = (std::int64_t)reader.ReadVarint(); break;
+                    case 2:  reader.ForEachVarint(append(keys)); break;
+                    case 3:  reader.ForEachVarint(append(vals)); break;
+                    case 8: {
+                        std::int64_t ref = 0;
+                        reader.ForEachVarint([&](std::uint64_t v) { way.refs.push_back(ref += ZigZag(v)); });
+                        break;
+                    }
+                    default: reader.Skip();
+                }
+            }
+            way.tags = Tags(keys, vals);
+            m_Block.ways.push_back(std::move(way));
+        }
+
+        void DecodeRelation(Span message)
+        {
+            Reader reader{message};
+            OsmPbf::Relation relation;
+            relation.id = 0;
+            std::vector<std::uint64_t> keys, vals, roles, types;
+            std::vector<std::int64_t> ids;
+            auto append = [](std::vector<std::uint64_t> &out) { return [&out](std::uint64_t v) { out.push_back(v); }; };
+            while( reader.Next() ) {
+                switch( reader.Field() ) {
+                    case 1:  relation.id = (std::int64_t)reader.ReadVarint(); break;
+                    case 2:  reader.ForEachVarint(append(keys)); break;
+                    case 3:  reader.ForEachVarint(append(vals)); break;
+                    case 8:  reader.ForEachVarint(append(roles)); break;
+                    case 9: {
+                        std::int64_t id = 0;
+                        reader.ForEachVarint([&](std::uint64_t v) { ids.push_back(id += ZigZag(v)); });
+                        break;
+                    }
+                    case 10: reader.ForEachVarint(append(types)); break;
+                    default: reader.Skip();
+                }
+            }
+            if( roles.size() != ids.size() || types.size() != ids.size() )
+                Fail("relation member arrays differ in length");
+            relation.members.reserve(ids.size());
+            for( std::size_t i = 0; i < ids.size(); ++i ) {
+                if( types[i] > OsmPbf::Member::RelationMember )
+                    Fail("unknown relation member type " + std::to_string(types[i]));
+                relation.members.push_back(OsmPbf::Member{ids[i], (OsmPbf::Member::Type)types[i], String(roles[i])});
+            }
+            relation.tags = Tags(keys, vals);
+            m_Block.relations.push_back(std::move(relation));
+        }
+
+        OsmPbf::Block &m_Block;
+        std::vector<std::string_view> m_Strings;
+        std::int64_t m_Granularity = 100;
+        std::int64_t m_LatOffset = 0;
+        std::int64_t m_LonOffset = 0;
+    };
+}
+
+bool OsmPbf::LooksLikePbf(const std::vector<std::byte> &data) noexcept
+{
+    // A PBF file starts with the big-endian length of the first BlobHeader,
+    // whose first field is the type string "OSMHeader".
+    static constexpr char kType[] = "OSMHeader";
+    if( data.size() < 4 + 2 + sizeof(kType) - 1 )
+        return false;
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(data.data());
+    return bytes[0] == 0 && bytes[4] == 0x0a && bytes[5] == sizeof(kType) - 1 &&
+           std::memcmp(bytes + 6, kType, sizeof(kType) - 1) == 0;
+}
+
+OsmPbf::File OsmPbf::Decode(const std::vector<std::byte> &data, unsigned threads)
+{
+    File file;
+    std::vector<Span> data_blobs;
+
+    const auto *pos = reinterpret_cast<const std::uint8_t *>(data.data());
+    const auto *end = pos + data.size();
+    while( pos < end ) {
+        if( end - pos < 4 )
+            Fail("truncated blob header length");
+        const std::uint32_t header_size = (std::uint32_t)pos[0] << 24 | (std::uint32_t)pos[1] << 16 |
+                                          (std::uint32_t)pos[2] << 8 | (std::uint32_t)pos[3];
+        pos += 4;
+        if( header_size > (std::size_t)(end - pos) )
+            Fail("truncated blob header");
+
+        Reader header{Span{pos, pos + header_size}};
+        std::string_view type;
+        std::uint64_t blob_size = 0;
+        while( header.Next() ) {
+            if( header.Field() == 1 )
+                type = header.ReadBytes().view();
+            else if( header.Field() == 3 )
+                blob_size = header.ReadVarint();
+            else
+                header.Skip();
+        }
+        pos += header_size;
+        if( blob_size > (std::size_t)(end - pos) )
+            Fail("truncated blob");
+
+        const Span blob{pos, pos + blob_size};
+        if( type == "OSMHeader" )
+            DecodeHeader(blob, file);
+        else if( type == "OSMData" )
+            data_blobs.push_back(blob);
+        pos += blob_size;
+    }
+
+    file.blocks.resize(data_blobs.size());
+    if( threads == 0 )
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<std::size_t>(threads, data_blobs.size());
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&] {
+        for( std::size_t i = next++; i < data_blobs.size(); i = next++ ) {
+            try {
+                file.blocks[i].raw = Unpack(data_blobs[i]);
+                BlockDecoder{file.blocks[i]}.Decode();
+            }
+            catch( ... ) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if( !error )
+                    error = std::current_exception();
+                next = data_blobs.size();
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for( unsigned i = 1; i < threads; ++i )
+        pool.emplace_back(work);
+    work();
+    for( auto &thread : pool )
+        thread.join();
+    if( error )
+        std::rethrow_exception(error);
+    return file;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Reader for the OpenStreetMap PBF format (https://wiki.openstreetmap.org/wiki/PBF_Format).
+// The file is a sequence of length-prefixed blobs; the framing is scanned
+// serially, then the zlib-compressed blobs are inflated and decoded on a thread
+// pool, one PrimitiveBlock per task. Results are kept per block in file order so
+// consumers see elements in the same order as in the equivalent XML file.
+// Only what Model needs is decoded: node coordinates, way refs and tags, and
+// relation members and tags. Dense nodes are delta-decoded.
+namespace OsmPbf
+{
+    struct Tag {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    struct Node {
+        std::int64_t id;
+        double lat;
+        double lon;
+    };
+
+    struct Way {
+        std::int64_t id;
+        std::vector<std::int64_t> refs;
+        std::vector<Tag> tags;
+    };
+
+    struct Member {
+        enum Type { NodeMember = 0, WayMember = 1, RelationMember = 2 };
+        std::int64_t ref;
+        Type type;
+        std::string_view role;
+    };
+
+    struct Relation {
+        std::int64_t id;
+        std::vector<Member> members;
+        std::vector<Tag> tags;
+    };
+
+    // One decoded PrimitiveBlock. Tag and role strings point into `raw`, the
+    // decompressed block, so they stay valid as long as the block does.
+    struct Block {
+        std::vector<std::byte> raw;
+        std::vector<Node> nodes;
+        std::vector<Way> ways;
+        std::vector<Relation> relations;
+    };
+
+    struct File {
+        bool has_bounds = false;
+        double min_lat = 0., max_lat = 0., min_lon = 0., max_lon = 0.;
+        std::vector<Block> blocks;
+    };
+
+    // True if `data` starts like a PBF file rather than an XML document.
+    bool LooksLikePbf(const std::vector<std::byte> &data) noexcept;
+
+    // Decodes a whole file. `threads` == 0 uses std::thread::hardware_concurrency().
+    // Throws std::logic_error on malformed input or unsupported compression.
+    File Decode(const std::vector<std::byte> &data, unsigned threads = 0);
+}
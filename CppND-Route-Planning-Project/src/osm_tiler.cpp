@@ -0,0 +1,207 @@
+// Offline partitioner for the tiled route model.
+//
+//   osm_tiler -f map.osm -o map.tiles [-n max_nodes_per_tile]
+//       parses an OpenStreetMap file and writes its road graph as a tile pack.
+//   osm_tiler -t map.tiles -q start_x start_y end_x end_y [-b budget_bytes]
+//       routes on a tile pack (coordinates in percent, as in OSM_A_star_search),
+//       loading tiles on demand within the memory budget.
+//   osm_tiler -f map.osm -q start_x start_y end_x end_y [-p search_threads]
+//       routes on the whole in-memory road graph, with the parallel HDA*
+//       search when -p is given and sequential A* otherwise.
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "model.h"
+#include "parallel_search.h"
+#include "read_file.h"
+#include "road_graph.h"
+#include "tile_store.h"
+
+static void Usage()
+{
+    std::cout << "Usage: osm_tiler -f map.osm -o map.tiles [-n max_nodes_per_tile]" << std::endl;
+    std::cout << "       osm_tiler -t map.tiles -q start_x start_y end_x end_y [-b budget_bytes]" << std::endl;
+    std::cout << "       osm_tiler -f map.osm -q start_x start_y end_x end_y [-p search_threads]" << std::endl;
+}
+
+// Parses a whole decimal argument in [min, max].
+static bool ParseCount(std::string_view arg, std::size_t min, std::size_t max, std::size_t &value)
+{
+    std::size_t parsed = 0;
+    auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), parsed);
+    if (ec != std::errc{} || end != arg.data() + arg.size() || parsed < min || parsed > max)
+        return false;
+    value = parsed;
+    return true;
+}
+
+// Parses a whole finite number, e.g. a query coordinate.
+static bool ParseCoordinate(std::string_view arg, float &value)
+{
+    float parsed = 0;
+    auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), parsed);
+    if (ec != std::errc{} || end != arg.data() + arg.size() || !std::isfinite(parsed))
+        return false;
+    value = parsed;
+    return true;
+}
+
+// The road graph node nearest to (x, y), in normalized map units.
+static int ClosestNode(const RoadGraph &graph, float x, float y)
+{
+    int closest = -1;
+    float min_dist = std::numeric_limits<float>::max();
+    for (int node = 0; node < graph.NodeCount(); ++node)
+    {
+        if (graph.Degree(node) == 0)
+            continue;
+        const float dist = std::hypot(graph.X(node) - x, graph.Y(node) - y);
+        if (dist < min_dist)
+        {
+            min_dist = dist;
+            closest = node;
+        }
+    }
+    return closest;
+}
+
+int main(int argc, const char **argv)
+{
+    std::string osm_file, output_file, tiles_file;
+    std::size_t max_nodes = 4096;
+    std::size_t budget = 64u << 20;
+    std::size_t search_threads = 0;
+    std::vector<float> query;
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view{argv[i]};
+        if (arg == "-f" && ++i < argc)
+            osm_file = argv[i];
+        else if (arg == "-o" && ++i < argc)
+            output_file = argv[i];
+        else if (arg == "-n" && ++i < argc)
+        {
+            if (!ParseCount(argv[i], 1, INT_MAX, max_nodes))
+            {
+                std::cout << "-n needs a positive number of nodes per tile." << std::endl;
+                Usage();
+                return 1;
+            }
+        }
+        else if (arg == "-t" && ++i < argc)
+            tiles_file = argv[i];
+        else if (arg == "-b" && ++i < argc)
+        {
+            if (!ParseCount(argv[i], 1, SIZE_MAX, budget))
+            {
+                std::cout << "-b needs a positive memory budget in bytes." << std::endl;
+                Usage();
+                return 1;
+            }
+        }
+        else if (arg == "-p" && ++i < argc)
+        {
+            if (!ParseCount(argv[i], 1, UINT_MAX, search_threads))
+            {
+                std::cout << "-p needs a positive number of search threads." << std::endl;
+                Usage();
+                return 1;
+            }
+        }
+        else if (arg == "-q" && i + 4 < argc)
+        {
+            query.assign(4, 0.0f);
+            for (float &coordinate : query)
+            {
+                if (!ParseCoordinate(argv[++i], coordinate))
+                {
+                    std::cout << "-q needs four numbers: start_x start_y end_x end_y." << std::endl;
+                    Usage();
+                    return 1;
+                }
+            }
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    try
+    {
+        if (!osm_file.empty() && !output_file.empty())
+        {
+            auto data = ReadFile(osm_file);
+            if (!data)
+            {
+                std::cout << "Failed to read " << osm_file << std::endl;
+                return 1;
+            }
+            Model model{*data};
+            RoadGraph graph{model};
+            const auto tiles = WriteTiles(graph, output_file, (int)max_nodes);
+            std::cout << "Wrote " << tiles << " tiles (" << graph.NodeCount() << " nodes, "
+                      << graph.EdgeCount() << " directed edges) to " << output_file << std::endl;
+            return 0;
+        }
+        if (!osm_file.empty() && query.size() == 4)
+        {
+            auto data = ReadFile(osm_file);
+            if (!data)
+            {
+                std::cout << "Failed to read " << osm_file << std::endl;
+                return 1;
+            }
+            Model model{*data};
+            RoadGraph graph{model};
+            const int start = ClosestNode(graph, query[0] * 0.01f, query[1] * 0.01f);
+            const int end = ClosestNode(graph, query[2] * 0.01f, query[3] * 0.01f);
+            if (start < 0 || end < 0)
+            {
+                std::cout << "No route." << std::endl;
+                return 1;
+            }
+            auto path = search_threads > 0
+                            ? ParallelAStarShortestPath(graph, GraphNodeRef{start}, GraphNodeRef{end},
+                                                        (unsigned)search_threads)
+                            : AStarShortestPath(graph, GraphNodeRef{start}, GraphNodeRef{end});
+            if (!path.found)
+                std::cout << "No route." << std::endl;
+            else
+                std::cout << "Distance: " << path.distance * graph.MetricScale() << " meters, "
+                          << path.nodes.size() << " nodes." << std::endl;
+            return path.found ? 0 : 1;
+        }
+        if (!tiles_file.empty() && query.size() == 4)
+        {
+            TiledRouteModel model{tiles_file, budget};
+            auto start = model.FindClosestNode(query[0] * 0.01f, query[1] * 0.01f);
+            auto end = model.FindClosestNode(query[2] * 0.01f, query[3] * 0.01f);
+            auto path = model.FindPath(start, end);
+            if (!path.found)
+                std::cout << "No route." << std::endl;
+            else
+                std::cout << "Distance: " << path.distance * model.MetricScale() << " meters, "
+                          << path.nodes.size() << " nodes." << std::endl;
+            const auto &stats = model.GetStats();
+            std::cout << "Tiles: " << model.TileCount() << " total, " << stats.loads << " loads, "
+                      << stats.evictions << " evictions, " << stats.resident_bytes << " bytes resident." << std::endl;
+            return path.found ? 0 : 1;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    Usage();
+    return 1;
+}
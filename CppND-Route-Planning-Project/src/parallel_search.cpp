@@ -0,0 +1,359 @@
+#include "parallel_search.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Message {
+    int node;
+    int parent;
+    float g;
+};
+
+struct Batch {
+    Batch *next = nullptr;
+    std::vector<Message> messages;
+};
+
+// Multi-producer, single-consumer mailbox: producers push whole batches onto a
+// Treiber stack, the owning worker takes the entire stack with one exchange.
+class Mailbox {
+public:
+    ~Mailbox() {
+        for (Batch *batch = TakeAll(); batch != nullptr;) {
+            Batch *next = batch->next;
+            delete batch;
+            batch = next;
+        }
+    }
+
+    // Sequentially consistent so that a producer which then finds the owner
+    // parked cannot miss it, and a parking owner cannot miss the batch.
+    void Push(Batch *batch) {
+        batch->next = m_Head.load(std::memory_order_relaxed);
+        while (!m_Head.compare_exchange_weak(batch->next, batch, std::memory_order_seq_cst, std::memory_order_relaxed))
+            ;
+    }
+
+    Batch *TakeAll() { return m_Head.exchange(nullptr, std::memory_order_acquire); }
+    bool Empty() const { return m_Head.load() == nullptr; }
+
+private:
+    std::atomic<Batch *> m_Head{nullptr};
+};
+
+struct Record {
+    float g;
+    int parent;
+};
+
+// A node the goal is reached from, and the cost of the last step: the goal
+// node itself at no cost, or an end of the goal's segment.
+struct Exit {
+    int node;
+    float cost;
+};
+
+struct OpenEntry {
+    float f;
+    float g;
+    int node;
+    bool operator<(const OpenEntry &other) const {
+        // std::push_heap builds a max-heap; invert so the smallest f is on top,
+        // preferring deeper nodes on ties.
+        return f > other.f || (f == other.f && g < other.g);
+    }
+};
+
+class Search;
+
+class alignas(64) Worker {
+public:
+    Worker(Search &search, unsigned id);
+    void Run();
+    void Relax(const Message &message);
+    // Wakes the worker if it is parked waiting for messages.
+    void Wake();
+
+    Mailbox mailbox;
+    std::unordered_map<int, Record> records;
+
+private:
+    bool ExpandOne();
+    void Flush();
+    void Park();
+
+    Search &m_Search;
+    unsigned m_Id;
+    std::vector<OpenEntry> m_Open;
+    std::vector<std::vector<Message>> m_Outgoing;
+
+    std::atomic<bool> m_Parked{false};
+    std::mutex m_ParkMutex;
+    std::condition_variable m_ParkCondition;
+};
+
+class Search {
+public:
+    Search(const RoadGraph &graph, float goal_x, float goal_y, std::vector<Exit> exits, unsigned threads)
+        : graph(graph), goal_x(goal_x), goal_y(goal_y), exits(std::move(exits)), threads(threads),
+          work((long)threads) {
+        for (unsigned i = 0; i < threads; ++i)
+            workers.push_back(std::make_unique<Worker>(*this, i));
+    }
+
+    unsigned Owner(int node) const {
+        const std::uint64_t hash = (std::uint64_t)(std::uint32_t)node * 0x9E3779B97F4A7C15ull;
+        return (unsigned)((hash >> 32) % threads);
+    }
+
+    // Called by the worker that brings `work` to zero.
+    void Finish() {
+        for (auto &worker : workers)
+            worker->Wake();
+    }
+
+    float Heuristic(int node) const { return std::hypot(graph.X(node) - goal_x, graph.Y(node) - goal_y); }
+
+    const Exit *ExitAt(int node) const {
+        for (const Exit &exit : exits)
+            if (exit.node == node)
+                return &exit;
+        return nullptr;
+    }
+
+    void OfferSolution(float cost) {
+        float current = incumbent.load();
+        while (cost < current && !incumbent.compare_exchange_weak(current, cost))
+            ;
+    }
+
+    const RoadGraph &graph;
+    const float goal_x;
+    const float goal_y;
+    const std::vector<Exit> exits;
+    const unsigned threads;
+
+    // Best goal cost found so far; nodes with f >= incumbent are pruned.
+    std::atomic<float> incumbent{std::numeric_limits<float>::infinity()};
+    // Busy workers plus messages sent but not yet absorbed into an open list.
+    // A message is counted before it is pushed and a worker only goes idle after
+    // flushing its own messages, so the count reaches zero exactly once: when
+    // no work is left anywhere.
+    std::atomic<long> work;
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+constexpr int kFlushInterval = 16;
+// Yields an idle worker makes before parking. Short gaps between batches are
+// common while the search front is narrow; a parked worker costs a futex wake.
+constexpr int kIdleSpins = 64;
+
+Worker::Worker(Search &search, unsigned id) : m_Search(search), m_Id(id), m_Outgoing(search.threads) {}
+
+void Worker::Relax(const Message &message) {
+    const float f = message.g + m_Search.Heuristic(message.node);
+    if (f >= m_Search.incumbent.load(std::memory_order_relaxed))
+        return;
+    auto [it, inserted] = records.try_emplace(message.node, Record{message.g, message.parent});
+    if (!inserted) {
+        if (message.g >= it->second.g)
+            return;
+        it->second = Record{message.g, message.parent};
+    }
+    m_Open.push_back(OpenEntry{f, message.g, message.node});
+    std::push_heap(m_Open.begin(), m_Open.end());
+}
+
+bool Worker::ExpandOne() {
+    while (!m_Open.empty()) {
+        std::pop_heap(m_Open.begin(), m_Open.end());
+        const OpenEntry entry = m_Open.back();
+        m_Open.pop_back();
+        if (records[entry.node].g != entry.g)
+            continue;  // Superseded by a cheaper message.
+        if (entry.f >= m_Search.incumbent.load(std::memory_order_relaxed)) {
+            m_Open.clear();  // Every remaining entry is at least as expensive.
+            return false;
+        }
+        // Going on past an exit never reaches the goal cheaper: exit costs
+        // are straight-line distances.
+        if (const Exit *exit = m_Search.ExitAt(entry.node)) {
+            m_Search.OfferSolution(entry.g + exit->cost);
+            return true;
+        }
+
+        const int *targets = m_Search.graph.Targets(entry.node);
+        const float *lengths = m_Search.graph.Lengths(entry.node);
+        for (int e = 0; e < m_Search.graph.Degree(entry.node); ++e) {
+            const Message message{targets[e], entry.node, entry.g + lengths[e]};
+            const unsigned owner = m_Search.Owner(message.node);
+            if (owner == m_Id)
+                Relax(message);
+            else
+                m_Outgoing[owner].push_back(message);
+        }
+        return true;
+    }
+    return false;
+}
+
+void Worker::Flush() {
+    for (unsigned owner = 0; owner < m_Outgoing.size(); ++owner) {
+        if (m_Outgoing[owner].empty())
+            continue;
+        auto *batch = new Batch;
+        batch->messages.swap(m_Outgoing[owner]);
+        m_Search.work.fetch_add((long)batch->messages.size());
+        m_Search.workers[owner]->mailbox.Push(batch);
+        m_Search.workers[owner]->Wake();
+    }
+}
+
+void Worker::Wake() {
+    if (!m_Parked.load())
+        return;
+    // Taking the mutex orders the notification after the parked worker's last
+    // check of its wait condition.
+    std::lock_guard<std::mutex> lock(m_ParkMutex);
+    m_ParkCondition.notify_one();
+}
+
+void Worker::Park() {
+    m_Parked.store(true);
+    std::unique_lock<std::mutex> lock(m_ParkMutex);
+    m_ParkCondition.wait(lock, [this] { return !mailbox.Empty() || m_Search.work.load() == 0; });
+    m_Parked.store(false);
+}
+
+void Worker::Run() {
+    bool idle = false;
+    int since_flush = 0;
+    int idle_spins = 0;
+    while (true) {
+        if (Batch *batch = mailbox.TakeAll()) {
+            if (idle) {
+                m_Search.work.fetch_add(1);
+                idle = false;
+            }
+            long absorbed = 0;
+            while (batch != nullptr) {
+                for (const auto &message : batch->messages)
+                    Relax(message);
+                absorbed += (long)batch->messages.size();
+                Batch *next = batch->next;
+                delete batch;
+                batch = next;
+            }
+            m_Search.work.fetch_sub(absorbed);
+        }
+
+        if (!idle) {
+            if (ExpandOne()) {
+                if (++since_flush >= kFlushInterval) {
+                    Flush();
+                    since_flush = 0;
+                }
+                continue;
+            }
+            Flush();
+            since_flush = 0;
+            idle = true;
+            idle_spins = 0;
+            if (m_Search.work.fetch_sub(1) == 1) {
+                m_Search.Finish();
+                return;
+            }
+        }
+        if (m_Search.work.load() == 0)
+            return;
+        if (++idle_spins < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            Park();
+            idle_spins = 0;
+        }
+    }
+}
+
+// Searches from `seeds`, messages without a parent, to the goal at
+// (goal_x, goal_y). `direct` is the cost of a route that touches no node, or
+// infinity.
+GraphPath Solve(const RoadGraph &graph, const std::vector<Message> &seeds, float goal_x, float goal_y,
+                std::vector<Exit> exits, float direct, unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    Search search{graph, goal_x, goal_y, std::move(exits), threads};
+    search.incumbent.store(direct);
+    for (const Message &seed : seeds)
+        search.workers[search.Owner(seed.node)]->Relax(seed);
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(&Worker::Run, search.workers[i].get());
+    search.workers[0]->Run();
+    for (auto &thread : pool)
+        thread.join();
+
+    // A record that improved after its exit was taken was pruned unless it
+    // also improved the solution, so the final records give the best exit.
+    float cost = direct;
+    int last = -1;
+    for (const Exit &exit : search.exits) {
+        const auto &records = search.workers[search.Owner(exit.node)]->records;
+        auto it = records.find(exit.node);
+        if (it != records.end() && it->second.g + exit.cost < cost) {
+            cost = it->second.g + exit.cost;
+            last = exit.node;
+        }
+    }
+    GraphPath result;
+    if (cost == std::numeric_limits<float>::infinity())
+        return result;
+
+    result.found = true;
+    result.distance = cost;
+    // Costs only decrease along parent links, so this walk always ends at a seed.
+    for (int node = last; node != -1; node = search.workers[search.Owner(node)]->records.at(node).parent)
+        result.nodes.push_back(node);
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    return result;
+}
+
+// Straight-line distance from a snapped point to `node`, an end of its segment.
+float Partial(const RoadGraph &graph, const SegmentSnap &snap, int node)
+{
+    return std::hypot(graph.X(node) - snap.x, graph.Y(node) - snap.y);
+}
+
+}  // namespace
+
+GraphPath ParallelAStarShortestPath(const RoadGraph &graph, GraphNodeRef start, GraphNodeRef goal, unsigned threads)
+{
+    return Solve(graph, {Message{start.node, -1, 0.0f}}, graph.X(goal), graph.Y(goal), {Exit{goal.node, 0.0f}},
+                 std::numeric_limits<float>::infinity(), threads);
+}
+
+GraphPath ParallelSnappedShortestPath(const RoadGraph &graph, const SegmentSnap &start, const SegmentSnap &goal,
+                                      unsigned threads)
+{
+    const std::vector<Message> seeds{Message{start.from, -1, Partial(graph, start, start.from)},
+                                     Message{start.to, -1, Partial(graph, start, start.to)}};
+    std::vector<Exit> exits{Exit{goal.from, Partial(graph, goal, goal.from)},
+                            Exit{goal.to, Partial(graph, goal, goal.to)}};
+    float direct = std::numeric_limits<float>::infinity();
+    if (std::minmax(start.from, start.to) == std::minmax(goal.from, goal.to))
+        direct = std::hypot(start.x - goal.x, start.y - goal.y);
+    return Solve(graph, seeds, goal.x, goal.y, std::move(exits), direct, threads);
+}
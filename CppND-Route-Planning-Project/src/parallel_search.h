@@ -0,0 +1,26 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include "graph_search.h"
+#include "road_graph.h"
+#include "segment_index.h"
+
+// Hash-distributed A* (HDA*). Every node is owned by the worker selected by a
+// hash of its id; a worker keeps the open list and best-known costs of its own
+// nodes only. Expanding a node sends (target, g, parent) to the target's owner
+// through a lock-free mailbox. Workers keep expanding until no node with an
+// f-value below the best goal cost found so far remains anywhere, so the
+// result has the same optimal distance as AStarShortestPath.
+//
+// `threads` == 0 uses std::thread::hardware_concurrency().
+GraphPath ParallelAStarShortestPath(const RoadGraph &graph, GraphNodeRef start, GraphNodeRef goal,
+                                    unsigned threads = 0);
+
+// The same search between two points snapped onto road segments, with the
+// result of SnappedShortestPath: the search starts from both ends of the start
+// segment at their partial lengths and finishes through either end of the goal
+// segment, and `nodes` holds only real graph nodes.
+GraphPath ParallelSnappedShortestPath(const RoadGraph &graph, const SegmentSnap &start, const SegmentSnap &goal,
+                                      unsigned threads = 0);
+
+#endif
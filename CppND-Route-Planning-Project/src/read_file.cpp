@@ -0,0 +1,19 @@
+#include "read_file.h"
+#include <fstream>
+
+std::optional<std::vector<std::byte>> ReadFile(const std::string &path)
+{
+    std::ifstream is{path, std::ios::binary | std::ios::ate};
+    if (!is)
+        return std::nullopt;
+
+    auto size = is.tellg();
+    std::vector<std::byte> contents(size);
+
+    is.seekg(0);
+    is.read((char *)contents.data(), size);
+
+    if (contents.empty())
+        return std::nullopt;
+    return contents;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Reads a whole file into memory. Returns std::nullopt if the file cannot be
+// opened or is empty.
+std::optional<std::vector<std::byte>> ReadFile(const std::string &path);
@@ -6,8 +6,9 @@ static io2d::rgba_color RoadColor(Model::Road::Type type);
 static io2d::dashes RoadDashes(Model::Road::Type type);
 static io2d::point_2d ToPoint2D( const Model::Node &node ) noexcept; 
 
-Render::Render( RouteModel &model ):
-    m_Model(model)
+Render::Render( RouteModel &model, const FeatureGrid *grid ):
+    m_Model(model),
+    m_Grid(grid)
 {
     BuildRoadReps();
     BuildLanduseBrushes();
@@ -19,7 +20,37 @@ void Render::Display( io2d::output_surface &surface )
     m_PixelsInMeter = static_cast<float>(m_Scale / m_Model.MetricScale()); 
     m_Matrix = io2d::matrix_2d::create_scale({m_Scale, -m_Scale}) *
                io2d::matrix_2d::create_translate({0.f, static_cast<float>(surface.dimensions().y())});
-    
+    m_Selection = nullptr;
+    DrawAll(surface);
+}
+
+void Render::RenderTile( io2d::image_surface &surface, int z, int x, int y )
+{
+    const float tile_size = static_cast<float>(surface.dimensions().x());
+    const float extent = m_Grid ? m_Grid->Extent() : 1.f;
+    const float world_pixels = tile_size * static_cast<float>(1 << z);
+    m_Scale = world_pixels / extent;
+    m_PixelsInMeter = static_cast<float>(m_Scale / m_Model.MetricScale());
+    m_Matrix = io2d::matrix_2d::create_scale({m_Scale, -m_Scale}) *
+               io2d::matrix_2d::create_translate({-tile_size * x, world_pixels - tile_size * y});
+
+    m_Selection = nullptr;
+    if( m_Grid ) {
+        // Widen the tile by the widest stroke so roads just outside still show their edges.
+        const float margin = (RoadMetricWidth(Model::Road::Motorway) * m_PixelsInMeter + 2.f) / m_Scale;
+        const float tile_units = extent / static_cast<float>(1 << z);
+        const float min_x = tile_units * x;
+        const float max_y = extent - tile_units * y;
+        m_Grid->Query({min_x - margin, max_y - tile_units - margin, min_x + tile_units + margin, max_y + margin}, m_TileSelection);
+        m_Selection = &m_TileSelection;
+    }
+    DrawAll(surface);
+    m_Selection = nullptr;
+}
+
+template <typename Surface>
+void Render::DrawAll( Surface &surface ) const
+{
     surface.paint(m_BackgroundFillBrush);        
     DrawLanduses(surface);
     DrawLeisure(surface);
@@ -32,7 +63,20 @@ void Render::Display( io2d::output_surface &surface )
     DrawEndPosition(surface);
 }
 
-void Render::DrawPath(io2d::output_surface &surface) const{
+template <typename Items, typename Fn>
+void Render::ForEachVisible( FeatureGrid::Layer layer, const Items &items, Fn fn ) const
+{
+    if( !m_Selection ) {
+        for( auto &item: items )
+            fn(item);
+        return;
+    }
+    for( auto index: m_Selection->items[layer] )
+        fn(items[index]);
+}
+
+template <typename Surface>
+void Render::DrawPath(Surface &surface) const{
     io2d::render_props aliased{ io2d::antialias::none };
     io2d::brush foreBrush{ io2d::rgba_color::orange}; 
     float width = 5.0f;
@@ -40,7 +84,8 @@ void Render::DrawPath(io2d::output_surface &surface) const{
 
 }
 
-void Render::DrawEndPosition(io2d::output_surface &surface) const{
+template <typename Surface>
+void Render::DrawEndPosition(Surface &surface) const{
     if (m_Model.path.empty()) return;
     io2d::render_props aliased{ io2d::antialias::none };
     io2d::brush foreBrush{ io2d::rgba_color::red };
@@ -60,7 +105,8 @@ void Render::DrawEndPosition(io2d::output_surface &surface) const{
     surface.stroke(foreBrush, io2d::interpreted_path{pb}, std::nullopt, std::nullopt, std::nullopt, aliased);
 }
 
-void Render::DrawStartPosition(io2d::output_surface &surface) const{
+template <typename Surface>
+void Render::DrawStartPosition(Surface &surface) const{
     if (m_Model.path.empty()) return;
 
     io2d::render_props aliased{ io2d::antialias::none };
@@ -81,41 +127,48 @@ void Render::DrawStartPosition(io2d::output_surface &surface) const{
     surface.stroke(foreBrush, io2d::interpreted_path{pb}, std::nullopt, std::nullopt, std::nullopt, aliased);
 }
 
-void Render::DrawBuildings(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawBuildings(Surface &surface) const
 {
-    for( auto &building: m_Model.Buildings() ) {
+    ForEachVisible(FeatureGrid::Buildings, m_Model.Buildings(), [&](auto &building) {
         auto path = PathFromMP(building);
         surface.fill(m_BuildingFillBrush, path);        
         surface.stroke(m_BuildingOutlineBrush, path, std::nullopt, m_BuildingOutlineStrokeProps);
-    }
+    });
 }
 
-void Render::DrawLeisure(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawLeisure(Surface &surface) const
 {
-    for( auto &leisure: m_Model.Leisures()) {
+    ForEachVisible(FeatureGrid::Leisures, m_Model.Leisures(), [&](auto &leisure) {
         auto path = PathFromMP(leisure);
         surface.fill(m_LeisureFillBrush, path);        
         surface.stroke(m_LeisureOutlineBrush, path, std::nullopt, m_LeisureOutlineStrokeProps);
-    }
+    });
 }
 
-void Render::DrawWater(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawWater(Surface &surface) const
 {
-    for( auto &water: m_Model.Waters())
+    ForEachVisible(FeatureGrid::Waters, m_Model.Waters(), [&](auto &water) {
         surface.fill(m_WaterFillBrush, PathFromMP(water));
+    });
 }
 
-void Render::DrawLanduses(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawLanduses(Surface &surface) const
 {
-    for( auto &landuse: m_Model.Landuses() )
+    ForEachVisible(FeatureGrid::Landuses, m_Model.Landuses(), [&](auto &landuse) {
         if( auto br = m_LanduseBrushes.find(landuse.type); br != m_LanduseBrushes.end() )        
             surface.fill(br->second, PathFromMP(landuse));
+    });
 }
 
-void Render::DrawHighways(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawHighways(Surface &surface) const
 {
     auto ways = m_Model.Ways().data();
-    for( auto road: m_Model.Roads() )
+    ForEachVisible(FeatureGrid::Roads, m_Model.Roads(), [&](auto &road) {
         if( auto rep_it = m_RoadReps.find(road.type); rep_it != m_RoadReps.end() ) {
             auto &rep = rep_it->second;   
             auto &way = ways[road.way];
@@ -123,17 +176,19 @@ void Render::DrawHighways(io2d::output_surface &surface) const
             auto sp = io2d::stroke_props{width, io2d::line_cap::round};
             surface.stroke(rep.brush, PathFromWay(way), std::nullopt, sp, rep.dashes);        
         }
+    });
 }
 
-void Render::DrawRailways(io2d::output_surface &surface) const
+template <typename Surface>
+void Render::DrawRailways(Surface &surface) const
 {     
     auto ways = m_Model.Ways().data();
-    for( auto &railway: m_Model.Railways() ) {
+    ForEachVisible(FeatureGrid::Railways, m_Model.Railways(), [&](auto &railway) {
         auto &way = ways[railway.way];
         auto path = PathFromWay(way);
         surface.stroke(m_RailwayStrokeBrush, path, std::nullopt, io2d::stroke_props{m_RailwayOuterWidth * m_PixelsInMeter});
         surface.stroke(m_RailwayDashBrush, path, std::nullopt, io2d::stroke_props{m_RailwayInnerWidth * m_PixelsInMeter}, m_RailwayDashes);
-    }
+    });
 }
 
 io2d::interpreted_path Render::PathLine() const
@@ -3,34 +3,47 @@
 #include <unordered_map>
 #include <io2d.h>
 #include "route_model.h"
+#include "feature_grid.h"
 
 using namespace std::experimental;
 
 class Render
 {
 public:
-    Render(RouteModel &model );
+    // `grid` is only used by RenderTile, to skip features outside the tile.
+    Render(RouteModel &model, const FeatureGrid *grid = nullptr );
     void Display( io2d::output_surface &surface );
+
+    // Draws tile x/y of zoom level z into `surface`. Level 0 is a single tile
+    // covering the square [0, Extent] of the map; each level splits every tile
+    // into four. Rows are numbered from the top, as in slippy map tiles.
+    void RenderTile( io2d::image_surface &surface, int z, int x, int y );
     
 private:
     void BuildRoadReps();
     void BuildLanduseBrushes();
-    
-    void DrawBuildings(io2d::output_surface &surface) const;
-    void DrawHighways(io2d::output_surface &surface) const;
-    void DrawRailways(io2d::output_surface &surface) const;
-    void DrawLeisure(io2d::output_surface &surface) const;
-    void DrawWater(io2d::output_surface &surface) const;
-    void DrawLanduses(io2d::output_surface &surface) const;
-    void DrawStartPosition(io2d::output_surface &surface) const;
-    void DrawEndPosition(io2d::output_surface &surface) const;
-    void DrawPath(io2d::output_surface &surface) const;
+
+    template <typename Surface> void DrawAll(Surface &surface) const;
+    template <typename Surface> void DrawBuildings(Surface &surface) const;
+    template <typename Surface> void DrawHighways(Surface &surface) const;
+    template <typename Surface> void DrawRailways(Surface &surface) const;
+    template <typename Surface> void DrawLeisure(Surface &surface) const;
+    template <typename Surface> void DrawWater(Surface &surface) const;
+    template <typename Surface> void DrawLanduses(Surface &surface) const;
+    template <typename Surface> void DrawStartPosition(Surface &surface) const;
+    template <typename Surface> void DrawEndPosition(Surface &surface) const;
+    template <typename Surface> void DrawPath(Surface &surface) const;
+    template <typename Items, typename Fn> void ForEachVisible(FeatureGrid::Layer layer, const Items &items, Fn fn) const;
     io2d::interpreted_path PathFromWay(const Model::Way &way) const;
     io2d::interpreted_path PathFromMP(const Model::Multipolygon &mp) const;
     io2d::interpreted_path PathLine() const;
 
     
     RouteModel &m_Model;
+    const FeatureGrid *m_Grid = nullptr;
+    // Features of the tile being rendered; null draws everything.
+    const FeatureGrid::Selection *m_Selection = nullptr;
+    FeatureGrid::Selection m_TileSelection;
     float m_Scale = 1.f;
     float m_PixelsInMeter = 1.f;
     io2d::matrix_2d m_Matrix;
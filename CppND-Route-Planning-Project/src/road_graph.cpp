@@ -0,0 +1,45 @@
+#include "road_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+RoadGraph::RoadGraph(const Model &model) : m_MetricScale(model.MetricScale())
+{
+    const auto &nodes = model.Nodes();
+    m_Xs.reserve(nodes.size());
+    m_Ys.reserve(nodes.size());
+    for (const auto &node : nodes) {
+        m_Xs.push_back((float)node.x);
+        m_Ys.push_back((float)node.y);
+    }
+
+    std::vector<std::pair<int, int>> arcs;
+    for (const auto &road : model.Roads()) {
+        if (road.type == Model::Road::Type::Footway)
+            continue;
+        const auto &way = model.Ways()[road.way].nodes;
+        for (std::size_t i = 1; i < way.size(); ++i) {
+            if (way[i - 1] == way[i])
+                continue;
+            arcs.emplace_back(way[i - 1], way[i]);
+            arcs.emplace_back(way[i], way[i - 1]);
+        }
+    }
+    std::sort(arcs.begin(), arcs.end());
+    arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+    m_Offsets.assign(nodes.size() + 1, 0);
+    for (const auto &arc : arcs)
+        m_Offsets[arc.first + 1]++;
+    for (std::size_t i = 1; i < m_Offsets.size(); ++i)
+        m_Offsets[i] += m_Offsets[i - 1];
+
+    m_Targets.reserve(arcs.size());
+    m_Lengths.reserve(arcs.size());
+    for (const auto &[from, to] : arcs) {
+        const double dx = nodes[from].x - nodes[to].x;
+        const double dy = nodes[from].y - nodes[to].y;
+        m_Targets.push_back(to);
+        m_Lengths.push_back((float)std::sqrt(dx * dx + dy * dy));
+    }
+}
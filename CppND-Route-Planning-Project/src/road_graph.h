@@ -0,0 +1,50 @@
+#ifndef ROAD_GRAPH_H
+#define ROAD_GRAPH_H
+
+#include <cstddef>
+#include <vector>
+#include "model.h"
+#include "graph_search.h"
+
+// Static, undirected road network of a Model in compressed sparse row form.
+// Nodes keep their Model::Nodes() indices; consecutive nodes of every
+// non-footway road way are connected by an edge with their straight-line
+// length in normalized map units. Unlike RouteModel::Node::FindNeighbors the
+// edges do not depend on search state, so the graph can be partitioned,
+// serialized and searched by several threads at once.
+class RoadGraph
+{
+public:
+    explicit RoadGraph(const Model &model);
+
+    int NodeCount() const noexcept { return (int)m_Xs.size(); }
+    std::size_t EdgeCount() const noexcept { return m_Targets.size(); }
+    int Degree(int node) const noexcept { return m_Offsets[node + 1] - m_Offsets[node]; }
+    double MetricScale() const noexcept { return m_MetricScale; }
+
+    float X(int node) const noexcept { return m_Xs[node]; }
+    float Y(int node) const noexcept { return m_Ys[node]; }
+    float X(GraphNodeRef ref) const noexcept { return m_Xs[ref.node]; }
+    float Y(GraphNodeRef ref) const noexcept { return m_Ys[ref.node]; }
+
+    template <typename Visitor>
+    void ForEachEdge(GraphNodeRef ref, Visitor &&visit) const {
+        for (int e = m_Offsets[ref.node]; e < m_Offsets[ref.node + 1]; ++e) {
+            const int target = m_Targets[e];
+            visit(GraphEdge{target, 0, m_Lengths[e], m_Xs[target], m_Ys[target]});
+        }
+    }
+
+    const int *Targets(int node) const noexcept { return m_Targets.data() + m_Offsets[node]; }
+    const float *Lengths(int node) const noexcept { return m_Lengths.data() + m_Offsets[node]; }
+
+private:
+    std::vector<float> m_Xs;
+    std::vector<float> m_Ys;
+    std::vector<int> m_Offsets;
+    std::vector<int> m_Targets;
+    std::vector<float> m_Lengths;
+    double m_MetricScale;
+};
+
+#endif
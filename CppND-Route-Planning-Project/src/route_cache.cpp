@@ -0,0 +1,98 @@
+#include "route_cache.h"
+#include <functional>
+
+RouteCache::RouteCache(std::size_t capacity) : capacity(capacity) {
+    index.reserve(capacity);
+}
+
+
+void RouteCache::SyncGeneration(const RouteModel &model) {
+    if (model.Generation() != generation) {
+        lru.clear();
+        index.clear();
+        generation = model.Generation();
+    }
+}
+
+
+std::size_t RouteCache::KeyHash::operator()(const Key &key) const {
+    std::size_t hash = std::hash<float>{}(key.start_t) ^ (std::hash<float>{}(key.end_t) << 1);
+    for (int node : {key.start_from, key.start_to, key.end_from, key.end_to}) {
+        hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(node);
+    }
+    return hash;
+}
+
+
+std::optional<RouteCache::Route> RouteCache::Lookup(const RouteModel &model, int start, int end) {
+    return Lookup(model, MakeKey(start, end));
+}
+
+
+void RouteCache::Insert(const RouteModel &model, int start, int end, Route route) {
+    Insert(model, MakeKey(start, end), std::move(route));
+}
+
+
+std::optional<RouteCache::Route> RouteCache::Lookup(const RouteModel &model, const SegmentSnap &start,
+                                                    const SegmentSnap &end) {
+    return Lookup(model, MakeKey(start, end));
+}
+
+
+void RouteCache::Insert(const RouteModel &model, const SegmentSnap &start, const SegmentSnap &end, Route route) {
+    Insert(model, MakeKey(start, end), std::move(route));
+}
+
+
+std::optional<RouteCache::Route> RouteCache::Lookup(const RouteModel &model, const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    SyncGeneration(model);
+
+    auto it = index.find(key);
+    if (it == index.end()) {
+        stats.misses++;
+        return std::nullopt;
+    }
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    return it->second->route;
+}
+
+
+void RouteCache::Insert(const RouteModel &model, const Key &key, Route route) {
+    if (capacity == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    SyncGeneration(model);
+
+    if (auto it = index.find(key); it != index.end()) {
+        it->second->route = std::move(route);
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+
+    if (lru.size() >= capacity) {
+        index.erase(lru.back().key);
+        lru.pop_back();
+        stats.evictions++;
+    }
+    lru.push_front(Entry{key, std::move(route)});
+    index[key] = lru.begin();
+}
+
+
+void RouteCache::Invalidate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+}
+
+
+RouteCache::Stats RouteCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    result.size = lru.size();
+    return result;
+}
@@ -0,0 +1,82 @@
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "route_model.h"
+
+// Bounded, thread-safe LRU cache of A* results keyed by the (start, end) node
+// indices returned by RouteModel::FindClosestNode, or by the road projections
+// returned by RouteModel::SnapToRoad. A snapped route is only reused for the
+// same two projections. Paths are stored as node indices so an entry costs 4
+// bytes per hop instead of a full Node copy.
+class RouteCache
+{
+public:
+  struct Route {
+    std::vector<int> path;
+    float distance = 0.0f;
+  };
+
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t size = 0;
+  };
+
+  explicit RouteCache(std::size_t capacity);
+
+  // Both calls drop every entry first if `model` is not the model the cache
+  // was last used with (i.e. the map has been reloaded).
+  std::optional<Route> Lookup(const RouteModel &model, int start, int end);
+  void Insert(const RouteModel &model, int start, int end, Route route);
+  std::optional<Route> Lookup(const RouteModel &model, const SegmentSnap &start, const SegmentSnap &end);
+  void Insert(const RouteModel &model, const SegmentSnap &start, const SegmentSnap &end, Route route);
+
+  void Invalidate();
+  Stats GetStats() const;
+  std::size_t Capacity() const { return capacity; }
+
+private:
+  // Each end is a position `t` along the segment from `from` to `to`. A node
+  // is keyed as a snap onto itself, (node, node, 0), which no segment matches.
+  struct Key {
+    int start_from, start_to, end_from, end_to;
+    float start_t, end_t;
+    bool operator==(const Key &other) const {
+      return start_from == other.start_from && start_to == other.start_to && end_from == other.end_from &&
+             end_to == other.end_to && start_t == other.start_t && end_t == other.end_t;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const;
+  };
+  struct Entry {
+    Key key;
+    Route route;
+  };
+
+  static Key MakeKey(int start, int end) { return Key{start, start, end, end, 0.0f, 0.0f}; }
+  static Key MakeKey(const SegmentSnap &start, const SegmentSnap &end) {
+    return Key{start.from, start.to, end.from, end.to, start.t, end.t};
+  }
+  std::optional<Route> Lookup(const RouteModel &model, const Key &key);
+  void Insert(const RouteModel &model, const Key &key, Route route);
+  void SyncGeneration(const RouteModel &model);
+
+  mutable std::mutex mutex;
+  std::size_t capacity;
+  std::uint64_t generation = 0;
+  // Most recently used entry is at the front.
+  std::list<Entry> lru;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  Stats stats;
+};
+
+#endif
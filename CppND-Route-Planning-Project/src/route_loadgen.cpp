@@ -0,0 +1,156 @@
+// Load generator for the routing daemon (OSM_A_star_search -s <socket>).
+// Opens several connections, replays a fixed set of random route queries for a
+// given duration and reports sustained throughput and latency percentiles.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static int Connect(const std::string &path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends one request line and reads one response line into `response`.
+static bool Exchange(int fd, const std::string &request, std::string &response)
+{
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size())
+        return false;
+    response.clear();
+    char chunk[4096];
+    while (response.empty() || response.back() != '\n')
+    {
+        auto received = read(fd, chunk, sizeof(chunk));
+        if (received <= 0)
+            return false;
+        response.append(chunk, received);
+    }
+    return true;
+}
+
+int main(int argc, const char **argv)
+{
+    std::string socket_path = "/tmp/osm_route.sock";
+    int connections = 4;
+    int seconds = 10;
+    int pairs = 64;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "-s" && ++i < argc)
+            socket_path = argv[i];
+        else if (arg == "-c" && ++i < argc)
+            connections = std::max(1, std::stoi(argv[i]));
+        else if (arg == "-d" && ++i < argc)
+            seconds = std::max(1, std::stoi(argv[i]));
+        else if (arg == "-p" && ++i < argc)
+            pairs = std::max(1, std::stoi(argv[i]));
+        else
+        {
+            std::cout << "Usage: route_loadgen [-s socket] [-c connections] [-d seconds] [-p distinct_pairs]" << std::endl;
+            return 1;
+        }
+    }
+
+    // A small pool of distinct queries mimics depot-to-hub traffic.
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> coordinate{0.f, 100.f};
+    std::vector<std::string> requests;
+    for (int i = 0; i < pairs; ++i)
+    {
+        char line[128];
+        std::snprintf(line, sizeof(line), "ROUTE %.2f %.2f %.2f %.2f\n",
+                      coordinate(rng), coordinate(rng), coordinate(rng), coordinate(rng));
+        requests.emplace_back(line);
+    }
+
+    std::vector<std::vector<std::int64_t>> latencies(connections);
+    std::atomic<long> errors{0};
+    const auto deadline = Clock::now() + std::chrono::seconds(seconds);
+    const auto begin = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < connections; ++c)
+    {
+        threads.emplace_back([&, c] {
+            int fd = Connect(socket_path);
+            if (fd < 0)
+            {
+                errors++;
+                return;
+            }
+            std::mt19937 local_rng(c);
+            std::uniform_int_distribution<std::size_t> pick{0, requests.size() - 1};
+            std::string response;
+            auto &samples = latencies[c];
+            while (Clock::now() < deadline)
+            {
+                const auto sent = Clock::now();
+                if (!Exchange(fd, requests[pick(local_rng)], response))
+                {
+                    errors++;
+                    break;
+                }
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sent).count());
+                if (response.compare(0, 3, "ERR") == 0)
+                    errors++;
+            }
+            close(fd);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<std::int64_t> all;
+    for (const auto &samples : latencies)
+        all.insert(all.end(), samples.begin(), samples.end());
+    if (all.empty())
+    {
+        std::cout << "No requests completed (" << errors << " errors). Is the server running on " << socket_path << "?" << std::endl;
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) {
+        auto rank = static_cast<std::size_t>(p * (all.size() - 1));
+        return all[rank] / 1000.0;
+    };
+
+    std::printf("requests: %zu in %.2f s over %d connections, errors: %ld\n", all.size(), elapsed, connections, errors.load());
+    std::printf("throughput: %.0f req/s\n", all.size() / elapsed);
+    std::printf("latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                percentile(0.50), percentile(0.90), percentile(0.99), percentile(0.999), all.back() / 1000.0);
+
+    if (int fd = Connect(socket_path); fd >= 0)
+    {
+        std::string response;
+        if (Exchange(fd, "STATS\n", response))
+            std::cout << "server cache (hits misses evictions size): " << response.substr(3);
+        close(fd);
+    }
+    return 0;
+}
@@ -1,7 +1,13 @@
 #include "route_model.h"
+#include "distance_kernels.h"
+#include <atomic>
+#include <stdexcept>
 #include <iostream>
 
-RouteModel::RouteModel(const std::vector<std::byte> &xml) : Model(xml) {
+static std::atomic<std::uint64_t> g_NextGeneration{1};
+
+RouteModel::RouteModel(const std::vector<std::byte> &xml)
+    : Model(xml), m_Generation(g_NextGeneration++), m_Graph(*this), m_Segments(m_Graph) {
     // Create RouteModel nodes.
     int counter = 0;
     for (Model::Node node : this->Nodes()) {
@@ -9,6 +15,22 @@ RouteModel::RouteModel(const std::vector<std::byte> &xml) : Model(xml) {
         counter++;
     }
     CreateNodeToRoadHashmap();
+    CreateCoordinateBuffers();
+}
+
+
+void RouteModel::ResetSearchState() {
+    for (Node &node : m_Nodes) {
+        if (!node.visited && node.parent == nullptr && node.neighbors.empty()) {
+            continue;
+        }
+        node.parent = nullptr;
+        node.h_value = std::numeric_limits<float>::max();
+        node.g_value = 0.0;
+        node.visited = false;
+        node.neighbors.clear();
+    }
+    path.clear();
 }
 
 
@@ -26,15 +48,23 @@ void RouteModel::CreateNodeToRoadHashmap() {
 }
 
 
-RouteModel::Node *RouteModel::Node::FindNeighbor(std::vector<int> node_indices) {
-    Node *closest_node = nullptr;
-    Node node;
+RouteModel::Node *RouteModel::Node::FindNeighbor(const std::vector<int> &node_indices) {
+    thread_local std::vector<float> distances;
+    distances.resize(node_indices.size());
+    DistanceKernels::SquaredDistancesGather(parent_model->m_NodeXs.data(), parent_model->m_NodeYs.data(),
+                                            node_indices.data(), node_indices.size(),
+                                            (float)x, (float)y, distances.data());
 
-    for (int node_index : node_indices) {
-        node = parent_model->SNodes()[node_index];
-        if (this->distance(node) != 0 && !node.visited) {
-            if (closest_node == nullptr || this->distance(node) < this->distance(*closest_node)) {
-                closest_node = &parent_model->SNodes()[node_index];
+    // The node itself is skipped by index: a float distance of 0 would also
+    // skip distinct nodes closer than float resolution.
+    Node *closest_node = nullptr;
+    float min_dist = std::numeric_limits<float>::max();
+    for (std::size_t i = 0; i < node_indices.size(); i++) {
+        if (node_indices[i] != index && distances[i] < min_dist) {
+            Node &node = parent_model->SNodes()[node_indices[i]];
+            if (!node.visited) {
+                closest_node = &node;
+                min_dist = distances[i];
             }
         }
     }
@@ -52,26 +82,41 @@ void RouteModel::Node::FindNeighbors() {
 }
 
 
-RouteModel::Node &RouteModel::FindClosestNode(float x, float y) {
-    Node input;
-    input.x = x;
-    input.y = y;
-
-    float min_dist = std::numeric_limits<float>::max();
-    float dist;
-    int closest_idx;
+void RouteModel::CreateCoordinateBuffers() {
+    m_NodeXs.reserve(m_Nodes.size());
+    m_NodeYs.reserve(m_Nodes.size());
+    for (const Node &node : m_Nodes) {
+        m_NodeXs.push_back((float)node.x);
+        m_NodeYs.push_back((float)node.y);
+    }
 
+    // Keep the order in which FindClosestNode used to visit road nodes so ties
+    // resolve the same way, but store every node only once.
+    std::vector<bool> seen(m_Nodes.size(), false);
     for (const Model::Road &road : Roads()) {
         if (road.type != Model::Road::Type::Footway) {
             for (int node_idx : Ways()[road.way].nodes) {
-                dist = input.distance(SNodes()[node_idx]);
-                if (dist < min_dist) {
-                    closest_idx = node_idx;
-                    min_dist = dist;
+                if (!seen[node_idx]) {
+                    seen[node_idx] = true;
+                    m_RoutableIndices.push_back(node_idx);
+                    m_RoutableXs.push_back(m_NodeXs[node_idx]);
+                    m_RoutableYs.push_back(m_NodeYs[node_idx]);
                 }
             }
         }
     }
+}
+
 
-    return SNodes()[closest_idx];
-}
\ No newline at end of file
+RouteModel::Node &RouteModel::FindClosestNode(float x, float y) {
+    if (m_RoutableIndices.empty())
+        throw std::logic_error("map has no roads to route on");
+    const std::size_t closest = DistanceKernels::ArgMinSquaredDistance(
+        m_RoutableXs.data(), m_RoutableYs.data(), m_RoutableXs.size(), x, y);
+    return SNodes()[m_RoutableIndices[closest]];
+}
+
+
+std::optional<SegmentSnap> RouteModel::SnapToRoad(float x, float y) const {
+    return m_Segments.Nearest(x, y);
+}
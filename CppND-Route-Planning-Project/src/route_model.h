@@ -3,8 +3,11 @@
 
 #include <limits>
 #include <cmath>
+#include <cstdint>
 #include <unordered_map>
 #include "model.h"
+#include "road_graph.h"
+#include "segment_index.h"
 #include <iostream>
 
 class RouteModel : public Model {
@@ -19,29 +22,61 @@ class RouteModel : public Model {
         std::vector<Node *> neighbors;
 
         void FindNeighbors();
-        float distance(Node other) const {
-            return std::sqrt(std::pow((x - other.x), 2) + std::pow((y - other.y), 2));
+        float distance(const Node &other) const {
+            const double dx = x - other.x;
+            const double dy = y - other.y;
+            return std::sqrt(dx * dx + dy * dy);
         }
 
+        int Index() const { return index; }
+
         Node(){}
         Node(int idx, RouteModel * search_model, Model::Node node) : Model::Node(node), parent_model(search_model), index(idx) {}
 
       private:
         int index;
-        Node * FindNeighbor(std::vector<int> node_indices);
+        Node * FindNeighbor(const std::vector<int> &node_indices);
         RouteModel * parent_model = nullptr;
     };
 
     RouteModel(const std::vector<std::byte> &xml);
+    // Nearest vertex of a non-footway road. Throws std::logic_error if the map
+    // has none.
     Node &FindClosestNode(float x, float y);
+    // Projection of (x, y) onto the nearest road segment. Unlike
+    // FindClosestNode, a point beside a long road snaps onto that road, midway
+    // along it if need be, rather than onto a vertex of another road that
+    // happens to be nearer. Route endpoints are snapped this way and searched
+    // with SnappedShortestPath over Graph(). Empty if the map has no roads.
+    std::optional<SegmentSnap> SnapToRoad(float x, float y) const;
+    // Static road graph of the model, with node indices as in SNodes().
+    const RoadGraph &Graph() const { return m_Graph; }
+    // Clears per-search node state and the last path so the model can serve another query.
+    void ResetSearchState();
     auto &SNodes() { return m_Nodes; }
+    // Unique per constructed model; caches use it to detect a reloaded map.
+    std::uint64_t Generation() const noexcept { return m_Generation; }
     std::vector<Node> path;
     
   private:
     void CreateNodeToRoadHashmap();
+    void CreateCoordinateBuffers();
+    std::uint64_t m_Generation;
     std::unordered_map<int, std::vector<const Model::Road *>> node_to_road;
     std::vector<Node> m_Nodes;
 
+    // Structure-of-arrays float copies of the node coordinates for the batch
+    // distance kernels: every node by index (for gathers in FindNeighbor), and
+    // the routable (non-footway road) nodes packed contiguously for snapping.
+    std::vector<float> m_NodeXs;
+    std::vector<float> m_NodeYs;
+    std::vector<float> m_RoutableXs;
+    std::vector<float> m_RoutableYs;
+    std::vector<int> m_RoutableIndices;
+
+    RoadGraph m_Graph;
+    SegmentIndex m_Segments;
+
 };
 
 #endif
@@ -1,7 +1,7 @@
 #include "route_planner.h"
 #include <algorithm>
 
-RoutePlanner::RoutePlanner(RouteModel &model, float start_x, float start_y, float end_x, float end_y) : m_Model(model)
+RoutePlanner::RoutePlanner(RouteModel &model, float start_x, float start_y, float end_x, float end_y, RouteCache *cache) : m_Model(model), m_Cache(cache)
 {
     // Convert inputs to percentage:
     start_x *= 0.01;
@@ -15,6 +15,11 @@ RoutePlanner::RoutePlanner(RouteModel &model, float start_x, float start_y, floa
     this->end_node = &(m_Model.FindClosestNode(end_x, end_y));
 }
 
+RoutePlanner::RoutePlanner(RouteModel &model, RouteModel::Node &start, RouteModel::Node &end, RouteCache *cache)
+    : start_node(&start), end_node(&end), m_Model(model), m_Cache(cache)
+{
+}
+
 // TODO 3: Implement the CalculateHValue method.
 // Tips:
 // - You can use the distance to the end_node for the h value.
@@ -109,6 +114,19 @@ void RoutePlanner::AStarSearch()
 {
     RouteModel::Node *current_node = nullptr;
 
+    if (m_Cache)
+    {
+        if (auto route = m_Cache->Lookup(m_Model, start_node->Index(), end_node->Index()))
+        {
+            m_Model.path.clear();
+            m_Model.path.reserve(route->path.size());
+            for (int index : route->path)
+                m_Model.path.push_back(m_Model.SNodes()[index]);
+            distance = route->distance;
+            return;
+        }
+    }
+
     open_list.push_back(this->start_node);
     this->start_node->visited = true;
 
@@ -120,6 +138,15 @@ void RoutePlanner::AStarSearch()
         if (current_node == this->end_node)
         {
             m_Model.path = ConstructFinalPath(current_node);
+            if (m_Cache)
+            {
+                RouteCache::Route route;
+                route.distance = distance;
+                route.path.reserve(m_Model.path.size());
+                for (const auto &node : m_Model.path)
+                    route.path.push_back(node.Index());
+                m_Cache->Insert(m_Model, start_node->Index(), end_node->Index(), std::move(route));
+            }
             break;
         }
 
@@ -5,11 +5,16 @@
 #include <vector>
 #include <string>
 #include "route_model.h"
+#include "route_cache.h"
 
 class RoutePlanner
 {
 public:
-  RoutePlanner(RouteModel &model, float start_x, float start_y, float end_x, float end_y);
+  // When `cache` is given, AStarSearch answers repeated (start, end) pairs from it
+  // and stores newly found routes in it.
+  RoutePlanner(RouteModel &model, float start_x, float start_y, float end_x, float end_y, RouteCache *cache = nullptr);
+  // Plans between nodes the caller has already snapped with FindClosestNode.
+  RoutePlanner(RouteModel &model, RouteModel::Node &start, RouteModel::Node &end, RouteCache *cache = nullptr);
   // Add public variables or methods declarations here.
   float GetDistance() const { return distance; }
   void AStarSearch();
@@ -28,6 +33,7 @@ private:
 
   float distance = 0.0f;
   RouteModel &m_Model;
+  RouteCache *m_Cache;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "route_server.h"
+#include "parallel_search.h"
+#include "segment_index.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+RouteServer::RouteServer(RouteModel &model, std::string socket_path, std::size_t workers, std::size_t cache_capacity,
+                         unsigned search_threads)
+    : m_Model(model), m_Cache(cache_capacity), m_SocketPath(std::move(socket_path)), m_WorkerCount(workers > 0 ? workers : 1),
+      m_SearchThreads(search_threads)
+{
+    if (pipe(m_WakeFds) != 0)
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+}
+
+RouteServer::~RouteServer()
+{
+    Stop();
+    for (auto &worker : m_Workers)
+        if (worker.joinable())
+            worker.join();
+    close(m_WakeFds[0]);
+    close(m_WakeFds[1]);
+}
+
+void RouteServer::Run()
+{
+    m_ListenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_ListenFd < 0)
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_SocketPath.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path is too long: " + m_SocketPath);
+    std::strncpy(address.sun_path, m_SocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    unlink(m_SocketPath.c_str());
+    if (bind(m_ListenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(m_ListenFd, SOMAXCONN) != 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(m_ListenFd);
+        m_ListenFd = -1;
+        throw std::runtime_error("cannot listen on " + m_SocketPath + ": " + error);
+    }
+
+    for (std::size_t i = 0; i < m_WorkerCount; ++i)
+        m_Workers.emplace_back(&RouteServer::WorkerLoop, this);
+
+    AcceptLoop();
+
+    close(m_ListenFd);
+    m_ListenFd = -1;
+    unlink(m_SocketPath.c_str());
+
+    {
+        // Let in-flight requests complete: shutting down the read side makes the
+        // worker see end-of-stream once it has answered what it already read.
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        for (int fd : m_Active)
+            shutdown(fd, SHUT_RD);
+        for (int fd : m_Pending)
+            close(fd);
+        m_Pending.clear();
+    }
+    m_QueueCondition.notify_all();
+    for (auto &worker : m_Workers)
+        worker.join();
+    m_Workers.clear();
+}
+
+void RouteServer::Stop()
+{
+    if (m_Stopping.exchange(true))
+        return;
+    const char wake = 1;
+    [[maybe_unused]] auto written = write(m_WakeFds[1], &wake, 1);
+    m_QueueCondition.notify_all();
+}
+
+void RouteServer::AcceptLoop()
+{
+    pollfd fds[2] = {{m_ListenFd, POLLIN, 0}, {m_WakeFds[0], POLLIN, 0}};
+    while (!m_Stopping)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break;
+        if (fds[0].revents & POLLIN)
+        {
+            int client = accept(m_ListenFd, nullptr, nullptr);
+            if (client < 0)
+                continue;
+            {
+                std::lock_guard<std::mutex> lock(m_QueueMutex);
+                m_Pending.push_back(client);
+            }
+            m_QueueCondition.notify_one();
+        }
+    }
+}
+
+void RouteServer::WorkerLoop()
+{
+    while (true)
+    {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_QueueCondition.wait(lock, [this] { return m_Stopping || !m_Pending.empty(); });
+            if (m_Stopping)
+                return;
+            fd = m_Pending.front();
+            m_Pending.pop_front();
+            m_Active.insert(fd);
+        }
+        ServeConnection(fd);
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_Active.erase(fd);
+        }
+        close(fd);
+    }
+}
+
+static bool WriteAll(int fd, const std::string &data)
+{
+    std::size_t offset = 0;
+    while (offset < data.size())
+    {
+        auto written = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        offset += written;
+    }
+    return true;
+}
+
+void RouteServer::ServeConnection(int fd)
+{
+    std::string buffer;
+    char chunk[4096];
+    while (true)
+    {
+        auto received = read(fd, chunk, sizeof(chunk));
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return;
+        buffer.append(chunk, received);
+
+        std::string responses;
+        std::size_t begin = 0;
+        for (auto end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', begin))
+        {
+            responses += HandleRequest(buffer.substr(begin, end - begin));
+            responses += '\n';
+            begin = end + 1;
+        }
+        buffer.erase(0, begin);
+        if (!responses.empty() && !WriteAll(fd, responses))
+            return;
+    }
+}
+
+std::string RouteServer::HandleRequest(const std::string &line)
+{
+    std::istringstream request{line};
+    std::string command;
+    request >> command;
+
+    if (command == "ROUTE")
+    {
+        float start_x, start_y, end_x, end_y;
+        if (!(request >> start_x >> start_y >> end_x >> end_y))
+            return "ERR expected: ROUTE <start_x> <start_y> <end_x> <end_y>";
+        return Route(start_x, start_y, end_x, end_y);
+    }
+    if (command == "STATS")
+    {
+        const auto stats = m_Cache.GetStats();
+        return "OK " + std::to_string(stats.hits) + " " + std::to_string(stats.misses) + " " +
+               std::to_string(stats.evictions) + " " + std::to_string(stats.size);
+    }
+    return "ERR unknown command";
+}
+
+std::string RouteServer::Route(float start_x, float start_y, float end_x, float end_y)
+{
+    // Snapping and both searches only read the model's immutable R-tree and
+    // road graph, so no lock is needed.
+    const auto start = m_Model.SnapToRoad(start_x * 0.01f, start_y * 0.01f);
+    const auto end = m_Model.SnapToRoad(end_x * 0.01f, end_y * 0.01f);
+    if (!start || !end)
+        return "ERR no roads";
+
+    RouteCache::Route route;
+    if (auto cached = m_Cache.Lookup(m_Model, *start, *end))
+    {
+        route = std::move(*cached);
+    }
+    else
+    {
+        const RoadGraph &graph = m_Model.Graph();
+        auto path = m_SearchThreads > 0 ? ParallelSnappedShortestPath(graph, *start, *end, m_SearchThreads)
+                                        : SnappedShortestPath(graph, *start, *end);
+        if (!path.found)
+            return "ERR no route";
+        route.distance = (float)(path.distance * graph.MetricScale());
+        route.path = std::move(path.nodes);
+        m_Cache.Insert(m_Model, *start, *end, route);
+    }
+
+    char distance[32];
+    std::snprintf(distance, sizeof(distance), "%.3f", route.distance);
+    std::string response = "OK ";
+    response += distance;
+    response += ' ';
+    response += std::to_string(route.path.size());
+    for (int index : route.path)
+    {
+        response += ' ';
+        response += std::to_string(index);
+    }
+    return response;
+}
@@ -0,0 +1,76 @@
+#ifndef ROUTE_SERVER_H
+#define ROUTE_SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "route_model.h"
+#include "route_cache.h"
+
+// Headless routing daemon. The model is loaded once by the caller and queries
+// are served over a Unix-domain stream socket with a line protocol:
+//
+//   ROUTE <start_x> <start_y> <end_x> <end_y>   (percent of the map, as in main)
+//     -> OK <distance_m> <n> <node_index_1> ... <node_index_n>
+//   STATS
+//     -> OK <hits> <misses> <evictions> <cached_routes>
+//
+// Both points are snapped onto the nearest road segment with
+// RouteModel::SnapToRoad, and the route runs between the projections: the
+// distance includes the partial segments at either end, and the node indices
+// are the road graph nodes in between, possibly none.
+//
+// Errors are reported as "ERR <message>". A connection may send any number of
+// requests. Connections are served by a fixed worker pool. Misses are searched
+// with SnappedShortestPath over the model's RoadGraph, which keeps its state
+// to itself, so they run concurrently as well as hits.
+//
+// With `search_threads` > 0 misses are instead planned by the parallel HDA*
+// search, each on `search_threads` threads.
+class RouteServer
+{
+public:
+  RouteServer(RouteModel &model, std::string socket_path, std::size_t workers, std::size_t cache_capacity,
+              unsigned search_threads = 0);
+  ~RouteServer();
+
+  // Binds the socket and serves until Stop() is called. Throws std::runtime_error
+  // if the socket cannot be set up.
+  void Run();
+
+  // Stops accepting connections, lets in-flight requests finish and makes Run()
+  // return. Safe to call from any thread.
+  void Stop();
+
+  std::string HandleRequest(const std::string &line);
+
+private:
+  void AcceptLoop();
+  void WorkerLoop();
+  void ServeConnection(int fd);
+  std::string Route(float start_x, float start_y, float end_x, float end_y);
+
+  RouteModel &m_Model;
+  RouteCache m_Cache;
+  std::string m_SocketPath;
+  std::size_t m_WorkerCount;
+  unsigned m_SearchThreads;
+
+  int m_ListenFd = -1;
+  int m_WakeFds[2] = {-1, -1};
+  std::atomic<bool> m_Stopping{false};
+
+  std::mutex m_QueueMutex;
+  std::condition_variable m_QueueCondition;
+  std::deque<int> m_Pending;
+  std::set<int> m_Active;
+  std::vector<std::thread> m_Workers;
+};
+
+#endif
@@ -0,0 +1,302 @@
+#include "segment_index.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEGMENT_INDEX_SSE2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Sort-Tile-Recursive order: `items` are cut into about sqrt(pages) vertical
+// slices by x, then each slice is sorted by y, so consecutive runs of
+// `capacity` items are spatially compact.
+template <typename T, typename Center>
+void StrOrder(std::vector<T> &items, std::size_t capacity, Center center)
+{
+    const std::size_t pages = (items.size() + capacity - 1) / capacity;
+    const std::size_t slices = (std::size_t)std::ceil(std::sqrt((double)pages));
+    const std::size_t slice_size = slices * capacity;
+    std::sort(items.begin(), items.end(), [&](const T &a, const T &b) { return center(a).first < center(b).first; });
+    for (std::size_t begin = 0; begin < items.size(); begin += slice_size) {
+        auto end = items.begin() + std::min(items.size(), begin + slice_size);
+        std::sort(items.begin() + begin, end, [&](const T &a, const T &b) { return center(a).second < center(b).second; });
+    }
+}
+
+// Squared distances from (x, y) to the child boxes of an inner block. GCC does
+// not if-convert the min/max chains at -O2, so x86-64 gets them spelled out
+// with SSE2, which every x86-64 CPU has.
+template <typename Inner>
+void BoxDistances(const Inner &node, float x, float y, float *out)
+{
+    constexpr int width = (int)(sizeof(node.min_x) / sizeof(float));
+#ifdef SEGMENT_INDEX_SSE2
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y), zero = _mm_setzero_ps();
+    for (int k = 0; k < width; k += 4) {
+        const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(node.min_x + k), px),
+                                                _mm_sub_ps(px, _mm_load_ps(node.max_x + k))), zero);
+        const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(node.min_y + k), py),
+                                                _mm_sub_ps(py, _mm_load_ps(node.max_y + k))), zero);
+        _mm_store_ps(out + k, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+    }
+#else
+    for (int k = 0; k < width; ++k) {
+        const float dx = std::max(std::max(node.min_x[k] - x, x - node.max_x[k]), 0.f);
+        const float dy = std::max(std::max(node.min_y[k] - y, y - node.max_y[k]), 0.f);
+        out[k] = dx * dx + dy * dy;
+    }
+#endif
+}
+
+// Projections of (x, y) onto the segments of a leaf: position along each
+// segment and squared distance to it.
+template <typename Leaf>
+void SegmentDistances(const Leaf &leaf, float x, float y, float *t, float *out)
+{
+    constexpr int width = (int)(sizeof(leaf.ax) / sizeof(float));
+#ifdef SEGMENT_INDEX_SSE2
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f);
+    for (int k = 0; k < width; k += 4) {
+        const __m128 ax = _mm_load_ps(leaf.ax + k), ay = _mm_load_ps(leaf.ay + k);
+        const __m128 dx = _mm_load_ps(leaf.dx + k), dy = _mm_load_ps(leaf.dy + k);
+        const __m128 projection = _mm_mul_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_sub_ps(px, ax), dx), _mm_mul_ps(_mm_sub_ps(py, ay), dy)),
+            _mm_load_ps(leaf.inv_length2 + k));
+        const __m128 along = _mm_min_ps(_mm_max_ps(projection, zero), one);
+        const __m128 ex = _mm_sub_ps(_mm_add_ps(ax, _mm_mul_ps(along, dx)), px);
+        const __m128 ey = _mm_sub_ps(_mm_add_ps(ay, _mm_mul_ps(along, dy)), py);
+        _mm_store_ps(t + k, along);
+        _mm_store_ps(out + k, _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+    }
+#else
+    for (int k = 0; k < width; ++k) {
+        const float projection = ((x - leaf.ax[k]) * leaf.dx[k] + (y - leaf.ay[k]) * leaf.dy[k]) * leaf.inv_length2[k];
+        t[k] = std::min(std::max(projection, 0.f), 1.f);
+        const float ex = leaf.ax[k] + t[k] * leaf.dx[k] - x;
+        const float ey = leaf.ay[k] + t[k] * leaf.dy[k] - y;
+        out[k] = ex * ex + ey * ey;
+    }
+#endif
+}
+
+}  // namespace
+
+SegmentIndex::SegmentIndex(const RoadGraph &graph)
+{
+    // The graph is undirected; index every edge once.
+    for (int node = 0; node < graph.NodeCount(); ++node)
+        for (int e = 0; e < graph.Degree(node); ++e)
+            if (const int target = graph.Targets(node)[e]; node < target)
+                m_Segments.push_back(Segment{node, target});
+    if (m_Segments.empty())
+        return;
+
+    struct Item {
+        Box box;
+        int id;
+    };
+    auto merge = [](const Box &a, const Box &b) {
+        return Box{std::min(a.min_x, b.min_x), std::min(a.min_y, b.min_y), std::max(a.max_x, b.max_x),
+                   std::max(a.max_y, b.max_y)};
+    };
+    auto center = [](const Item &item) {
+        return std::make_pair(item.box.min_x + item.box.max_x, item.box.min_y + item.box.max_y);
+    };
+
+    std::vector<Item> level;
+    for (int i = 0; i < (int)m_Segments.size(); ++i) {
+        const auto [from, to] = m_Segments[i];
+        level.push_back(Item{{std::min(graph.X(from), graph.X(to)), std::min(graph.Y(from), graph.Y(to)),
+                              std::max(graph.X(from), graph.X(to)), std::max(graph.Y(from), graph.Y(to))},
+                             i});
+    }
+
+    // Leaves. Padding segments sit so far away that their squared distance
+    // overflows to infinity.
+    StrOrder(level, kFanout, center);
+    std::vector<Item> parents;
+    for (std::size_t first = 0; first < level.size(); first += kFanout) {
+        Leaf leaf;
+        Box box = level[first].box;
+        for (int k = 0; k < kFanout; ++k) {
+            leaf.ax[k] = leaf.ay[k] = std::numeric_limits<float>::max();
+            leaf.dx[k] = leaf.dy[k] = leaf.inv_length2[k] = 0.f;
+            leaf.segment[k] = level[first].id;
+            if (first + k >= level.size())
+                continue;
+            const int id = level[first + k].id;
+            const auto [from, to] = m_Segments[id];
+            const float dx = graph.X(to) - graph.X(from), dy = graph.Y(to) - graph.Y(from);
+            const float length2 = dx * dx + dy * dy;
+            leaf.ax[k] = graph.X(from);
+            leaf.ay[k] = graph.Y(from);
+            leaf.dx[k] = dx;
+            leaf.dy[k] = dy;
+            leaf.inv_length2[k] = length2 > 0.f ? 1.f / length2 : 0.f;
+            leaf.segment[k] = id;
+            box = merge(box, level[first + k].box);
+        }
+        parents.push_back(Item{box, (int)m_Leaves.size()});
+        m_Leaves.push_back(leaf);
+    }
+
+    // Inner levels up to a single root. Padding boxes are inverted so their
+    // distance is infinite.
+    bool leaf_children = true;
+    do {
+        level = std::move(parents);
+        parents.clear();
+        StrOrder(level, kFanout, center);
+        for (std::size_t first = 0; first < level.size(); first += kFanout) {
+            Inner inner;
+            inner.leaf_children = leaf_children;
+            Box box = level[first].box;
+            for (int k = 0; k < kFanout; ++k) {
+                inner.min_x[k] = inner.min_y[k] = std::numeric_limits<float>::infinity();
+                inner.max_x[k] = inner.max_y[k] = -std::numeric_limits<float>::infinity();
+                inner.child[k] = -1;
+                if (first + k >= level.size())
+                    continue;
+                const Item &item = level[first + k];
+                inner.min_x[k] = item.box.min_x;
+                inner.min_y[k] = item.box.min_y;
+                inner.max_x[k] = item.box.max_x;
+                inner.max_y[k] = item.box.max_y;
+                inner.child[k] = item.id;
+                box = merge(box, item.box);
+            }
+            parents.push_back(Item{box, (int)m_Inners.size()});
+            m_Inners.push_back(inner);
+        }
+        leaf_children = false;
+    } while (parents.size() > 1);
+    m_Root = parents.front().id;
+}
+
+std::optional<SegmentSnap> SegmentIndex::Nearest(float x, float y) const
+{
+    if (m_Root < 0)
+        return std::nullopt;
+
+    int best_leaf = 0;
+    int best_slot = 0;
+    float best_t = 0.f;
+    float best_distance2 = std::numeric_limits<float>::infinity();
+    // Depth-first branch and bound. The stack holds at most kFanout entries
+    // per level, far below kMaxStack for any map.
+    struct Entry {
+        float distance2;  // From the query point to the node's box.
+        int index;
+        bool leaf;
+    };
+    constexpr int kMaxStack = 256;
+    Entry stack[kMaxStack];
+    int size = 0;
+    stack[size++] = Entry{0.f, m_Root, false};
+    while (size > 0) {
+        const Entry entry = stack[--size];
+        if (entry.distance2 >= best_distance2)
+            continue;
+
+        if (!entry.leaf) {
+            const Inner &node = m_Inners[entry.index];
+            alignas(16) float d2[kFanout];
+            BoxDistances(node, x, y, d2);
+            // Only the nearest child needs to come first: it usually holds the
+            // answer, and the tight bound it yields prunes its siblings.
+            // Children are always stored but only kept if they can still beat
+            // the best segment, which avoids unpredictable branches.
+            const int pushed = size;
+            int nearest = size;
+            float nearest_distance2 = best_distance2;
+            for (int k = 0; k < kFanout; ++k) {
+                stack[size] = Entry{d2[k], node.child[k], node.leaf_children};
+                nearest = d2[k] < nearest_distance2 ? size : nearest;
+                nearest_distance2 = std::min(d2[k], nearest_distance2);
+                size += d2[k] < best_distance2;
+            }
+            if (size > pushed)
+                std::swap(stack[nearest], stack[size - 1]);
+            continue;
+        }
+
+        const Leaf &leaf = m_Leaves[entry.index];
+        alignas(16) float t[kFanout], d2[kFanout];
+        SegmentDistances(leaf, x, y, t, d2);
+        for (int k = 0; k < kFanout; ++k) {
+            const bool closer = d2[k] < best_distance2;
+            best_distance2 = closer ? d2[k] : best_distance2;
+            best_leaf = closer ? entry.index : best_leaf;
+            best_slot = closer ? k : best_slot;
+            best_t = closer ? t[k] : best_t;
+        }
+    }
+
+    const Leaf &leaf = m_Leaves[best_leaf];
+    const Segment &segment = m_Segments[leaf.segment[best_slot]];
+    return SegmentSnap{segment.from,
+                       segment.to,
+                       best_t,
+                       leaf.ax[best_slot] + best_t * leaf.dx[best_slot],
+                       leaf.ay[best_slot] + best_t * leaf.dy[best_slot],
+                       std::sqrt(best_distance2)};
+}
+
+namespace {
+
+// RoadGraph plus two virtual nodes placed at the snapped start and goal.
+class SnappedGraph
+{
+public:
+    SnappedGraph(const RoadGraph &graph, const SegmentSnap &start_snap, const SegmentSnap &goal_snap)
+        : start(graph.NodeCount()), goal(graph.NodeCount() + 1), m_Graph(graph), m_Start(start_snap), m_Goal(goal_snap) {}
+
+    const int start;
+    const int goal;
+
+    float X(GraphNodeRef ref) const { return ref.node == start ? m_Start.x : ref.node == goal ? m_Goal.x : m_Graph.X(ref); }
+    float Y(GraphNodeRef ref) const { return ref.node == start ? m_Start.y : ref.node == goal ? m_Goal.y : m_Graph.Y(ref); }
+
+    template <typename Visitor>
+    void ForEachEdge(GraphNodeRef ref, Visitor &&visit) const {
+        if (ref.node == start) {
+            // The virtual nodes lie on straight segments, so straight-line
+            // distances to the segment ends are the partial edge costs.
+            visit(EdgeTo(m_Start.from, m_Start));
+            visit(EdgeTo(m_Start.to, m_Start));
+            if (std::minmax(m_Start.from, m_Start.to) == std::minmax(m_Goal.from, m_Goal.to))
+                visit(GraphEdge{goal, 0, std::hypot(m_Start.x - m_Goal.x, m_Start.y - m_Goal.y), m_Goal.x, m_Goal.y});
+            return;
+        }
+        if (ref.node == goal)
+            return;
+        m_Graph.ForEachEdge(ref, visit);
+        if (ref.node == m_Goal.from || ref.node == m_Goal.to)
+            visit(GraphEdge{goal, 0, std::hypot(m_Graph.X(ref) - m_Goal.x, m_Graph.Y(ref) - m_Goal.y), m_Goal.x, m_Goal.y});
+    }
+
+private:
+    GraphEdge EdgeTo(int node, const SegmentSnap &snap) const {
+        const float x = m_Graph.X(node), y = m_Graph.Y(node);
+        return GraphEdge{node, 0, std::hypot(x - snap.x, y - snap.y), x, y};
+    }
+
+    const RoadGraph &m_Graph;
+    const SegmentSnap m_Start;
+    const SegmentSnap m_Goal;
+};
+
+}  // namespace
+
+GraphPath SnappedShortestPath(const RoadGraph &graph, const SegmentSnap &start, const SegmentSnap &goal)
+{
+    SnappedGraph snapped{graph, start, goal};
+    GraphPath path = AStarShortestPath(snapped, GraphNodeRef{snapped.start}, GraphNodeRef{snapped.goal});
+    if (path.found)
+        path.nodes = std::vector<int>(path.nodes.begin() + 1, path.nodes.end() - 1);
+    return path;
+}
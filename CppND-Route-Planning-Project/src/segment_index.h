@@ -0,0 +1,78 @@
+#ifndef SEGMENT_INDEX_H
+#define SEGMENT_INDEX_H
+
+#include <optional>
+#include <vector>
+#include "graph_search.h"
+#include "road_graph.h"
+
+// A point projected onto a road segment. The segment runs from node `from` to
+// node `to`; `t` in [0, 1] is the position of the projection along it and
+// (x, y) its coordinates.
+struct SegmentSnap {
+    int from;
+    int to;
+    float t;
+    float x;
+    float y;
+    float distance;  // From the query point to (x, y).
+};
+
+// Packed R-tree over the edges of a RoadGraph, bulk-loaded with
+// Sort-Tile-Recursive: segments are sorted into vertical slices by x, each
+// slice by y, and consecutive runs fill the leaves; the same is repeated on
+// the leaves' boxes for every upper level. Immutable once built; safe to
+// query from several threads.
+class SegmentIndex
+{
+public:
+    explicit SegmentIndex(const RoadGraph &graph);
+
+    // Nearest road segment to (x, y), found by depth-first branch and bound:
+    // the nearest child of each inner node is descended first, and every
+    // subtree whose box is farther than the best segment so far is pruned.
+    // Empty if the graph has no edges.
+    std::optional<SegmentSnap> Nearest(float x, float y) const;
+
+    std::size_t SegmentCount() const noexcept { return m_Segments.size(); }
+
+private:
+    static constexpr int kFanout = 8;
+
+    struct Box {
+        float min_x, min_y, max_x, max_y;
+    };
+    struct Segment {
+        int from;
+        int to;
+    };
+    // Tree nodes are stored as fixed-width blocks of structure-of-arrays so
+    // the per-child loops have a constant trip count and vectorize. Unused
+    // slots hold empty boxes and degenerate segments that are never chosen.
+    struct alignas(32) Inner {
+        float min_x[kFanout], min_y[kFanout], max_x[kFanout], max_y[kFanout];
+        int child[kFanout];
+        bool leaf_children;
+    };
+    // Segment geometry is copied in, with the inverse squared length
+    // precomputed, so leaf scans neither touch the graph nor divide.
+    struct alignas(32) Leaf {
+        float ax[kFanout], ay[kFanout], dx[kFanout], dy[kFanout];
+        float inv_length2[kFanout];  // 0 for degenerate segments.
+        int segment[kFanout];
+    };
+
+    std::vector<Segment> m_Segments;
+    std::vector<Leaf> m_Leaves;
+    std::vector<Inner> m_Inners;
+    int m_Root = -1;  // Index into m_Inners.
+};
+
+// Shortest path between two points snapped onto road segments. Each snap is
+// treated as a virtual node joined to both ends of its segment by the partial
+// segment lengths, so a route may start or end in the middle of a long road
+// instead of at its nearest vertex. `nodes` of the result holds only real
+// graph nodes; `distance` includes the partial segments.
+GraphPath SnappedShortestPath(const RoadGraph &graph, const SegmentSnap &start, const SegmentSnap &goal);
+
+#endif
@@ -0,0 +1,98 @@
+// Micro-benchmark for endpoint snapping. Times RouteModel::FindClosestNode,
+// the vectorized scan over every routable vertex, against SnapToRoad, the
+// R-tree query over road segments, on the same random points: uniform over
+// the map, and near roads (vertices jittered by a few meters).
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "read_file.h"
+#include "route_model.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Point {
+    float x;
+    float y;
+};
+
+// Best of `rounds` passes over `points`, in nanoseconds per query. `snap`
+// returns a node index; their sum keeps the compiler from dropping the calls.
+template <typename Snap>
+static double Time(const std::vector<Point> &points, int rounds, Snap snap)
+{
+    double best = 1e300;
+    long sink = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+        const auto begin = Clock::now();
+        for (const auto &point : points)
+            sink += snap(point.x, point.y);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        best = std::min(best, ns / (double)points.size());
+    }
+    if (sink == -1)
+        std::cout << sink;
+    return best;
+}
+
+int main(int argc, const char **argv)
+{
+    std::string osm_file = "../map.osm";
+    int queries = 100000;
+    int rounds = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "-f" && ++i < argc)
+            osm_file = argv[i];
+        else if (arg == "-n" && ++i < argc)
+            queries = std::max(1, std::stoi(argv[i]));
+        else if (arg == "-r" && ++i < argc)
+            rounds = std::max(1, std::stoi(argv[i]));
+        else
+        {
+            std::cout << "Usage: snap_bench [-f map.osm] [-n queries] [-r rounds]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto data = ReadFile(osm_file);
+    if (!data)
+    {
+        std::cout << "Failed to read " << osm_file << std::endl;
+        return 1;
+    }
+    RouteModel model{*data};
+
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+    std::vector<Point> uniform(queries);
+    for (auto &point : uniform)
+        point = Point{coordinate(rng), coordinate(rng)};
+
+    const float meters = (float)(1.0 / model.MetricScale());
+    std::normal_distribution<float> jitter{0.f, 5.f * meters};
+    std::uniform_int_distribution<int> pick{0, model.Graph().NodeCount() - 1};
+    std::vector<Point> near_roads;
+    while ((int)near_roads.size() < queries)
+    {
+        const int node = pick(rng);
+        if (model.Graph().Degree(node) > 0)
+            near_roads.push_back(Point{model.Graph().X(node) + jitter(rng), model.Graph().Y(node) + jitter(rng)});
+    }
+
+    auto scan = [&](float x, float y) { return model.FindClosestNode(x, y).Index(); };
+    auto rtree = [&](float x, float y) { return model.SnapToRoad(x, y)->from; };
+    std::printf("%s: %d nodes, %zu road segments, %d queries, best of %d\n", osm_file.c_str(),
+                model.Graph().NodeCount(), model.Graph().EdgeCount() / 2, queries, rounds);
+    std::printf("uniform     FindClosestNode %7.1f ns  SnapToRoad %7.1f ns\n", Time(uniform, rounds, scan),
+                Time(uniform, rounds, rtree));
+    std::printf("near roads  FindClosestNode %7.1f ns  SnapToRoad %7.1f ns\n", Time(near_roads, rounds, scan),
+                Time(near_roads, rounds, rtree));
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "tile_renderer.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "feature_grid.h"
+#include "render.h"
+
+namespace {
+
+struct TileId {
+    int z, x, y;
+};
+
+// The tiles of one zoom level that overlap the data, as an x/y index range.
+struct LevelRange {
+    int z;
+    int min_x, max_x, min_y, max_y;
+    std::size_t Count() const { return (std::size_t)(max_x - min_x + 1) * (std::size_t)(max_y - min_y + 1); }
+};
+
+// Hands out the tiles of every level in order without materializing them, so
+// deep levels cost nothing until a worker asks for their tiles.
+class TileSequence
+{
+public:
+    TileSequence(const FeatureGrid &grid, int min_zoom, int max_zoom)
+    {
+        // Tiles outside the bounding box of all features would only show the
+        // background, so each level is limited to the tiles overlapping it.
+        FeatureGrid::Box data{grid.Extent(), grid.Extent(), 0.f, 0.f};
+        for (int layer = 0; layer < FeatureGrid::LayerCount; ++layer)
+            for (int item = 0; item < grid.Size((FeatureGrid::Layer)layer); ++item) {
+                const auto &box = grid.Bounds((FeatureGrid::Layer)layer, item);
+                data = {std::min(data.min_x, box.min_x), std::min(data.min_y, box.min_y),
+                        std::max(data.max_x, box.max_x), std::max(data.max_y, box.max_y)};
+            }
+        if (data.min_x > data.max_x)
+            return;
+
+        for (int z = min_zoom; z <= max_zoom; ++z) {
+            const int last = (1 << z) - 1;
+            const float tile_units = grid.Extent() / static_cast<float>(1 << z);
+            auto tile = [&](float units) { return std::clamp((int)(units / tile_units), 0, last); };
+            // Tile rows count down from the top of the map.
+            m_Levels.push_back(LevelRange{z, tile(data.min_x), tile(data.max_x), tile(grid.Extent() - data.max_y),
+                                          tile(grid.Extent() - data.min_y)});
+            m_Size += m_Levels.back().Count();
+        }
+    }
+
+    std::size_t Size() const { return m_Size; }
+
+    TileId operator[](std::size_t index) const
+    {
+        for (const auto &level : m_Levels) {
+            if (index < level.Count()) {
+                const int columns = level.max_x - level.min_x + 1;
+                return TileId{level.z, level.min_x + (int)(index % columns), level.min_y + (int)(index / columns)};
+            }
+            index -= level.Count();
+        }
+        return TileId{-1, -1, -1};
+    }
+
+private:
+    std::vector<LevelRange> m_Levels;
+    std::size_t m_Size = 0;
+};
+
+}  // namespace
+
+std::size_t RenderTilePyramid(RouteModel &model, const TilePyramidOptions &options)
+{
+    namespace fs = std::filesystem;
+    if (options.min_zoom < 0 || options.max_zoom < options.min_zoom || options.max_zoom > kMaxTileZoom)
+        throw std::runtime_error("invalid zoom range");
+
+    const FeatureGrid grid{model};
+    const TileSequence tiles{grid, options.min_zoom, options.max_zoom};
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&] {
+        try {
+            Render render{model, &grid};
+            io2d::image_surface surface{io2d::format::argb32, options.tile_size, options.tile_size};
+            for (std::size_t i = next++; i < tiles.Size() && !failed; i = next++) {
+                const auto tile = tiles[i];
+                render.RenderTile(surface, tile.z, tile.x, tile.y);
+                // Directories are created as their first tile is written, as
+                // deep levels have too many columns to create up front.
+                const auto dir = fs::path{options.output_dir} / std::to_string(tile.z) / std::to_string(tile.x);
+                std::error_code dir_error;
+                if (fs::create_directories(dir, dir_error); dir_error)
+                    throw std::runtime_error("cannot create " + dir.string() + ": " + dir_error.message());
+                surface.save(dir / (std::to_string(tile.y) + ".png"), io2d::image_file_format::png);
+            }
+        } catch (...) {
+            std::lock_guard lock{error_mutex};
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+        }
+    };
+
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<std::size_t>(threads, std::max<std::size_t>(tiles.Size(), 1));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(work);
+    work();
+    for (auto &thread : pool)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return tiles.Size();
+}
@@ -0,0 +1,29 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <cstddef>
+#include <string>
+#include "route_model.h"
+
+// Deepest zoom level RenderTilePyramid accepts.
+constexpr int kMaxTileZoom = 20;
+
+struct TilePyramidOptions {
+    std::string output_dir;
+    int min_zoom = 0;
+    int max_zoom = 4;
+    int tile_size = 256;
+    unsigned threads = 0;  // 0 uses std::thread::hardware_concurrency().
+};
+
+// Renders `model` headlessly into a z/x/y PNG tile pyramid under
+// `options.output_dir` (`<dir>/<z>/<x>/<y>.png`). Only the tiles that overlap
+// the bounding box of the map's features are rendered. They are handed out to
+// worker threads from a shared counter and computed from it level by level,
+// so no tile list is ever built; every worker owns its own Render and image
+// surface, and a FeatureGrid shared by all of them limits each tile to the
+// features that intersect it. Returns the number of tiles written. Throws
+// std::runtime_error if the output directories cannot be created.
+std::size_t RenderTilePyramid(RouteModel &model, const TilePyramidOptions &options);
+
+#endif
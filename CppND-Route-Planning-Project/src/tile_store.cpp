@@ -0,0 +1,237 @@
+#include "tile_store.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+struct Cell {
+    float min_x, min_y, max_x, max_y;
+};
+
+struct Leaf {
+    std::vector<int> nodes;
+    std::uint32_t depth;
+    std::uint32_t quadkey;
+};
+
+void Partition(const RoadGraph &graph, std::vector<int> nodes, Cell cell, std::uint32_t depth,
+               std::uint32_t quadkey, int max_nodes, int max_depth, std::vector<Leaf> &leaves)
+{
+    if ((int)nodes.size() <= max_nodes || (int)depth >= max_depth) {
+        leaves.push_back(Leaf{std::move(nodes), depth, quadkey});
+        return;
+    }
+    const float mid_x = (cell.min_x + cell.max_x) / 2;
+    const float mid_y = (cell.min_y + cell.max_y) / 2;
+    std::vector<int> quadrants[4];
+    for (int node : nodes) {
+        const int quadrant = (graph.X(node) >= mid_x ? 1 : 0) | (graph.Y(node) >= mid_y ? 2 : 0);
+        quadrants[quadrant].push_back(node);
+    }
+    nodes = {};
+    for (int q = 0; q < 4; ++q) {
+        if (quadrants[q].empty())
+            continue;
+        const Cell child{
+            q & 1 ? mid_x : cell.min_x, q & 2 ? mid_y : cell.min_y,
+            q & 1 ? cell.max_x : mid_x, q & 2 ? cell.max_y : mid_y};
+        Partition(graph, std::move(quadrants[q]), child, depth + 1, (quadkey << 2) | q, max_nodes, max_depth, leaves);
+    }
+}
+
+float SquaredDistanceToBox(const TileFormat::TileInfo &info, float x, float y)
+{
+    const float dx = std::max({info.min_x - x, 0.f, x - info.max_x});
+    const float dy = std::max({info.min_y - y, 0.f, y - info.max_y});
+    return dx * dx + dy * dy;
+}
+
+}  // namespace
+
+std::size_t WriteTiles(const RoadGraph &graph, const std::string &path, int max_nodes_per_tile, int max_depth)
+{
+    using namespace TileFormat;
+
+    std::vector<int> routable;
+    Cell bounds{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for (int node = 0; node < graph.NodeCount(); ++node) {
+        if (graph.Degree(node) == 0)
+            continue;
+        routable.push_back(node);
+        bounds.min_x = std::min(bounds.min_x, graph.X(node));
+        bounds.min_y = std::min(bounds.min_y, graph.Y(node));
+        bounds.max_x = std::max(bounds.max_x, graph.X(node));
+        bounds.max_y = std::max(bounds.max_y, graph.Y(node));
+    }
+
+    std::vector<Leaf> leaves;
+    if (!routable.empty())
+        Partition(graph, std::move(routable), bounds, 0, 0, std::max(1, max_nodes_per_tile), max_depth, leaves);
+
+    std::vector<std::uint32_t> tile_of(graph.NodeCount(), 0);
+    for (std::size_t t = 0; t < leaves.size(); ++t) {
+        std::sort(leaves[t].nodes.begin(), leaves[t].nodes.end());
+        for (int node : leaves[t].nodes)
+            tile_of[node] = (std::uint32_t)t;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.tile_count = (std::uint32_t)leaves.size();
+    header.node_count = (std::uint32_t)graph.NodeCount();
+    header.metric_scale = graph.MetricScale();
+
+    std::vector<TileInfo> directory(leaves.size());
+    std::uint64_t offset = sizeof(FileHeader) + sizeof(TileInfo) * directory.size();
+    for (std::size_t t = 0; t < leaves.size(); ++t) {
+        TileInfo &info = directory[t];
+        info.min_x = info.min_y = std::numeric_limits<float>::max();
+        info.max_x = info.max_y = std::numeric_limits<float>::lowest();
+        info.edge_count = 0;
+        for (int node : leaves[t].nodes) {
+            info.min_x = std::min(info.min_x, graph.X(node));
+            info.min_y = std::min(info.min_y, graph.Y(node));
+            info.max_x = std::max(info.max_x, graph.X(node));
+            info.max_y = std::max(info.max_y, graph.Y(node));
+            info.edge_count += graph.Degree(node);
+        }
+        info.node_count = (std::uint32_t)leaves[t].nodes.size();
+        info.depth = leaves[t].depth;
+        info.quadkey = leaves[t].quadkey;
+        info.offset = offset;
+        offset += sizeof(TileNode) * info.node_count + sizeof(TileEdge) * info.edge_count;
+    }
+
+    std::ofstream os{path, std::ios::binary | std::ios::trunc};
+    if (!os)
+        throw std::runtime_error("cannot write tiles to " + path);
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(directory.data()), sizeof(TileInfo) * directory.size());
+
+    std::vector<TileNode> nodes;
+    std::vector<TileEdge> edges;
+    for (const Leaf &leaf : leaves) {
+        nodes.clear();
+        edges.clear();
+        for (int node : leaf.nodes) {
+            nodes.push_back(TileNode{node, graph.X(node), graph.Y(node), (std::uint32_t)edges.size()});
+            const int *targets = graph.Targets(node);
+            const float *lengths = graph.Lengths(node);
+            for (int e = 0; e < graph.Degree(node); ++e)
+                edges.push_back(TileEdge{targets[e], tile_of[targets[e]], lengths[e], graph.X(targets[e]), graph.Y(targets[e])});
+        }
+        os.write(reinterpret_cast<const char *>(nodes.data()), sizeof(TileNode) * nodes.size());
+        os.write(reinterpret_cast<const char *>(edges.data()), sizeof(TileEdge) * edges.size());
+    }
+    if (!os)
+        throw std::runtime_error("failed writing tiles to " + path);
+    return leaves.size();
+}
+
+TiledRouteModel::TiledRouteModel(const std::string &path, std::size_t memory_budget_bytes)
+    : m_File(path, std::ios::binary), m_Budget(memory_budget_bytes)
+{
+    using namespace TileFormat;
+    if (!m_File)
+        throw std::runtime_error("cannot open tiles " + path);
+    m_File.read(reinterpret_cast<char *>(&m_Header), sizeof(m_Header));
+    if (!m_File || std::memcmp(m_Header.magic, kMagic, sizeof(kMagic)) != 0 || m_Header.version != kVersion)
+        throw std::runtime_error(path + " is not a version " + std::to_string(kVersion) + " tile pack");
+    m_Directory.resize(m_Header.tile_count);
+    m_File.read(reinterpret_cast<char *>(m_Directory.data()), sizeof(TileInfo) * m_Directory.size());
+    if (!m_File)
+        throw std::runtime_error("truncated tile directory in " + path);
+}
+
+const TiledRouteModel::Tile &TiledRouteModel::Acquire(int tile_id)
+{
+    using namespace TileFormat;
+    if (auto it = m_Resident.find(tile_id); it != m_Resident.end()) {
+        m_Lru.splice(m_Lru.begin(), m_Lru, it->second.lru);
+        return it->second;
+    }
+
+    const TileInfo &info = m_Directory.at(tile_id);
+    const std::size_t bytes = sizeof(TileNode) * info.node_count + sizeof(TileEdge) * info.edge_count;
+    while (!m_Lru.empty() && m_Stats.resident_bytes + bytes > m_Budget) {
+        const int victim = m_Lru.back();
+        m_Lru.pop_back();
+        m_Stats.resident_bytes -= m_Resident[victim].bytes;
+        m_Resident.erase(victim);
+        m_Stats.evictions++;
+    }
+
+    Tile tile;
+    tile.nodes.resize(info.node_count);
+    tile.edges.resize(info.edge_count);
+    tile.bytes = bytes;
+    m_File.clear();
+    m_File.seekg((std::streamoff)info.offset);
+    m_File.read(reinterpret_cast<char *>(tile.nodes.data()), sizeof(TileNode) * tile.nodes.size());
+    m_File.read(reinterpret_cast<char *>(tile.edges.data()), sizeof(TileEdge) * tile.edges.size());
+    if (!m_File)
+        throw std::runtime_error("truncated tile " + std::to_string(tile_id));
+
+    m_Lru.push_front(tile_id);
+    tile.lru = m_Lru.begin();
+    m_Stats.loads++;
+    m_Stats.resident_bytes += bytes;
+    Tile &resident = m_Resident[tile_id] = std::move(tile);
+    m_Stats.resident_tiles = m_Resident.size();
+    return resident;
+}
+
+std::size_t TiledRouteModel::LocalIndex(const Tile &tile, int node)
+{
+    auto it = std::lower_bound(tile.nodes.begin(), tile.nodes.end(), node,
+                               [](const TileFormat::TileNode &n, int id) { return n.id < id; });
+    if (it == tile.nodes.end() || it->id != node)
+        throw std::out_of_range("node " + std::to_string(node) + " is not in its tile");
+    return it - tile.nodes.begin();
+}
+
+float TiledRouteModel::X(GraphNodeRef ref)
+{
+    const Tile &tile = Acquire(ref.tile);
+    return tile.nodes[LocalIndex(tile, ref.node)].x;
+}
+
+float TiledRouteModel::Y(GraphNodeRef ref)
+{
+    const Tile &tile = Acquire(ref.tile);
+    return tile.nodes[LocalIndex(tile, ref.node)].y;
+}
+
+GraphNodeRef TiledRouteModel::FindClosestNode(float x, float y)
+{
+    std::vector<std::pair<float, int>> candidates;
+    candidates.reserve(m_Directory.size());
+    for (std::size_t t = 0; t < m_Directory.size(); ++t)
+        candidates.emplace_back(SquaredDistanceToBox(m_Directory[t], x, y), (int)t);
+    std::sort(candidates.begin(), candidates.end());
+
+    GraphNodeRef best;
+    float best_distance = std::numeric_limits<float>::max();
+    for (const auto &[bound, tile_id] : candidates) {
+        if (bound >= best_distance)
+            break;
+        for (const auto &node : Acquire(tile_id).nodes) {
+            const float dx = node.x - x;
+            const float dy = node.y - y;
+            if (dx * dx + dy * dy < best_distance) {
+                best_distance = dx * dx + dy * dy;
+                best = GraphNodeRef{node.id, tile_id};
+            }
+        }
+    }
+    return best;
+}
+
+GraphPath TiledRouteModel::FindPath(GraphNodeRef start, GraphNodeRef goal)
+{
+    return AStarShortestPath(*this, start, goal);
+}
@@ -0,0 +1,127 @@
+#ifndef TILE_STORE_H
+#define TILE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "graph_search.h"
+#include "road_graph.h"
+
+// Binary tile pack produced offline from a RoadGraph. The routable nodes are
+// partitioned by a quadtree that keeps splitting a cell until it holds at most
+// `max_nodes_per_tile` nodes, so dense downtown areas get small tiles and
+// rural areas large ones. Every leaf becomes a tile.
+//
+// Layout (host byte order):
+//   FileHeader
+//   TileInfo[tile_count]          directory, kept in memory by the reader
+//   per tile: TileNode[node_count] sorted by id, then TileEdge[edge_count]
+//
+// Edges that leave a tile name the tile of their target, so a search simply
+// follows them into the neighbouring tile and routes stay optimal.
+namespace TileFormat {
+constexpr char kMagic[4] = {'O', 'S', 'M', 'T'};
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t tile_count;
+    std::uint32_t node_count;  // Size of the original node id space.
+    double metric_scale;
+};
+
+struct TileInfo {
+    float min_x, min_y, max_x, max_y;  // Tight bounds of the tile's nodes.
+    std::uint64_t offset;
+    std::uint32_t node_count;
+    std::uint32_t edge_count;
+    std::uint32_t depth;                 // Quadtree level of the cell.
+    std::uint32_t quadkey;               // Two bits per level, root first.
+};
+
+struct TileNode {
+    std::int32_t id;
+    float x, y;
+    std::uint32_t first_edge;
+};
+
+struct TileEdge {
+    std::int32_t target;
+    std::uint32_t tile;
+    float length;
+    float x, y;  // Target coordinates, for the A* heuristic.
+};
+}  // namespace TileFormat
+
+// Partitions `graph` and writes the tile pack to `path`. Returns the number of
+// tiles written; throws std::runtime_error if the file cannot be written.
+std::size_t WriteTiles(const RoadGraph &graph, const std::string &path,
+                       int max_nodes_per_tile, int max_depth = 16);
+
+// Road graph backed by a tile pack. Only the directory is read up front; tiles
+// are loaded when a search first touches them and evicted least recently used
+// first once the resident tiles exceed the memory budget. Not thread-safe.
+class TiledRouteModel
+{
+public:
+    struct Stats {
+        std::uint64_t loads = 0;
+        std::uint64_t evictions = 0;
+        std::size_t resident_tiles = 0;
+        std::size_t resident_bytes = 0;
+    };
+
+    // Throws std::runtime_error if the file is missing or not a tile pack.
+    TiledRouteModel(const std::string &path, std::size_t memory_budget_bytes);
+
+    double MetricScale() const noexcept { return m_Header.metric_scale; }
+    std::size_t TileCount() const noexcept { return m_Directory.size(); }
+    const Stats &GetStats() const noexcept { return m_Stats; }
+
+    // Nearest routable node to a point in normalized map coordinates. Tiles are
+    // visited in order of their distance to the point, so only the few that can
+    // contain a closer node are loaded.
+    GraphNodeRef FindClosestNode(float x, float y);
+    GraphPath FindPath(GraphNodeRef start, GraphNodeRef goal);
+
+    // Graph interface for AStarShortestPath.
+    float X(GraphNodeRef ref);
+    float Y(GraphNodeRef ref);
+    template <typename Visitor>
+    void ForEachEdge(GraphNodeRef ref, Visitor &&visit) {
+        const Tile &tile = Acquire(ref.tile);
+        const TileFormat::TileNode &node = tile.nodes[LocalIndex(tile, ref.node)];
+        const std::uint32_t end = &node == &tile.nodes.back() ? (std::uint32_t)tile.edges.size() : (&node + 1)->first_edge;
+        for (std::uint32_t e = node.first_edge; e < end; ++e) {
+            const auto &edge = tile.edges[e];
+            visit(GraphEdge{edge.target, (int)edge.tile, edge.length, edge.x, edge.y});
+        }
+    }
+
+private:
+    struct Tile {
+        std::vector<TileFormat::TileNode> nodes;
+        std::vector<TileFormat::TileEdge> edges;
+        std::size_t bytes = 0;
+        std::list<int>::iterator lru;
+    };
+
+    const Tile &Acquire(int tile_id);
+    static std::size_t LocalIndex(const Tile &tile, int node);
+
+    std::ifstream m_File;
+    TileFormat::FileHeader m_Header{};
+    std::vector<TileFormat::TileInfo> m_Directory;
+    std::size_t m_Budget;
+
+    std::unordered_map<int, Tile> m_Resident;
+    std::list<int> m_Lru;  // Most recently used tile first.
+    Stats m_Stats;
+};
+
+#endif
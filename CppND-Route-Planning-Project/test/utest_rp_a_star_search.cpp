@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <stdexcept>
 #include <vector>
 #include "../src/route_model.h"
 #include "../src/route_planner.h"
@@ -122,3 +125,70 @@ TEST_F(RoutePlannerTest, TestAStarSearch) {
     EXPECT_FLOAT_EQ(end_node->y, path_end.y);
     EXPECT_FLOAT_EQ(route_planner.GetDistance(), 873.41565);
 }
+
+
+// A distinct node closer than float resolution is still a neighbor; only the
+// node itself is excluded.
+TEST(RouteModelTest, TestFindNeighborKeepsCoincidentNodes) {
+    const std::string xml =
+        "<osm><bounds minlat=\"0\" minlon=\"0\" maxlat=\"0.01\" maxlon=\"0.01\"/>"
+        "<node id=\"1\" lat=\"0.005\" lon=\"0.005\"/>"
+        "<node id=\"2\" lat=\"0.00500000001\" lon=\"0.005\"/>"
+        "<node id=\"3\" lat=\"0.006\" lon=\"0.005\"/>"
+        "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><nd ref=\"3\"/>"
+        "<tag k=\"highway\" v=\"residential\"/></way></osm>";
+    std::vector<std::byte> osm_data(xml.size());
+    std::memcpy(osm_data.data(), xml.data(), xml.size());
+    RouteModel model{osm_data};
+    ASSERT_EQ(model.SNodes().size(), 3);
+
+    RouteModel::Node &first = model.SNodes()[0];
+    ASSERT_EQ((float)first.x, (float)model.SNodes()[1].x);
+    ASSERT_EQ((float)first.y, (float)model.SNodes()[1].y);
+    first.FindNeighbors();
+    ASSERT_EQ(first.neighbors.size(), 1);
+    EXPECT_EQ(first.neighbors[0], &model.SNodes()[1]);
+}
+
+
+// A point beside a long road snaps onto that road, at its projection, even
+// though a vertex of another road is nearer than either of its ends.
+TEST(RouteModelTest, TestSnapToRoadPrefersNearestSegment) {
+    const std::string xml =
+        "<osm><bounds minlat=\"0\" minlon=\"0\" maxlat=\"0.01\" maxlon=\"0.01\"/>"
+        "<node id=\"1\" lat=\"0.001\" lon=\"0.001\"/>"
+        "<node id=\"2\" lat=\"0.001\" lon=\"0.009\"/>"
+        "<node id=\"3\" lat=\"0.004\" lon=\"0.005\"/>"
+        "<node id=\"4\" lat=\"0.009\" lon=\"0.005\"/>"
+        "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><tag k=\"highway\" v=\"residential\"/></way>"
+        "<way id=\"11\"><nd ref=\"3\"/><nd ref=\"4\"/><tag k=\"highway\" v=\"residential\"/></way></osm>";
+    std::vector<std::byte> osm_data(xml.size());
+    std::memcpy(osm_data.data(), xml.data(), xml.size());
+    RouteModel model{osm_data};
+    ASSERT_EQ(model.SNodes().size(), 4);
+
+    const auto &a = model.SNodes()[0], &b = model.SNodes()[1], &c = model.SNodes()[2];
+    const float x = (float)(0.6 * a.x + 0.4 * b.x);
+    const float y = (float)(a.y + 0.45 * (c.y - a.y));
+    EXPECT_EQ(&model.FindClosestNode(x, y), &c);
+    auto snap = model.SnapToRoad(x, y);
+    ASSERT_TRUE(snap.has_value());
+    EXPECT_EQ(std::minmax(snap->from, snap->to), std::minmax(a.Index(), b.Index()));
+    EXPECT_NEAR(snap->x, x, 1e-6f);
+    EXPECT_NEAR(snap->y, (float)a.y, 1e-6f);
+}
+
+
+// A map whose only way is a footway has nothing to snap onto.
+TEST(RouteModelTest, TestNoRoutableRoads) {
+    const std::string xml =
+        "<osm><bounds minlat=\"0\" minlon=\"0\" maxlat=\"0.01\" maxlon=\"0.01\"/>"
+        "<node id=\"1\" lat=\"0.001\" lon=\"0.001\"/>"
+        "<node id=\"2\" lat=\"0.001\" lon=\"0.009\"/>"
+        "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><tag k=\"highway\" v=\"footway\"/></way></osm>";
+    std::vector<std::byte> osm_data(xml.size());
+    std::memcpy(osm_data.data(), xml.data(), xml.size());
+    RouteModel model{osm_data};
+    EXPECT_THROW(model.FindClosestNode(0.5f, 0.5f), std::logic_error);
+    EXPECT_FALSE(model.SnapToRoad(0.5f, 0.5f).has_value());
+}
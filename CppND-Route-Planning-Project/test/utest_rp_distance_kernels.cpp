@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+#include "../src/distance_kernels.h"
+
+//--------------------------------//
+//   Beginning DistanceKernels Tests.
+//--------------------------------//
+
+class DistanceKernelsTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        std::mt19937 rng{7};
+        std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+        // An odd size exercises the scalar tail after the vector loop.
+        for (int i = 0; i < 1003; i++) {
+            xs.push_back(coordinate(rng));
+            ys.push_back(coordinate(rng));
+        }
+    }
+
+    static float Expected(float dx, float dy) { return dx * dx + dy * dy; }
+
+    std::vector<float> xs;
+    std::vector<float> ys;
+};
+
+
+TEST_F(DistanceKernelsTest, TestSquaredDistances) {
+    std::vector<float> out(xs.size());
+    DistanceKernels::SquaredDistances(xs.data(), ys.data(), xs.size(), 0.3f, 0.7f, out.data());
+    for (std::size_t i = 0; i < xs.size(); i++) {
+        EXPECT_EQ(out[i], Expected(xs[i] - 0.3f, ys[i] - 0.7f));
+    }
+
+    std::vector<int> indices;
+    for (int i = (int)xs.size() - 1; i >= 0; i -= 3) {
+        indices.push_back(i);
+    }
+    std::vector<float> gathered(indices.size());
+    DistanceKernels::SquaredDistancesGather(xs.data(), ys.data(), indices.data(), indices.size(), 0.3f, 0.7f, gathered.data());
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        EXPECT_EQ(gathered[i], out[indices[i]]);
+    }
+}
+
+
+TEST_F(DistanceKernelsTest, TestArgMinMatchesLinearScan) {
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<float> coordinate{-0.2f, 1.2f};
+    for (int query = 0; query < 200; query++) {
+        const float x = coordinate(rng);
+        const float y = coordinate(rng);
+        std::size_t expected = 0;
+        for (std::size_t i = 1; i < xs.size(); i++) {
+            if (Expected(xs[i] - x, ys[i] - y) < Expected(xs[expected] - x, ys[expected] - y)) {
+                expected = i;
+            }
+        }
+        EXPECT_EQ(DistanceKernels::ArgMinSquaredDistance(xs.data(), ys.data(), xs.size(), x, y), expected);
+    }
+}
+
+
+// Duplicated points resolve to the first occurrence, as a linear scan would.
+TEST_F(DistanceKernelsTest, TestArgMinTiesPickFirst) {
+    std::vector<float> same_xs(37, 0.5f);
+    std::vector<float> same_ys(37, 0.5f);
+    EXPECT_EQ(DistanceKernels::ArgMinSquaredDistance(same_xs.data(), same_ys.data(), same_xs.size(), 0.f, 0.f), 0);
+    EXPECT_EQ(DistanceKernels::ArgMinSquaredDistance(same_xs.data(), same_ys.data(), 0, 0.f, 0.f), 0);
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/feature_grid.h"
+#include "../src/model.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning FeatureGrid Tests.
+//--------------------------------//
+
+class FeatureGridTest : public ::testing::Test {
+  protected:
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    Model model{osm_data};
+    FeatureGrid grid{model, 32};
+
+    FeatureGrid::Selection BruteForce(const FeatureGrid::Box &box) const {
+        FeatureGrid::Selection selection;
+        for (int layer = 0; layer < FeatureGrid::LayerCount; layer++) {
+            for (int item = 0; item < grid.Size((FeatureGrid::Layer)layer); item++) {
+                if (grid.Bounds((FeatureGrid::Layer)layer, item).Intersects(box)) {
+                    selection.items[layer].push_back(item);
+                }
+            }
+        }
+        return selection;
+    }
+};
+
+
+TEST_F(FeatureGridTest, TestIndexesEveryFeature) {
+    EXPECT_EQ(grid.Size(FeatureGrid::Roads), model.Roads().size());
+    EXPECT_EQ(grid.Size(FeatureGrid::Buildings), model.Buildings().size());
+    EXPECT_EQ(grid.Size(FeatureGrid::Landuses), model.Landuses().size());
+    EXPECT_GE(grid.Extent(), 1.f);
+
+    FeatureGrid::Selection all;
+    grid.Query({-1.f, -1.f, grid.Extent() + 1.f, grid.Extent() + 1.f}, all);
+    for (int layer = 0; layer < FeatureGrid::LayerCount; layer++) {
+        // Features without nodes have an empty box and are never returned.
+        std::size_t drawable = 0;
+        for (int item = 0; item < grid.Size((FeatureGrid::Layer)layer); item++) {
+            const auto &box = grid.Bounds((FeatureGrid::Layer)layer, item);
+            drawable += box.min_x <= box.max_x;
+        }
+        EXPECT_EQ(all.items[layer].size(), drawable);
+    }
+}
+
+
+// Queries over tile-sized boxes return exactly the brute-force result, in model order.
+TEST_F(FeatureGridTest, TestQueryMatchesBruteForce) {
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<float> position{-0.1f, grid.Extent()};
+    std::uniform_real_distribution<float> size{0.001f, 0.3f};
+    FeatureGrid::Selection selection;
+    for (int i = 0; i < 200; i++) {
+        const float x = position(rng), y = position(rng), side = size(rng);
+        const FeatureGrid::Box box{x, y, x + side, y + side};
+        grid.Query(box, selection);
+        auto expected = BruteForce(box);
+        for (int layer = 0; layer < FeatureGrid::LayerCount; layer++) {
+            EXPECT_EQ(selection.items[layer], expected.items[layer]);
+        }
+    }
+}
@@ -0,0 +1,314 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+#include "pugixml.hpp"
+#include "../src/model.h"
+#include "../src/osm_pbf.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+// Minimal protobuf writer, used to convert the XML test map into PBF.
+class ProtoWriter {
+  public:
+    void Varint(int field, std::uint64_t value) { Key(field, 0); Raw(value); }
+    void SVarint(int field, std::int64_t value) { Varint(field, ZigZag(value)); }
+    void Bytes(int field, std::string_view bytes) {
+        Key(field, 2);
+        Raw(bytes.size());
+        out.append(bytes);
+    }
+    void Packed(int field, const std::vector<std::uint64_t> &values) {
+        ProtoWriter packed;
+        for (auto value : values) {
+            packed.Raw(value);
+        }
+        Bytes(field, packed.out);
+    }
+    static std::uint64_t ZigZag(std::int64_t value) { return ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63); }
+
+    std::string out;
+
+  private:
+    void Key(int field, int wire) { Raw((std::uint64_t)field << 3 | wire); }
+    void Raw(std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+};
+
+class PbfEncoder {
+  public:
+    // `raw_size` overrides the uncompressed size recorded in the blob.
+    void Blob(std::string_view type, const std::string &payload, std::uint64_t raw_size = 0) {
+        std::string compressed(compressBound(payload.size()), '\0');
+        uLongf size = compressed.size();
+        compress2((Bytef *)compressed.data(), &size, (const Bytef *)payload.data(), payload.size(), 6);
+        compressed.resize(size);
+        ProtoWriter blob;
+        blob.Varint(2, raw_size ? raw_size : payload.size());
+        blob.Bytes(3, compressed);
+
+        ProtoWriter header;
+        header.Bytes(1, type);
+        header.Varint(3, blob.out.size());
+        const auto length = (std::uint32_t)header.out.size();
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            file.push_back((char)(length >> shift));
+        }
+        file += header.out + blob.out;
+    }
+
+    // Returns the string table index of `s`, adding it if needed.
+    std::uint64_t String(std::string_view s) {
+        auto [it, inserted] = strings.try_emplace(std::string(s), strings.size());
+        if (inserted) {
+            table.emplace_back(s);
+        }
+        return it->second;
+    }
+
+    void Block(const std::string &group) {
+        ProtoWriter string_table;
+        for (const auto &s : table) {
+            string_table.Bytes(1, s);
+        }
+        ProtoWriter block;
+        block.Bytes(1, string_table.out);
+        block.Bytes(2, group);
+        Blob("OSMData", block.out);
+        strings.clear();
+        table.clear();
+        String("");
+    }
+
+    PbfEncoder() { String(""); }
+
+    std::string file;
+
+  private:
+    std::unordered_map<std::string, std::uint64_t> strings;
+    std::vector<std::string> table;
+};
+
+static std::int64_t Fixed(const char *degrees, double scale) { return std::llround(std::atof(degrees) * scale); }
+
+// Converts the XML map into PBF with dense nodes, spreading the elements over
+// several blocks so the parallel decoder has work to share.
+static std::vector<std::byte> ConvertToPbf(const std::vector<std::byte> &xml, std::size_t per_block) {
+    pugi::xml_document doc;
+    doc.load_buffer(xml.data(), xml.size());
+    PbfEncoder encoder;
+
+    auto bounds = doc.select_nodes("/osm/bounds").first().node();
+    ProtoWriter bbox;
+    bbox.SVarint(1, Fixed(bounds.attribute("minlon").as_string(), 1e9));
+    bbox.SVarint(2, Fixed(bounds.attribute("maxlon").as_string(), 1e9));
+    bbox.SVarint(3, Fixed(bounds.attribute("maxlat").as_string(), 1e9));
+    bbox.SVarint(4, Fixed(bounds.attribute("minlat").as_string(), 1e9));
+    ProtoWriter header;
+    header.Bytes(1, bbox.out);
+    header.Bytes(4, "OsmSchema-V0.6");
+    header.Bytes(4, "DenseNodes");
+    encoder.Blob("OSMHeader", header.out);
+
+    auto nodes = doc.select_nodes("/osm/node");
+    for (std::size_t begin = 0; begin < nodes.size(); begin += per_block) {
+        std::vector<std::uint64_t> ids, lats, lons;
+        std::int64_t last_id = 0, last_lat = 0, last_lon = 0;
+        for (std::size_t i = begin; i < std::min(nodes.size(), begin + per_block); i++) {
+            auto node = nodes[i].node();
+            const std::int64_t id = std::stoll(node.attribute("id").as_string());
+            const std::int64_t lat = Fixed(node.attribute("lat").as_string(), 1e7);
+            const std::int64_t lon = Fixed(node.attribute("lon").as_string(), 1e7);
+            ids.push_back(ProtoWriter::ZigZag(id - last_id));
+            lats.push_back(ProtoWriter::ZigZag(lat - last_lat));
+            lons.push_back(ProtoWriter::ZigZag(lon - last_lon));
+            last_id = id, last_lat = lat, last_lon = lon;
+        }
+        ProtoWriter dense;
+        dense.Packed(1, ids);
+        dense.Packed(8, lats);
+        dense.Packed(9, lons);
+        ProtoWriter group;
+        group.Bytes(2, dense.out);
+        encoder.Block(group.out);
+    }
+
+    auto ways = doc.select_nodes("/osm/way");
+    for (std::size_t begin = 0; begin < ways.size(); begin += per_block) {
+        ProtoWriter group;
+        for (std::size_t i = begin; i < std::min(ways.size(), begin + per_block); i++) {
+            auto node = ways[i].node();
+            std::vector<std::uint64_t> keys, vals, refs;
+            std::int64_t last_ref = 0;
+            for (auto child : node.children()) {
+                if (std::string_view{child.name()} == "nd") {
+                    const std::int64_t ref = std::stoll(child.attribute("ref").as_string());
+                    refs.push_back(ProtoWriter::ZigZag(ref - last_ref));
+                    last_ref = ref;
+                } else if (std::string_view{child.name()} == "tag") {
+                    keys.push_back(encoder.String(child.attribute("k").as_string()));
+                    vals.push_back(encoder.String(child.attribute("v").as_string()));
+                }
+            }
+            ProtoWriter way;
+            way.Varint(1, std::stoll(node.attribute("id").as_string()));
+            way.Packed(2, keys);
+            way.Packed(3, vals);
+            way.Packed(8, refs);
+            group.Bytes(3, way.out);
+        }
+        encoder.Block(group.out);
+    }
+
+    ProtoWriter group;
+    for (auto relation : doc.select_nodes("/osm/relation")) {
+        auto node = relation.node();
+        std::vector<std::uint64_t> keys, vals, roles, ids, types;
+        std::int64_t last_ref = 0;
+        for (auto child : node.children()) {
+            if (std::string_view{child.name()} == "member") {
+                const std::string_view type = child.attribute("type").as_string();
+                const std::int64_t ref = std::stoll(child.attribute("ref").as_string());
+                roles.push_back(encoder.String(child.attribute("role").as_string()));
+                ids.push_back(ProtoWriter::ZigZag(ref - last_ref));
+                types.push_back(type == "node" ? 0 : type == "way" ? 1 : 2);
+                last_ref = ref;
+            } else if (std::string_view{child.name()} == "tag") {
+                keys.push_back(encoder.String(child.attribute("k").as_string()));
+                vals.push_back(encoder.String(child.attribute("v").as_string()));
+            }
+        }
+        ProtoWriter out;
+        out.Varint(1, std::stoll(node.attribute("id").as_string()));
+        out.Packed(2, keys);
+        out.Packed(3, vals);
+        out.Packed(8, roles);
+        out.Packed(9, ids);
+        out.Packed(10, types);
+        group.Bytes(4, out.out);
+    }
+    encoder.Block(group.out);
+
+    std::vector<std::byte> pbf(encoder.file.size());
+    std::memcpy(pbf.data(), encoder.file.data(), pbf.size());
+    return pbf;
+}
+
+static void ExpectSameMultipolygons(const std::vector<Model::Multipolygon> &a, const std::vector<Model::Multipolygon> &b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); i++) {
+        EXPECT_EQ(a[i].outer, b[i].outer);
+        EXPECT_EQ(a[i].inner, b[i].inner);
+    }
+}
+
+template <typename T>
+static std::vector<Model::Multipolygon> AsMultipolygons(const std::vector<T> &items) {
+    return std::vector<Model::Multipolygon>(items.begin(), items.end());
+}
+
+//--------------------------------//
+//   Beginning OsmPbf Tests.
+//--------------------------------//
+
+class OsmPbfTest : public ::testing::Test {
+  protected:
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    std::vector<std::byte> pbf_data = ConvertToPbf(osm_data, 1000);
+};
+
+
+TEST_F(OsmPbfTest, TestDetectsFormat) {
+    EXPECT_TRUE(OsmPbf::LooksLikePbf(pbf_data));
+    EXPECT_FALSE(OsmPbf::LooksLikePbf(osm_data));
+}
+
+
+// The PBF path feeds the same classification as the XML path, so both models match.
+TEST_F(OsmPbfTest, TestModelMatchesXml) {
+    Model from_xml{osm_data};
+    Model from_pbf{pbf_data};
+
+    EXPECT_DOUBLE_EQ(from_pbf.MetricScale(), from_xml.MetricScale());
+    ASSERT_EQ(from_pbf.Nodes().size(), from_xml.Nodes().size());
+    for (std::size_t i = 0; i < from_xml.Nodes().size(); i++) {
+        EXPECT_DOUBLE_EQ(from_pbf.Nodes()[i].x, from_xml.Nodes()[i].x);
+        EXPECT_DOUBLE_EQ(from_pbf.Nodes()[i].y, from_xml.Nodes()[i].y);
+    }
+    ASSERT_EQ(from_pbf.Ways().size(), from_xml.Ways().size());
+    for (std::size_t i = 0; i < from_xml.Ways().size(); i++) {
+        EXPECT_EQ(from_pbf.Ways()[i].nodes, from_xml.Ways()[i].nodes);
+    }
+    ASSERT_EQ(from_pbf.Roads().size(), from_xml.Roads().size());
+    for (std::size_t i = 0; i < from_xml.Roads().size(); i++) {
+        EXPECT_EQ(from_pbf.Roads()[i].way, from_xml.Roads()[i].way);
+        EXPECT_EQ(from_pbf.Roads()[i].type, from_xml.Roads()[i].type);
+    }
+    ASSERT_EQ(from_pbf.Railways().size(), from_xml.Railways().size());
+    ExpectSameMultipolygons(AsMultipolygons(from_pbf.Buildings()), AsMultipolygons(from_xml.Buildings()));
+    ExpectSameMultipolygons(AsMultipolygons(from_pbf.Leisures()), AsMultipolygons(from_xml.Leisures()));
+    ExpectSameMultipolygons(AsMultipolygons(from_pbf.Waters()), AsMultipolygons(from_xml.Waters()));
+    ExpectSameMultipolygons(AsMultipolygons(from_pbf.Landuses()), AsMultipolygons(from_xml.Landuses()));
+}
+
+
+// Blocks come back in file order whatever the number of decoding threads.
+TEST_F(OsmPbfTest, TestParallelDecodeKeepsOrder) {
+    auto serial = OsmPbf::Decode(pbf_data, 1);
+    auto parallel = OsmPbf::Decode(pbf_data, 4);
+    ASSERT_GT(serial.blocks.size(), 4);
+    ASSERT_EQ(parallel.blocks.size(), serial.blocks.size());
+    for (std::size_t b = 0; b < serial.blocks.size(); b++) {
+        ASSERT_EQ(parallel.blocks[b].nodes.size(), serial.blocks[b].nodes.size());
+        ASSERT_EQ(parallel.blocks[b].ways.size(), serial.blocks[b].ways.size());
+        for (std::size_t i = 0; i < serial.blocks[b].nodes.size(); i++) {
+            EXPECT_EQ(parallel.blocks[b].nodes[i].id, serial.blocks[b].nodes[i].id);
+        }
+    }
+    EXPECT_TRUE(serial.has_bounds);
+}
+
+
+TEST_F(OsmPbfTest, TestRejectsTruncatedFile) {
+    pbf_data.resize(pbf_data.size() / 2);
+    EXPECT_THROW(Model{pbf_data}, std::logic_error);
+}
+
+
+// A blob claiming a huge uncompressed size is rejected before anything is allocated.
+TEST_F(OsmPbfTest, TestRejectsOversizedBlob) {
+    PbfEncoder encoder;
+    encoder.Blob("OSMData", "tiny", std::uint64_t{1} << 40);
+    std::vector<std::byte> pbf(encoder.file.size());
+    std::memcpy(pbf.data(), encoder.file.data(), pbf.size());
+    EXPECT_THROW(OsmPbf::Decode(pbf, 1), std::logic_error);
+}
+
+
+// A relation member type outside node, way and relation is rejected.
+TEST_F(OsmPbfTest, TestRejectsUnknownMemberType) {
+    PbfEncoder encoder;
+    ProtoWriter relation;
+    relation.Varint(1, 1);
+    relation.Packed(8, {encoder.String("outer")});
+    relation.Packed(9, {ProtoWriter::ZigZag(7)});
+    relation.Packed(10, {3});
+    ProtoWriter group;
+    group.Bytes(4, relation.out);
+    encoder.Block(group.out);
+    std::vector<std::byte> pbf(encoder.file.size());
+    std::memcpy(pbf.data(), encoder.file.data(), pbf.size());
+    EXPECT_THROW(OsmPbf::Decode(pbf, 1), std::logic_error);
+}
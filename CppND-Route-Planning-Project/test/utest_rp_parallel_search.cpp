@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/graph_search.h"
+#include "../src/parallel_search.h"
+#include "../src/road_graph.h"
+#include "../src/route_model.h"
+#include "../src/segment_index.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning ParallelSearch Tests.
+//--------------------------------//
+
+class ParallelSearchTest : public ::testing::Test {
+  protected:
+    // Sum of edge lengths along `nodes`, or -1 if two consecutive nodes are not adjacent.
+    float PathLength(const std::vector<int> &nodes) {
+        float length = 0;
+        for (std::size_t i = 1; i < nodes.size(); i++) {
+            bool adjacent = false;
+            for (int e = 0; e < graph.Degree(nodes[i - 1]); e++) {
+                if (graph.Targets(nodes[i - 1])[e] == nodes[i]) {
+                    length += graph.Lengths(nodes[i - 1])[e];
+                    adjacent = true;
+                    break;
+                }
+            }
+            if (!adjacent) {
+                return -1;
+            }
+        }
+        return length;
+    }
+
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    RouteModel model{osm_data};
+    RoadGraph graph{model};
+};
+
+
+// HDA* returns the serial search's optimal distance for every thread count.
+TEST_F(ParallelSearchTest, TestMatchesSerialSearch) {
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+    for (int query = 0; query < 10; query++) {
+        GraphNodeRef start{model.FindClosestNode(coordinate(rng), coordinate(rng)).Index()};
+        GraphNodeRef goal{model.FindClosestNode(coordinate(rng), coordinate(rng)).Index()};
+        auto serial = AStarShortestPath(graph, start, goal);
+
+        for (unsigned threads : {1u, 2u, 4u, 8u}) {
+            auto parallel = ParallelAStarShortestPath(graph, start, goal, threads);
+            ASSERT_EQ(parallel.found, serial.found);
+            if (!serial.found) {
+                continue;
+            }
+            EXPECT_FLOAT_EQ(parallel.distance, serial.distance);
+            EXPECT_EQ(parallel.nodes.front(), start.node);
+            EXPECT_EQ(parallel.nodes.back(), goal.node);
+            EXPECT_NEAR(PathLength(parallel.nodes), parallel.distance, 1e-4f);
+        }
+    }
+}
+
+
+TEST_F(ParallelSearchTest, TestStartIsGoal) {
+    GraphNodeRef node{model.FindClosestNode(0.5f, 0.5f).Index()};
+    auto path = ParallelAStarShortestPath(graph, node, node, 4);
+    ASSERT_TRUE(path.found);
+    EXPECT_FLOAT_EQ(path.distance, 0.0f);
+    EXPECT_EQ(path.nodes, std::vector<int>{node.node});
+}
+
+
+// Between snapped points, HDA* matches SnappedShortestPath: it starts from
+// both ends of the start segment and finishes through either end of the goal's.
+TEST_F(ParallelSearchTest, TestSnappedMatchesSerialSearch) {
+    SegmentIndex index{graph};
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+    for (int query = 0; query < 10; query++) {
+        auto start = *index.Nearest(coordinate(rng), coordinate(rng));
+        auto goal = *index.Nearest(coordinate(rng), coordinate(rng));
+        auto serial = SnappedShortestPath(graph, start, goal);
+
+        for (unsigned threads : {1u, 4u}) {
+            auto parallel = ParallelSnappedShortestPath(graph, start, goal, threads);
+            ASSERT_EQ(parallel.found, serial.found);
+            if (!serial.found) {
+                continue;
+            }
+            EXPECT_NEAR(parallel.distance, serial.distance, 1e-5f);
+            ASSERT_FALSE(parallel.nodes.empty());
+            EXPECT_TRUE(parallel.nodes.front() == start.from || parallel.nodes.front() == start.to);
+            EXPECT_TRUE(parallel.nodes.back() == goal.from || parallel.nodes.back() == goal.to);
+            EXPECT_GE(PathLength(parallel.nodes), 0.0f);
+        }
+    }
+}
+
+
+// Two points on one segment are joined directly, without a graph node.
+TEST_F(ParallelSearchTest, TestSnappedSameSegment) {
+    SegmentIndex index{graph};
+    auto start = *index.Nearest(0.5f, 0.5f);
+    SegmentSnap goal = start;
+    goal.t = start.t < 0.5f ? start.t + 0.1f : start.t - 0.1f;
+    goal.x = graph.X(start.from) + goal.t * (graph.X(start.to) - graph.X(start.from));
+    goal.y = graph.Y(start.from) + goal.t * (graph.Y(start.to) - graph.Y(start.from));
+    auto path = ParallelSnappedShortestPath(graph, start, goal, 4);
+    ASSERT_TRUE(path.found);
+    EXPECT_NEAR(path.distance, std::hypot(goal.x - start.x, goal.y - start.y), 1e-6f);
+    EXPECT_TRUE(path.nodes.empty());
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+#include "../src/route_model.h"
+#include "../src/route_planner.h"
+#include "../src/route_cache.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning RouteCache Tests.
+//--------------------------------//
+
+class RouteCacheTest : public ::testing::Test {
+  protected:
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    RouteModel model{osm_data};
+    RouteCache cache{4};
+};
+
+
+// A repeated query is answered from the cache with the same path and distance.
+TEST_F(RouteCacheTest, TestRepeatedQueryHits) {
+    RoutePlanner first{model, 10, 10, 90, 90, &cache};
+    first.AStarSearch();
+    std::vector<RouteModel::Node> first_path = model.path;
+    EXPECT_EQ(cache.GetStats().misses, 1);
+    EXPECT_EQ(cache.GetStats().size, 1);
+
+    model.path.clear();
+    RoutePlanner second{model, 10, 10, 90, 90, &cache};
+    second.AStarSearch();
+    EXPECT_EQ(cache.GetStats().hits, 1);
+    ASSERT_EQ(model.path.size(), first_path.size());
+    for (std::size_t i = 0; i < first_path.size(); i++) {
+        EXPECT_EQ(model.path[i].Index(), first_path[i].Index());
+    }
+    EXPECT_FLOAT_EQ(second.GetDistance(), first.GetDistance());
+}
+
+
+// The least recently used entry is evicted once capacity is reached.
+TEST_F(RouteCacheTest, TestEviction) {
+    RouteCache small{2};
+    small.Insert(model, 1, 2, {{1, 2}, 1.0f});
+    small.Insert(model, 3, 4, {{3, 4}, 2.0f});
+    EXPECT_TRUE(small.Lookup(model, 1, 2));
+    small.Insert(model, 5, 6, {{5, 6}, 3.0f});
+
+    EXPECT_FALSE(small.Lookup(model, 3, 4));
+    EXPECT_TRUE(small.Lookup(model, 1, 2));
+    EXPECT_TRUE(small.Lookup(model, 5, 6));
+    RouteCache::Stats stats = small.GetStats();
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.size, 2);
+    EXPECT_EQ(stats.hits, 3);
+    EXPECT_EQ(stats.misses, 1);
+}
+
+
+// Entries recorded against one model are dropped when a reloaded model is used.
+TEST_F(RouteCacheTest, TestInvalidatedOnReload) {
+    cache.Insert(model, 1, 2, {{1, 2}, 1.0f});
+    EXPECT_TRUE(cache.Lookup(model, 1, 2));
+
+    RouteModel reloaded{osm_data};
+    EXPECT_FALSE(cache.Lookup(reloaded, 1, 2));
+    EXPECT_EQ(cache.GetStats().size, 0);
+}
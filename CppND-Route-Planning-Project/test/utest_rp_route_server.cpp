@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../src/route_model.h"
+#include "../src/route_server.h"
+#include "../src/segment_index.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning RouteServer Tests.
+//--------------------------------//
+
+class RouteServerTest : public ::testing::Test {
+  protected:
+    // "OK <distance> <n>" for the snapped route from (10, 10) to (90, 90).
+    std::string ExpectedPrefix() {
+        auto path = SnappedShortestPath(model.Graph(), *model.SnapToRoad(0.1f, 0.1f), *model.SnapToRoad(0.9f, 0.9f));
+        EXPECT_TRUE(path.found);
+        char prefix[64];
+        std::snprintf(prefix, sizeof(prefix), "OK %.3f %zu", (float)(path.distance * model.Graph().MetricScale()),
+                      path.nodes.size());
+        return prefix;
+    }
+
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    RouteModel model{osm_data};
+    std::string socket_path = "/tmp/utest_rp_route_server_" + std::to_string(getpid()) + ".sock";
+    RouteServer server{model, socket_path, 2, 16};
+};
+
+
+// Routes run between the snapped points, and repeated queries on one model
+// give the same answer as a fresh search.
+TEST_F(RouteServerTest, TestRepeatedRouteRequests) {
+    std::string first = server.HandleRequest("ROUTE 10 10 90 90");
+    const std::string prefix = ExpectedPrefix();
+    ASSERT_EQ(first.compare(0, prefix.size() + 1, prefix + " "), 0);
+    EXPECT_EQ(server.HandleRequest("ROUTE 90 90 10 10").compare(0, 3, "OK "), 0);
+    EXPECT_EQ(server.HandleRequest("ROUTE 10 10 90 90"), first);
+    EXPECT_EQ(server.HandleRequest("STATS"), "OK 1 2 0 2");
+}
+
+
+// With search threads, misses go to the parallel search over the road graph,
+// which finds the same shortest route, and are cached too.
+TEST_F(RouteServerTest, TestParallelSearchRequests) {
+    RouteServer parallel{model, socket_path, 2, 16, 4};
+    std::string first = parallel.HandleRequest("ROUTE 10 10 90 90");
+    ASSERT_EQ(first.compare(0, 3, "OK "), 0);
+    EXPECT_NEAR(std::stof(first.substr(3)), std::stof(ExpectedPrefix().substr(3)), 0.01f);
+    EXPECT_EQ(parallel.HandleRequest("ROUTE 10 10 90 90"), first);
+    EXPECT_EQ(parallel.HandleRequest("STATS"), "OK 1 1 0 1");
+}
+
+
+TEST_F(RouteServerTest, TestMalformedRequests) {
+    EXPECT_EQ(server.HandleRequest("ROUTE 10 10"), "ERR expected: ROUTE <start_x> <start_y> <end_x> <end_y>");
+    EXPECT_EQ(server.HandleRequest("FLY 1 2 3 4"), "ERR unknown command");
+}
+
+
+// Requests sent over the socket are answered, and Stop() makes Run() return.
+TEST_F(RouteServerTest, TestSocketRoundTrip) {
+    std::thread runner([&] { server.Run(); });
+
+    int fd = -1;
+    for (int attempt = 0; attempt < 100 && fd < 0; ++attempt) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+            close(fd);
+            fd = -1;
+            usleep(10000);
+        }
+    }
+    ASSERT_GE(fd, 0);
+
+    const std::string requests = "ROUTE 10 10 90 90\nSTATS\n";
+    ASSERT_EQ(write(fd, requests.data(), requests.size()), (ssize_t)requests.size());
+    std::string responses;
+    char chunk[4096];
+    while (std::count(responses.begin(), responses.end(), '\n') < 2) {
+        auto received = read(fd, chunk, sizeof(chunk));
+        ASSERT_GT(received, 0);
+        responses.append(chunk, received);
+    }
+    const std::string prefix = ExpectedPrefix();
+    EXPECT_EQ(responses.compare(0, prefix.size(), prefix), 0);
+    EXPECT_NE(responses.find("\nOK 0 1 0 1\n"), std::string::npos);
+
+    server.Stop();
+    runner.join();
+    close(fd);
+    EXPECT_NE(access(socket_path.c_str(), F_OK), 0);
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/graph_search.h"
+#include "../src/road_graph.h"
+#include "../src/route_model.h"
+#include "../src/segment_index.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning SegmentIndex Tests.
+//--------------------------------//
+
+class SegmentIndexTest : public ::testing::Test {
+  protected:
+    // Distance from (x, y) to the closest point of segment a-b.
+    float SegmentDistance(int a, int b, float x, float y) {
+        const float dx = graph.X(b) - graph.X(a), dy = graph.Y(b) - graph.Y(a);
+        const float length2 = dx * dx + dy * dy;
+        float t = length2 > 0.f ? ((x - graph.X(a)) * dx + (y - graph.Y(a)) * dy) / length2 : 0.f;
+        t = std::fmin(std::fmax(t, 0.f), 1.f);
+        return std::hypot(graph.X(a) + t * dx - x, graph.Y(a) + t * dy - y);
+    }
+
+    float BruteForceDistance(float x, float y) {
+        float best = INFINITY;
+        for (int node = 0; node < graph.NodeCount(); node++) {
+            for (int e = 0; e < graph.Degree(node); e++) {
+                best = std::fmin(best, SegmentDistance(node, graph.Targets(node)[e], x, y));
+            }
+        }
+        return best;
+    }
+
+    float Partial(const SegmentSnap &snap, int node) {
+        return std::hypot(graph.X(node) - snap.x, graph.Y(node) - snap.y);
+    }
+
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    RouteModel model{osm_data};
+    RoadGraph graph{model};
+    SegmentIndex index{graph};
+};
+
+
+// The R-tree finds the same nearest distance as a scan over all segments, and
+// it is never farther than the nearest routable vertex.
+TEST_F(SegmentIndexTest, TestNearestMatchesBruteForce) {
+    EXPECT_EQ(index.SegmentCount() * 2, graph.EdgeCount());
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<float> coordinate{-0.05f, 1.05f};
+    for (int query = 0; query < 300; query++) {
+        const float x = coordinate(rng), y = coordinate(rng);
+        auto snap = index.Nearest(x, y);
+        ASSERT_TRUE(snap.has_value());
+        EXPECT_NEAR(snap->distance, BruteForceDistance(x, y), 1e-6f);
+        EXPECT_NEAR(snap->distance, SegmentDistance(snap->from, snap->to, x, y), 1e-6f);
+        EXPECT_GE(snap->t, 0.f);
+        EXPECT_LE(snap->t, 1.f);
+
+        auto &vertex = model.FindClosestNode(x, y);
+        EXPECT_LE(snap->distance, std::hypot((float)vertex.x - x, (float)vertex.y - y) + 1e-6f);
+    }
+}
+
+
+// A snapped route costs the cheapest combination of partial segment, graph
+// path between segment ends, and partial segment at the goal.
+TEST_F(SegmentIndexTest, TestSnappedPathUsesPartialEdges) {
+    std::mt19937 rng{9};
+    std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+    for (int query = 0; query < 20; query++) {
+        auto start = *index.Nearest(coordinate(rng), coordinate(rng));
+        auto goal = *index.Nearest(coordinate(rng), coordinate(rng));
+        auto path = SnappedShortestPath(graph, start, goal);
+
+        float expected = INFINITY;
+        for (int a : {start.from, start.to}) {
+            for (int b : {goal.from, goal.to}) {
+                auto between = AStarShortestPath(graph, GraphNodeRef{a}, GraphNodeRef{b});
+                if (between.found) {
+                    expected = std::fmin(expected, Partial(start, a) + between.distance + Partial(goal, b));
+                }
+            }
+        }
+        ASSERT_EQ(path.found, expected != INFINITY);
+        if (!path.found) {
+            continue;
+        }
+        EXPECT_NEAR(path.distance, expected, 1e-5f);
+        ASSERT_FALSE(path.nodes.empty());
+        EXPECT_TRUE(path.nodes.front() == start.from || path.nodes.front() == start.to);
+        EXPECT_TRUE(path.nodes.back() == goal.from || path.nodes.back() == goal.to);
+    }
+}
+
+
+// Two points on the same segment are joined directly along it.
+TEST_F(SegmentIndexTest, TestSameSegment) {
+    int node = 0;
+    while (graph.Degree(node) == 0) {
+        node++;
+    }
+    const int to = graph.Targets(node)[0];
+    auto point = [&](float t) {
+        return std::make_pair(graph.X(node) + t * (graph.X(to) - graph.X(node)), graph.Y(node) + t * (graph.Y(to) - graph.Y(node)));
+    };
+    auto [sx, sy] = point(0.25f);
+    auto [gx, gy] = point(0.75f);
+    auto path = SnappedShortestPath(graph, SegmentSnap{node, to, 0.25f, sx, sy, 0.f}, SegmentSnap{to, node, 0.25f, gx, gy, 0.f});
+    ASSERT_TRUE(path.found);
+    EXPECT_NEAR(path.distance, std::hypot(gx - sx, gy - sy), 1e-6f);
+    EXPECT_TRUE(path.nodes.empty());
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "../src/graph_search.h"
+#include "../src/road_graph.h"
+#include "../src/route_model.h"
+#include "../src/route_planner.h"
+#include "../src/tile_store.h"
+
+// Defined in utest_rp_a_star_search.cpp.
+std::vector<std::byte> ReadOSMData(const std::string &path);
+
+//--------------------------------//
+//   Beginning TileStore Tests.
+//--------------------------------//
+
+class TileStoreTest : public ::testing::Test {
+  protected:
+    void SetUp() override { tile_count = WriteTiles(graph, tiles_file, 64); }
+    void TearDown() override { std::remove(tiles_file.c_str()); }
+
+    // Nearest node with at least one road edge, by linear scan.
+    int ClosestRoutable(float x, float y) {
+        int best = -1;
+        float best_distance = 0;
+        for (int node = 0; node < graph.NodeCount(); node++) {
+            const float dx = graph.X(node) - x;
+            const float dy = graph.Y(node) - y;
+            if (graph.Degree(node) > 0 && (best < 0 || dx * dx + dy * dy < best_distance)) {
+                best = node;
+                best_distance = dx * dx + dy * dy;
+            }
+        }
+        return best;
+    }
+
+    std::string osm_data_file = "../map.osm";
+    std::vector<std::byte> osm_data = ReadOSMData(osm_data_file);
+    RouteModel model{osm_data};
+    RoadGraph graph{model};
+    std::string tiles_file = "/tmp/utest_rp_tiles_" + std::to_string(getpid()) + ".tiles";
+    std::size_t tile_count = 0;
+};
+
+
+// The graph search is optimal, so it is never longer than RoutePlanner's route.
+TEST_F(TileStoreTest, TestRoadGraphSearch) {
+    RoutePlanner route_planner{model, 10, 10, 90, 90};
+    route_planner.AStarSearch();
+    auto path = AStarShortestPath(graph, GraphNodeRef{model.path.front().Index()}, GraphNodeRef{model.path.back().Index()});
+    ASSERT_TRUE(path.found);
+    EXPECT_EQ(path.nodes.front(), model.path.front().Index());
+    EXPECT_EQ(path.nodes.back(), model.path.back().Index());
+    EXPECT_LE(path.distance * graph.MetricScale(), route_planner.GetDistance() + 0.01f);
+}
+
+
+// Routes over lazily loaded tiles match the in-memory graph, even when the
+// budget is small enough to force evictions in the middle of a search.
+TEST_F(TileStoreTest, TestTiledRoutesMatchInMemoryGraph) {
+    ASSERT_GT(tile_count, 4);
+    TiledRouteModel tiled{tiles_file, 4096};
+    EXPECT_EQ(tiled.TileCount(), tile_count);
+
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<float> coordinate{0.f, 1.f};
+    for (int query = 0; query < 20; query++) {
+        const float sx = coordinate(rng), sy = coordinate(rng), ex = coordinate(rng), ey = coordinate(rng);
+        GraphNodeRef start = tiled.FindClosestNode(sx, sy);
+        GraphNodeRef end = tiled.FindClosestNode(ex, ey);
+        EXPECT_EQ(start.node, ClosestRoutable(sx, sy));
+        EXPECT_EQ(end.node, ClosestRoutable(ex, ey));
+
+        auto expected = AStarShortestPath(graph, GraphNodeRef{start.node}, GraphNodeRef{end.node});
+        auto actual = tiled.FindPath(start, end);
+        ASSERT_EQ(actual.found, expected.found);
+        EXPECT_FLOAT_EQ(actual.distance, expected.distance);
+    }
+    EXPECT_GT(tiled.GetStats().evictions, 0);
+    EXPECT_LE(tiled.GetStats().resident_tiles, tile_count);
+}
+
+
+TEST_F(TileStoreTest, TestRejectsOtherFiles) {
+    EXPECT_THROW(TiledRouteModel(osm_data_file, 4096), std::runtime_error);
+}
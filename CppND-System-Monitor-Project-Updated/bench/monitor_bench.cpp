@@ -0,0 +1,115 @@
+// Measures the cost of one full refresh of the monitor's data: the system
+// summary plus every field shown for every process. Reports wall time, heap
+// allocations and file syscalls per refresh, against the live /proc or
+// against synthetic trees of the given process counts.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "linux_parser.h"
+#include "process.h"
+#include "synthetic_proc.h"
+#include "syscall_counter.h"
+#include "system.h"
+
+namespace {
+// Incremented from every SamplerPool thread, like the syscall counters.
+std::atomic<std::size_t> allocations{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+// One refresh as NCursesDisplay performs it, showing the busiest `rows`
+// processes. With rows = all the cost scales with the process count.
+std::size_t Refresh(System& system, std::size_t rows) {
+  system.Refresh();
+  std::size_t checksum = 0;
+  checksum += static_cast<std::size_t>(system.Cpu().Utilization() * 100);
+  checksum += static_cast<std::size_t>(system.MemoryUtilization() * 100);
+  checksum += system.TotalProcesses() + system.RunningProcesses();
+  checksum += system.UpTime();
+  const std::vector<Process*>& processes = system.TopProcesses(rows);
+  for (std::size_t i = 0; i < rows && i < processes.size(); ++i) {
+    Process* process = processes[i];
+    checksum += process->Pid() + process->User().size() +
+                process->Command().size() + process->Ram().size() +
+                process->Pss().size() + process->Uss().size() +
+                process->UpTime();
+    checksum += static_cast<std::size_t>(process->CpuUtilization() * 100);
+  }
+  return checksum;
+}
+
+void Measure(const char* label, std::size_t rows, int iterations) {
+  System system;
+  std::size_t checksum = Refresh(system, rows);  // Warm up caches and buffers.
+
+  // Sized up front so timing the loop allocates nothing.
+  std::vector<double> times(iterations);
+  const std::size_t allocations_before =
+      allocations.load(std::memory_order_relaxed);
+  const SyscallCounts syscalls_before = CountedSyscalls();
+  for (int i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    checksum += Refresh(system, rows);
+    times[i] = std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  }
+  const std::size_t allocated =
+      allocations.load(std::memory_order_relaxed) - allocations_before;
+  const SyscallCounts syscalls = CountedSyscalls();
+
+  double total = 0;
+  for (double time : times) total += time;
+  std::sort(times.begin(), times.end());
+  std::printf("%s\n", label);
+  std::printf("  time per refresh:        %.3f ms (median %.3f, p99 %.3f)\n",
+              total / iterations, times[iterations / 2],
+              times[std::min(iterations - 1, iterations * 99 / 100)]);
+  std::printf("  allocations per refresh: %.1f\n",
+              static_cast<double>(allocated) / iterations);
+  auto per_refresh = [&](std::size_t after, std::size_t before) {
+    return static_cast<double>(after - before) / iterations;
+  };
+  std::printf("  syscalls per refresh:    %.1f "
+              "(open %.1f, read %.1f, close %.1f)\n",
+              per_refresh(syscalls.Total(), syscalls_before.Total()),
+              per_refresh(syscalls.opens, syscalls_before.opens),
+              per_refresh(syscalls.reads, syscalls_before.reads),
+              per_refresh(syscalls.closes, syscalls_before.closes));
+  std::printf("  (checksum %zu)\n", checksum);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+  if (argc <= 2) {
+    std::printf("processes: %zu\n", LinuxParser::Pids().size());
+    Measure("all rows:", SIZE_MAX, iterations);
+    Measure("top 10 rows:", 10, iterations);
+    return 0;
+  }
+  for (int i = 2; i < argc; ++i) {
+    const int processes = std::atoi(argv[i]);
+    SyntheticProc proc(processes, 8);
+    LinuxParser::SetProcDirectory(proc.Root());
+    LinuxParser::SetPasswordPath(proc.PasswordPath());
+    std::printf("synthetic processes: %d\n", processes);
+    Measure("all rows:", SIZE_MAX, iterations);
+    Measure("top 10 rows:", 10, iterations);
+  }
+}
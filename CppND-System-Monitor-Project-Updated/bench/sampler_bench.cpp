@@ -0,0 +1,37 @@
+// Measures how the per-pid sampling of System::Refresh() scales with the
+// number of sampler threads, against a synthetic /proc tree so the process
+// count is fixed and reproducible.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linux_parser.h"
+#include "synthetic_proc.h"
+#include "system.h"
+
+int main(int argc, char* argv[]) {
+  const int processes = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+  const int iterations = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  SyntheticProc proc(processes);
+  LinuxParser::SetProcDirectory(proc.Root());
+  LinuxParser::SetPasswordPath(proc.PasswordPath());
+  std::printf("processes: %d, iterations: %d\n", processes, iterations);
+  std::printf("threads  ms/refresh  speedup  sampled\n");
+
+  double serial = 0;
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    System system(threads);
+    system.Refresh();  // Warm up buffers and the process table.
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) system.Refresh();
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count() /
+                      iterations;
+    if (threads == 1) serial = ms;
+    std::printf("%7d  %10.2f  %6.2fx  %7zu\n", threads, ms, serial / ms,
+                system.Processes().size());
+  }
+}
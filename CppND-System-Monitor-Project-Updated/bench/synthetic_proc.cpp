@@ -0,0 +1,306 @@
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "synthetic_proc.h"
+
+namespace {
+void WriteFile(const std::string& path, const std::string& contents) {
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) throw std::runtime_error("cannot write " + path);
+  std::fwrite(contents.data(), 1, contents.size(), file);
+  std::fclose(file);
+}
+
+// Deterministic, so every run of a benchmark samples the same tree.
+class Random {
+ public:
+  std::uint32_t Next() {
+    state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<std::uint32_t>(state_ >> 33);
+  }
+  long Below(long bound) { return static_cast<long>(Next() % bound); }
+
+ private:
+  std::uint64_t state_ = 42;
+};
+
+// A kind of user process. Arguments in `cmdline` are separated by '|',
+// written as NULs; "%d" takes a per-process number.
+struct Kind {
+  const char* comm;
+  const char* cmdline;
+  int uid;
+  long vmSize;  // kB, varied per process.
+};
+
+constexpr Kind kKinds[] = {
+    {"systemd", "/lib/systemd/systemd|--user", 1000, 18000},
+    {"sshd", "sshd: alice [priv]", 0, 17000},
+    {"bash", "-bash", 1000, 9000},
+    {"java",
+     "/usr/lib/jvm/java-17-openjdk-amd64/bin/java|-Xms4g|-Xmx4g|"
+     "-XX:+UseG1GC|-Dlog4j.configurationFile=/etc/app/log4j2.xml|-cp|"
+     "/opt/app/lib/app.jar:/opt/app/lib/guava-32.1.2-jre.jar:"
+     "/opt/app/lib/netty-all-4.1.97.Final.jar:"
+     "/opt/app/lib/jackson-databind-2.15.2.jar|com.example.app.Main|"
+     "--port=%d",
+     1001, 9800000},
+    {"python3",
+     "/usr/bin/python3|-m|gunicorn|--workers|4|--bind|0.0.0.0:%d|"
+     "app.wsgi:application",
+     33, 310000},
+    {"postgres", "postgres: 14/main: app appdb 10.0.0.%d(5432) idle", 70,
+     220000},
+    {"nginx", "nginx: worker process", 33, 56000},
+    {"tmux: server", "tmux|new|-s|work%d", 1000, 12000},
+    {"(sd-pam)", "(sd-pam)", 1000, 170000},
+    // Owned by a uid passwd does not list.
+    {"node", "/usr/bin/node|/srv/web/server.js|--instance=%d", 4242, 1100000},
+};
+
+constexpr const char* kKernelThreads[] = {"kworker/%d:%d-events",
+                                          "ksoftirqd/%d", "migration/%d",
+                                          "kworker/u%d:%d-flush-259:0"};
+
+std::string Status(const char* name, char state, int pid, int ppid, int uid,
+                   long vmSize, long vmRss, int threads) {
+  const char* states[] = {"R (running)", "S (sleeping)",
+                          "D (disk sleep)", "Z (zombie)", "I (idle)"};
+  const char* stateName = state == 'R'   ? states[0]
+                          : state == 'D' ? states[2]
+                          : state == 'Z' ? states[3]
+                          : state == 'I' ? states[4]
+                                         : states[1];
+  char text[2048];
+  int length = std::snprintf(
+      text, sizeof(text),
+      "Name:\t%s\nUmask:\t0022\nState:\t%s\nTgid:\t%d\nNgid:\t0\nPid:\t%d\n"
+      "PPid:\t%d\nTracerPid:\t0\nUid:\t%d\t%d\t%d\t%d\n"
+      "Gid:\t%d\t%d\t%d\t%d\nFDSize:\t64\nGroups:\t%d \nNStgid:\t%d\n"
+      "NSpid:\t%d\nNSpgid:\t%d\nNSsid:\t%d\n",
+      name, stateName, pid, pid, ppid, uid, uid, uid, uid, uid, uid, uid, uid,
+      uid, pid, pid, pid, pid);
+  // Kernel threads and zombies have no memory fields.
+  if (vmSize > 0) {
+    length += std::snprintf(
+        text + length, sizeof(text) - length,
+        "VmPeak:\t%8ld kB\nVmSize:\t%8ld kB\nVmLck:\t       0 kB\n"
+        "VmPin:\t       0 kB\nVmHWM:\t%8ld kB\nVmRSS:\t%8ld kB\n"
+        "RssAnon:\t%8ld kB\nRssFile:\t%8ld kB\nRssShmem:\t       0 kB\n"
+        "VmData:\t%8ld kB\nVmStk:\t     132 kB\nVmExe:\t     884 kB\n"
+        "VmLib:\t    8252 kB\nVmPTE:\t     156 kB\nVmSwap:\t       0 kB\n"
+        "HugetlbPages:\t       0 kB\nCoreDumping:\t0\nTHP_enabled:\t1\n",
+        vmSize + vmSize / 8, vmSize, vmRss + vmRss / 10, vmRss,
+        vmRss * 3 / 4, vmRss / 4, vmSize / 2);
+  }
+  std::snprintf(
+      text + length, sizeof(text) - length,
+      "Threads:\t%d\nSigQ:\t0/63448\nSigPnd:\t0000000000000000\n"
+      "ShdPnd:\t0000000000000000\nSigBlk:\t0000000000000000\n"
+      "SigIgn:\t0000000000001000\nSigCgt:\t0000000188004a02\n"
+      "CapInh:\t0000000000000000\nCapPrm:\t0000000000000000\n"
+      "CapEff:\t0000000000000000\nCapBnd:\t000001ffffffffff\n"
+      "CapAmb:\t0000000000000000\nNoNewPrivs:\t0\nSeccomp:\t0\n"
+      "Seccomp_filters:\t0\nSpeculation_Store_Bypass:\tthread vulnerable\n"
+      "SpeculationIndirectBranch:\tconditional enabled\n"
+      "Cpus_allowed:\tff\nCpus_allowed_list:\t0-7\n"
+      "Mems_allowed:\t00000000,00000001\nMems_allowed_list:\t0\n"
+      "voluntary_ctxt_switches:\t%d\nnonvoluntary_ctxt_switches:\t%d\n",
+      threads, pid * 13 % 100000, pid % 977);
+  return text;
+}
+
+// An smaps_rollup whose figures agree with `vmRss` kB resident.
+std::string SmapsRollup(long vmRss, long shared) {
+  if (vmRss <= 0) return "";  // Nothing mapped: kernel threads, zombies.
+  const long anonymous = vmRss - shared;
+  const long pss = anonymous + shared / 3;
+  char text[1024];
+  std::snprintf(
+      text, sizeof(text),
+      "55d0c0a3e000-7ffd5b1fe000 ---p 00000000 00:00 0"
+      "                          [rollup]\n"
+      "Rss:            %8ld kB\nPss:            %8ld kB\n"
+      "Pss_Dirty:      %8ld kB\nPss_Anon:       %8ld kB\n"
+      "Pss_File:       %8ld kB\nPss_Shmem:             0 kB\n"
+      "Shared_Clean:   %8ld kB\nShared_Dirty:          0 kB\n"
+      "Private_Clean:  %8ld kB\nPrivate_Dirty:  %8ld kB\n"
+      "Referenced:     %8ld kB\nAnonymous:      %8ld kB\n"
+      "KSM:                   0 kB\nLazyFree:              0 kB\n"
+      "AnonHugePages:         0 kB\nShmemPmdMapped:        0 kB\n"
+      "FilePmdMapped:         0 kB\nShared_Hugetlb:        0 kB\n"
+      "Private_Hugetlb:       0 kB\nSwap:                  0 kB\n"
+      "SwapPss:               0 kB\nLocked:                0 kB\n",
+      vmRss, pss, anonymous, anonymous, shared / 3, shared, shared / 10,
+      anonymous, vmRss, anonymous);
+  return text;
+}
+}  // namespace
+
+SyntheticProc::SyntheticProc(int processes, int cores)
+    : processes_(processes) {
+  char directory[] = "/tmp/synthetic-proc-XXXXXX";
+  if (mkdtemp(directory) == nullptr)
+    throw std::runtime_error("cannot create a temporary directory");
+  directory_ = directory;
+  root_ = directory_ + "/proc/";
+  passwd_ = directory_ + "/passwd";
+  mkdir(root_.c_str(), 0755);
+
+  std::string stat = "cpu  " + std::to_string(4705L * cores) + " " +
+                     std::to_string(356L * cores) + " " +
+                     std::to_string(584L * cores) + " " +
+                     std::to_string(3699L * cores) + " 23 23 0 0 0 0\n";
+  for (int core = 0; core < cores; ++core) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "cpu%d %d %d %d %d 5 9 0 0 0 0\n", core,
+                  1393 + core * 37 % 3000, 280 + core % 50,
+                  32 + core * 11 % 600, 1794 + core * 53 % 2000);
+    stat += line;
+  }
+  stat += "intr 114930548 113199788 3 0 5 263 0 4 [...]\n"
+          "ctxt 1990473\n"
+          "btime 1062191376\n"
+          "processes " + std::to_string(processes) + "\n"
+          "procs_running 2\n"
+          "procs_blocked 0\n";
+  WriteFile(root_ + "stat", stat);
+  WriteFile(root_ + "meminfo",
+            "MemTotal:       16318412 kB\n"
+            "MemFree:         8157788 kB\n"
+            "MemAvailable:   12216012 kB\n"
+            "Buffers:          412388 kB\n"
+            "Cached:          3462008 kB\n");
+  WriteFile(root_ + "uptime", "350735.47 234388.90\n");
+  WriteFile(root_ + "version", "Linux version 5.15.0-synthetic (gcc)\n");
+  // A server's devices: idle loop devices, two NVMe disks with partitions,
+  // a device-mapper volume, and bonded interfaces.
+  std::string diskstats;
+  for (int loop = 0; loop < 8; ++loop)
+    diskstats += "   7       " + std::to_string(loop) + " loop" +
+                 std::to_string(loop) +
+                 " 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+  const char* disks[] = {"nvme0n1", "nvme0n1p1", "nvme0n1p2", "nvme1n1",
+                         "nvme1n1p1", "dm-0"};
+  for (int disk = 0; disk < static_cast<int>(std::size(disks)); ++disk) {
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  " 259       %d %s %d 1043 %d 410234 %d 88021 %d 5130992 0 "
+                  "3209841 5540226 0 0 0 0 41022 12931\n",
+                  disk, disks[disk], 4187654 + disk * 977, 219301276 + disk,
+                  13098761 + disk * 31, 1093410477 + disk * 7);
+    diskstats += line;
+  }
+  WriteFile(root_ + "diskstats", diskstats);
+  mkdir((root_ + "net").c_str(), 0755);
+  std::string netdev =
+      "Inter-|   Receive                                                |"
+      "  Transmit\n"
+      " face |bytes    packets errs drop fifo frame compressed multicast|"
+      "bytes    packets errs drop fifo colls carrier compressed\n";
+  const char* interfaces[] = {"lo", "eno1", "eno2", "bond0", "docker0",
+                              "veth3f2a1c9"};
+  for (const char* interface : interfaces) {
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "%6s: 91830284711 71024413    0 1043    0     0          0 "
+                  "   120334 60120344129 52093111    0    0    0     0       "
+                  "0          0\n",
+                  interface);
+    netdev += line;
+  }
+  WriteFile(root_ + "net/dev", netdev);
+  WriteFile(passwd_,
+            "root:x:0:0:root:/root:/bin/bash\n"
+            "daemon:x:1:1:daemon:/usr/sbin:/usr/sbin/nologin\n"
+            "www-data:x:33:33:www-data:/var/www:/usr/sbin/nologin\n"
+            "postgres:x:70:70:PostgreSQL:/var/lib/postgresql:/bin/bash\n"
+            "nobody:x:65534:65534:nobody:/nonexistent:/usr/sbin/nologin\n"
+            "alice:x:1000:1000:Alice,,,:/home/alice:/bin/bash\n"
+            "app:x:1001:1001::/opt/app:/usr/sbin/nologin\n");
+
+  Random random;
+  char comm[64];
+  char text[1024];
+  int pid = 0;
+  for (int i = 0; i < processes; ++i) {
+    // Pids are allocated in order but not densely: exited processes leave
+    // gaps.
+    pid += random.Below(4) == 0 ? 2 + random.Below(30) : 1;
+    const std::string path = root_ + std::to_string(pid);
+    mkdir(path.c_str(), 0755);
+
+    // Roughly one process in seven is a kernel thread.
+    const bool kernel = random.Below(7) == 0;
+    const Kind& kind = kKinds[random.Below(std::size(kKinds))];
+    char state = kernel ? (random.Below(3) == 0 ? 'S' : 'I') : 'S';
+    if (!kernel) {
+      const long roll = random.Below(1000);
+      if (roll < 20) {
+        state = 'R';
+      } else if (roll < 25) {
+        state = 'D';
+      } else if (roll < 28) {
+        state = 'Z';
+      }
+    }
+    if (kernel) {
+      std::snprintf(comm, sizeof(comm),
+                    kKernelThreads[random.Below(std::size(kKernelThreads))],
+                    static_cast<int>(random.Below(std::max(cores, 1))),
+                    static_cast<int>(random.Below(4)));
+      comm[15] = '\0';  // TASK_COMM_LEN.
+    } else {
+      std::snprintf(comm, sizeof(comm), "%s", kind.comm);
+    }
+    const int ppid = kernel ? 2 : 1 + static_cast<int>(random.Below(pid));
+    const int uid = kernel ? 0 : kind.uid;
+    const long vmSize = kernel || state == 'Z'
+                            ? 0
+                            : kind.vmSize / 2 + random.Below(kind.vmSize);
+    const long vmRss = vmSize / (2 + random.Below(6));
+    const int threads = kernel ? 1 : 1 + static_cast<int>(random.Below(64));
+
+    // Most processes are idle; a few have used a lot of CPU.
+    const long busy = random.Below(10) == 0 ? 1000000 : 2000;
+    std::snprintf(text, sizeof(text),
+                  "%d (%s) %c %d %d %d 0 -1 4194560 %ld 0 %ld 0 %ld %ld "
+                  "%ld %ld 20 0 %d 0 %ld %ld %ld 18446744073709551615 1 1 0 "
+                  "0 0 0 0 4096 0 0 0 0 17 %ld 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+                  pid, comm, state, ppid, pid, pid, random.Below(100000),
+                  random.Below(100), random.Below(busy),
+                  random.Below(busy / 4), random.Below(100),
+                  random.Below(100), threads, 100 + random.Below(35000000),
+                  vmSize * 1024, vmRss / 4,
+                  random.Below(std::max(cores, 1)));
+    WriteFile(path + "/stat", text);
+    WriteFile(path + "/status",
+              Status(comm, state, pid, ppid, uid, vmSize, vmRss, threads));
+    // In 4 kB pages: size, resident, shared, text, lib, data, dt.
+    const long shared = vmRss / 4;
+    std::snprintf(text, sizeof(text), "%ld %ld %ld 221 0 %ld 0\n", vmSize / 4,
+                  vmRss / 4, shared / 4, vmSize / 8);
+    WriteFile(path + "/statm", text);
+    WriteFile(path + "/smaps_rollup", SmapsRollup(vmRss, shared));
+
+    std::string cmdline;
+    if (!kernel && state != 'Z') {
+      std::snprintf(text, sizeof(text), kind.cmdline, pid);
+      cmdline = text;
+      std::replace(cmdline.begin(), cmdline.end(), '|', '\0');
+      cmdline += '\0';
+    }
+    WriteFile(path + "/cmdline", cmdline);
+  }
+}
+
+SyntheticProc::~SyntheticProc() {
+  std::error_code ignored;
+  std::filesystem::remove_all(directory_, ignored);
+}
@@ -0,0 +1,40 @@
+#ifndef SYNTHETIC_PROC_H
+#define SYNTHETIC_PROC_H
+
+#include <string>
+
+/*
+A fake /proc tree for benchmarks, written under a fresh temporary directory
+that is removed again on destruction: system-wide stat (with `cores` per-core
+lines), meminfo, uptime, version, diskstats and net/dev, and stat, status,
+statm, smaps_rollup and cmdline for `processes` pids, plus an /etc/passwd
+naming their owners.
+
+The mix follows a busy server: kernel threads with empty command lines and
+no memory fields, long Java and Python command lines, comms with spaces and
+parentheses, a few running, blocked and zombie processes, pids with gaps,
+and a uid missing from passwd. Files are the size and shape of real ones,
+so parsing cost is representative. Contents are deterministic.
+
+Point LinuxParser::SetProcDirectory() at Root() and SetPasswordPath() at
+PasswordPath() to sample it.
+*/
+class SyntheticProc {
+ public:
+  explicit SyntheticProc(int processes, int cores = 2);
+  ~SyntheticProc();
+  SyntheticProc(const SyntheticProc&) = delete;
+  SyntheticProc& operator=(const SyntheticProc&) = delete;
+
+  const std::string& Root() const { return root_; }  // Ends with '/'.
+  const std::string& PasswordPath() const { return passwd_; }
+  int Processes() const { return processes_; }
+
+ private:
+  std::string directory_;  // The temporary directory holding both.
+  std::string root_;
+  std::string passwd_;
+  int processes_;
+};
+
+#endif
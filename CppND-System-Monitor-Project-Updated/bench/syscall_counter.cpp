@@ -0,0 +1,69 @@
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdarg>
+
+#include "syscall_counter.h"
+
+namespace {
+std::atomic<std::size_t> opens{0};
+std::atomic<std::size_t> reads{0};
+std::atomic<std::size_t> closes{0};
+
+template <typename Function>
+Function Next(const char* name) {
+  return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+}  // namespace
+
+SyscallCounts CountedSyscalls() {
+  return {opens.load(), reads.load(), closes.load()};
+}
+
+extern "C" {
+int open(const char* path, int flags, ...) {
+  static auto next = Next<int (*)(const char*, int, ...)>("open");
+  ++opens;
+  mode_t mode = 0;
+  if (flags & (O_CREAT | O_TMPFILE)) {
+    va_list arguments;
+    va_start(arguments, flags);
+    mode = va_arg(arguments, mode_t);
+    va_end(arguments);
+  }
+  return next(path, flags, mode);
+}
+
+ssize_t read(int fd, void* buffer, size_t size) {
+  static auto next = Next<ssize_t (*)(int, void*, size_t)>("read");
+  ++reads;
+  return next(fd, buffer, size);
+}
+
+ssize_t pread(int fd, void* buffer, size_t size, off_t offset) {
+  static auto next = Next<ssize_t (*)(int, void*, size_t, off_t)>("pread");
+  ++reads;
+  return next(fd, buffer, size, offset);
+}
+
+int close(int fd) {
+  static auto next = Next<int (*)(int)>("close");
+  ++closes;
+  return next(fd);
+}
+
+DIR* opendir(const char* path) {
+  static auto next = Next<DIR* (*)(const char*)>("opendir");
+  ++opens;
+  return next(path);
+}
+
+int closedir(DIR* directory) {
+  static auto next = Next<int (*)(DIR*)>("closedir");
+  ++closes;
+  return next(directory);
+}
+}
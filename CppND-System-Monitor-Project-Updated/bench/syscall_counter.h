@@ -0,0 +1,19 @@
+#ifndef SYSCALL_COUNTER_H
+#define SYSCALL_COUNTER_H
+
+#include <cstddef>
+
+// File syscalls made through the libc wrappers since the program started.
+// Linking syscall_counter.cpp interposes open, read, pread, close, opendir and
+// closedir for the whole program; getdents issued by readdir is not seen.
+struct SyscallCounts {
+  std::size_t opens;
+  std::size_t reads;
+  std::size_t closes;
+
+  std::size_t Total() const { return opens + reads + closes; }
+};
+
+SyscallCounts CountedSyscalls();
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CELL_GRID_H
+#define CELL_GRID_H
+
+#include <curses.h>
+#include <string_view>
+#include <vector>
+
+/*
+Retained contents of one window as a grid of cells, each a character with its
+attributes. A frame is composed into the grid with Put(), then Flush() copies
+only the runs of cells that differ from the previous frame to the window.
+Composing never allocates, and a steady screen costs no curses calls at all,
+where erasing and redrawing the window made curses compare every cell of it
+on every refresh.
+*/
+class CellGrid {
+ public:
+  CellGrid(int rows, int columns);
+
+  int Rows() const { return rows_; }
+  int Columns() const { return columns_; }
+
+  // Starts a frame: every cell blank.
+  void Clear();
+  // A line border around the edges, as box(window, 0, 0) draws it.
+  void Box();
+  // Writes `text` from (row, column), clipped short of the right border
+  // column. Returns the column after the last cell written. A cell holds a
+  // single byte, so every UTF-8 encoded character beyond ASCII takes one
+  // cell and shows as '?', as do control characters other than NUL, which
+  // shows as a space; columns stay aligned whatever a command line holds.
+  int Put(int row, int column, std::string_view text,
+          chtype attributes = A_NORMAL);
+  void Put(int row, int column, chtype cell);
+  // The cell at (row, column) of the frame being composed.
+  chtype Cell(int row, int column) const {
+    return next_[row * columns_ + column];
+  }
+
+  // Writes the cells changed since the last Flush() to `window`, one call
+  // per run of changed cells, and stages the window for doupdate().
+  void Flush(WINDOW* window);
+
+ private:
+  chtype& At(int row, int column) { return next_[row * columns_ + column]; }
+
+  int rows_;
+  int columns_;
+  std::vector<chtype> next_;   // The frame being composed.
+  std::vector<chtype> shown_;  // What the window holds; 0 matches nothing.
+};
+
+#endif
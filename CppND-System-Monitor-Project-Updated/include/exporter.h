@@ -0,0 +1,74 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "sampler.h"
+#include "snapshot_log.h"
+
+/*
+Streams DisplaySnapshots to a file as one record per sample, for headless
+runs feeding other tools. Push() only queues the snapshot; encoding and
+writing happen on the exporter's own thread, so a slow disk or pipe never
+delays sampling. If the writer falls more than kMaxPending records behind,
+the oldest queued records are dropped and counted.
+
+Formats:
+  csv     header line, then time_ms, cpu, memory, total and running
+          processes, uptime and one column per core. A new header line
+          precedes the first row after the core count changes.
+  jsonl   one JSON object per line, including the listed processes and
+          the disk and network rates. Process memory is in MB, null if
+          unreadable.
+  binary  a SnapshotLog: varint deltas with periodic keyframes, which
+          --replay can play back. Continues the log if `file` is positioned
+          after existing data.
+*/
+class Exporter {
+ public:
+  enum class Format { kCsv, kJsonLines, kBinary };
+  static constexpr std::size_t kMaxPending = 4096;
+
+  // Writes to `file`, which stays owned by the caller and must stay open
+  // until the exporter is destroyed.
+  Exporter(std::FILE* file, Format format);
+  // Writes out everything queued, then stops the writer thread.
+  ~Exporter();
+  Exporter(const Exporter&) = delete;
+  Exporter& operator=(const Exporter&) = delete;
+
+  void Push(std::shared_ptr<const DisplaySnapshot> snapshot);
+  std::size_t Dropped() const;
+
+  // Parses "csv", "jsonl" or "binary"; false for anything else.
+  static bool ParseFormat(const std::string& name, Format& format);
+
+ private:
+  void Run();
+  void Encode(const DisplaySnapshot& snapshot, std::string& out);
+  void EncodeCsv(const DisplaySnapshot& snapshot, std::string& out);
+  void EncodeJson(const DisplaySnapshot& snapshot, std::string& out);
+
+  std::FILE* const file_;
+  const Format format_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::shared_ptr<const DisplaySnapshot>> pending_;
+  std::size_t dropped_ = 0;
+  bool stop_ = false;
+
+  // Writer thread state.
+  long csvCores_ = -1;  // Cores in the last CSV header, -1 before the first.
+  SnapshotLog::Writer log_;
+
+  std::thread thread_;  // Last, so it starts after everything it uses.
+};
+
+#endif
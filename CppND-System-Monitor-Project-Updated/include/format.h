@@ -1,10 +1,16 @@
 #ifndef FORMAT_H
 #define FORMAT_H
 
+#include <cstddef>
 #include <string>
 
 namespace Format {
 std::string ElapsedTime(long times);  // TODO: See src/format.cpp
+// Writes ElapsedTime(seconds) to `out` without allocating; returns its length.
+int ElapsedTime(long seconds, char* out, std::size_t size);
+// Writes a byte count in at most five characters, scaled by 1024: "512",
+// "1.5K", "23M", "1.2G". Returns its length.
+int Bytes(double bytes, char* out, std::size_t size);
 };                                    // namespace Format
 
 #endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <array>
+#include <cstddef>
+
+// Fixed-capacity ring of the most recent values. Storage is inline, so a
+// ring never allocates and its samples sit in one contiguous block.
+template <typename T, std::size_t Capacity>
+class Ring {
+ public:
+  void Push(T value) {
+    values_[head_] = value;
+    head_ = head_ + 1 == Capacity ? 0 : head_ + 1;
+    if (size_ < Capacity) ++size_;
+  }
+  std::size_t Size() const { return size_; }
+  // i = 0 is the oldest value held, Size() - 1 the newest.
+  T operator[](std::size_t i) const {
+    std::size_t index = head_ + Capacity - size_ + i;
+    if (index >= Capacity) index -= Capacity;
+    return values_[index];
+  }
+  // Copies the newest min(n, Size()) values to `out`, oldest first, and
+  // returns how many were copied.
+  std::size_t Latest(T* out, std::size_t n) const {
+    const std::size_t count = n < size_ ? n : size_;
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = (*this)[size_ - count + i];
+    return count;
+  }
+
+ private:
+  std::array<T, Capacity> values_{};
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+};
+
+/*
+History of one metric in three tiers: every sample, the mean of every 10
+samples and the mean of every 60. At the default one-second sample interval
+that is 24 minutes at 1 s, 4 hours at 10 s and 24 hours at 60 s, in a fixed
+17 KB however long the monitor runs.
+*/
+class MetricHistory {
+ public:
+  static constexpr int kTiers = 3;
+  static constexpr std::size_t kCapacity = 1440;  // Points per tier.
+  // Samples averaged into one point of each tier.
+  static constexpr int kSamplesPerPoint[kTiers] = {1, 10, 60};
+
+  void Add(float value);
+  const Ring<float, kCapacity>& Tier(int tier) const { return tiers_[tier]; }
+
+ private:
+  Ring<float, kCapacity> tiers_[kTiers];
+  // Running sums of the samples not yet folded into the coarser tiers.
+  float pending_[kTiers] = {};
+  int pendingCount_[kTiers] = {};
+};
+
+// The newest points of a history, copied out by value so a published
+// snapshot owns them.
+template <std::size_t Length>
+struct Sparkline {
+  std::array<float, Length> values{};
+  std::size_t size = 0;
+
+  template <std::size_t Capacity>
+  void Assign(const Ring<float, Capacity>& ring) {
+    size = ring.Latest(values.data(), Length);
+  }
+};
+
+#endif
@@ -1,9 +1,14 @@
 #ifndef SYSTEM_PARSER_H
 #define SYSTEM_PARSER_H
 
+#include <array>
 #include <fstream>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "proc_buffer.h"
 
 namespace LinuxParser {
 // Paths
@@ -12,16 +17,31 @@ const std::string kCmdlineFilename{"/cmdline"};
 const std::string kCpuinfoFilename{"/cpuinfo"};
 const std::string kStatusFilename{"/status"};
 const std::string kStatFilename{"/stat"};
+const std::string kStatmFilename{"/statm"};
+const std::string kSmapsRollupFilename{"/smaps_rollup"};
 const std::string kUptimeFilename{"/uptime"};
 const std::string kMeminfoFilename{"/meminfo"};
 const std::string kVersionFilename{"/version"};
+const std::string kDiskstatsFilename{"/diskstats"};
+const std::string kNetDevFilename{"/net/dev"};
 const std::string kOSPath{"/etc/os-release"};
 const std::string kPasswordPath{"/etc/passwd"};
 
+// Directory every /proc path is resolved against: kProcDirectory unless
+// redirected, e.g. to a synthetic tree for benchmarks. Not synchronised, so
+// set it before any sampling starts.
+const std::string& ProcDirectory();
+void SetProcDirectory(const std::string& directory);
+// User names come from kPasswordPath unless redirected the same way. Takes
+// effect for UserTables constructed afterwards.
+const std::string& PasswordPath();
+void SetPasswordPath(const std::string& path);
+
 // System
 float MemoryUtilization();
 long UpTime();
 std::vector<int> Pids();
+void Pids(std::vector<int>& pids);  // Reuses the capacity of `pids`.
 int TotalProcesses();
 int RunningProcesses();
 std::string OperatingSystem();
@@ -41,6 +61,11 @@ enum CPUStates {
   kGuestNice_
 };
 std::vector<std::string> CpuUtilization();
+// The aggregate "cpu" line of /proc/stat, indexed by CPUStates.
+using CpuTimes = std::array<long, kGuestNice_ + 1>;
+bool ReadCpuTimes(CpuTimes& times);
+long ActiveJiffies(const CpuTimes& times);
+long IdleJiffies(const CpuTimes& times);
 long Jiffies();
 long ActiveJiffies();
 long ActiveJiffies(int pid);
@@ -52,6 +77,110 @@ std::string Ram(int pid);
 std::string Uid(int pid);
 std::string User(int pid);
 long int UpTime(int pid);
+
+// Jiffies of every "cpuN" line of /proc/stat as a packed matrix, stored one
+// state after another: the counter for state s of core c is at
+// [s * count + c], so a pass over all cores reads contiguous runs. Cores are
+// indexed by N; offline cores have no line and read as all zero.
+struct CoreTimes {
+  int count{0};
+  std::vector<long> jiffies;
+
+  const long* State(CPUStates state) const {
+    return jiffies.data() + static_cast<std::size_t>(state) * count;
+  }
+};
+
+// Cumulative counters of one whole disk from /proc/diskstats.
+struct DiskCounters {
+  std::string name;
+  unsigned long long reads{0};  // Completed requests.
+  unsigned long long sectors_read{0};  // 512 bytes each, whatever the device.
+  unsigned long long writes{0};
+  unsigned long long sectors_written{0};
+};
+
+// Cumulative traffic of one network interface from /proc/net/dev.
+struct NetCounters {
+  std::string name;
+  unsigned long long rx_bytes{0};
+  unsigned long long tx_bytes{0};
+};
+
+// The system-wide figures shown by the monitor, taken from a single read each
+// of /proc/stat, /proc/meminfo, /proc/uptime, /proc/diskstats and
+// /proc/net/dev so they agree with each other.
+struct SystemSnapshot {
+  CpuTimes cpu{};
+  CoreTimes cores{};
+  int cpu_count{1};  // Number of per-core "cpuN" lines, i.e. online cores.
+  long mem_total{0};  // kB
+  long mem_free{0};   // kB
+  int total_processes{0};
+  int running_processes{0};
+  double uptime{0};  // Seconds.
+  // In file order. Partitions and loop and ram devices are left out, as
+  // their I/O is counted again on the disk below them or is not disk I/O.
+  // Either list is empty where the file cannot be read.
+  std::vector<DiskCounters> disks{};
+  std::vector<NetCounters> interfaces{};
+};
+// The files behind a SystemSnapshot, kept open from one snapshot to the next.
+// Paths are resolved against ProcDirectory() at construction.
+struct SystemFiles {
+  SystemFiles();
+  ProcFile stat;
+  ProcFile meminfo;
+  ProcFile uptime;
+  ProcFile diskstats;
+  ProcFile netdev;
+};
+bool ReadSystemSnapshot(SystemFiles& files, SystemSnapshot& snapshot);
+
+// Fields of /proc/<pid>/stat used by the monitor, times in clock ticks.
+struct PidStat {
+  char state{'?'};
+  long utime{0};
+  long stime{0};
+  long cutime{0};
+  long cstime{0};
+  long long starttime{0};
+};
+bool ReadPidStat(int pid, PidStat& stat);
+bool ParsePidStat(std::string_view text, PidStat& stat);
+
+// Fields of /proc/<pid>/status used by the monitor.
+struct PidStatus {
+  int uid{-1};  // Real uid.
+};
+bool ReadPidStatus(int pid, PidStatus& status);
+bool ParsePidStatus(std::string_view text, PidStatus& status);
+
+// The leading fields of /proc/<pid>/statm, converted from pages to kB. All
+// zero for kernel threads.
+struct PidStatm {
+  long size{0};      // Virtual size.
+  long resident{0};  // RSS.
+  long shared{0};    // Resident and file-backed.
+};
+bool ReadPidStatm(int pid, PidStatm& statm);
+bool ParsePidStatm(std::string_view text, PidStatm& statm);
+
+// Memory attributed to a process by /proc/<pid>/smaps_rollup, in kB. The
+// kernel walks every mapping to produce the file, which costs far more than
+// statm, and only the owner or root may read it; figures stay -1 otherwise.
+struct PidSmaps {
+  long pss{-1};  // Resident pages, each split evenly among its sharers.
+  long uss{-1};  // Resident pages no other process maps.
+};
+bool ReadPidSmaps(int pid, PidSmaps& smaps);
+bool ParsePidSmaps(std::string_view text, PidSmaps& smaps);
+
+// ProcDirectory() + "<pid>/" + file, for handles kept open on a pid's files.
+std::string PidPath(int pid, const char* file);
+// kB as MB with one decimal, as the memory columns show them; "-" if
+// negative, i.e. unknown.
+std::string Ram(long kilobytes);
 };  // namespace LinuxParser
 
 #endif
\ No newline at end of file
@@ -2,15 +2,48 @@
 #define NCURSES_DISPLAY_H
 
 #include <curses.h>
+#include <chrono>
+#include <string>
+#include <vector>
 
-#include "process.h"
+#include "cell_grid.h"
+#include "sampler.h"
+#include "snapshot_log.h"
 #include "system.h"
 
 namespace NCursesDisplay {
-void Display(System& system, int n = 10);
-void DisplaySystem(System& system, WINDOW* window);
-void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n);
+struct Options {
+  int rows{10};  // Processes listed.
+  // How often /proc is sampled, on a background thread.
+  std::chrono::milliseconds sampleInterval{1000};
+  // How often the screen is redrawn from the latest sample and input is
+  // polled; independent of sampling.
+  std::chrono::milliseconds redrawInterval{250};
+};
+
+// Runs until 'q' is pressed. `listener`, if set, also receives every sample,
+// e.g. to record it.
+void Display(System& system, const Options& options = Options(),
+             Sampler::Listener listener = nullptr);
+// Plays a recorded log, which must hold at least one record, at `speed`
+// times real time until 'q' is pressed. Keys pause, seek and change speed.
+void Replay(SnapshotLog::Reader& log, const Options& options, double speed);
+// The Display* functions compose into a window's CellGrid; nothing reaches
+// the terminal until the grid is flushed.
+// Sparklines show history tier `tier` (see MetricHistory).
+void DisplaySystem(const DisplaySnapshot& snapshot, CellGrid& grid,
+                   int tier = 0);
+// Heat strip of per-core utilisation starting at `row` of `grid`.
+void DisplayCores(const std::vector<float>& cores, CellGrid& grid, int row);
+// Rows the heat strip needs for `cores` cores in a window `width` wide.
+int HeatStripRows(int cores, int width);
+// Disk and network rates side by side, the busiest first, as many of each as
+// `grid` has rows for.
+void DisplayDevices(const std::vector<DiskRate>& disks,
+                    const std::vector<NetRate>& interfaces, CellGrid& grid);
+void DisplayProcesses(const std::vector<ProcessRow>& processes, CellGrid& grid,
+                      int n);
 std::string ProgressBar(float percent);
 };  // namespace NCursesDisplay
 
-#endif
\ No newline at end of file
+#endif
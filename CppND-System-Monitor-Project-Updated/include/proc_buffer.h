@@ -0,0 +1,88 @@
+#ifndef PROC_BUFFER_H
+#define PROC_BUFFER_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Reads small pseudo-files such as /proc/stat or /proc/<pid>/status without
+touching the heap once warmed up: the file is read() whole into a buffer that
+is reused by every call and only grows when a file does not fit. Parsers then
+work on string_views into that buffer.
+*/
+class ProcBuffer {
+ public:
+  explicit ProcBuffer(std::size_t capacity = 4096);
+
+  // Returns the contents of `path`, or an empty view if it cannot be read.
+  // The view stays valid until the next Read on this buffer.
+  std::string_view Read(const char* path);
+  // Same for `directory` followed by `file`, e.g. Read("/proc/", "stat").
+  std::string_view Read(std::string_view directory, std::string_view file);
+  // Same for /proc/<pid>/<file>, e.g. ReadPid(42, "stat").
+  std::string_view ReadPid(int pid, const char* file);
+
+ private:
+  std::vector<char> data_;
+};
+
+/*
+A file kept open across reads for files sampled every tick. Read() re-reads
+it from the start with pread() into its own buffer until end of file, so a
+sample costs two syscalls for a file that fits (the second returns 0)
+instead of open/read/read/close. The file is opened on first
+use; when a read fails the descriptor is dropped and the next Read() opens
+the path again.
+*/
+class ProcFile {
+ public:
+  ProcFile() = default;
+  explicit ProcFile(std::string path, std::size_t capacity = 4096);
+  ~ProcFile();
+  ProcFile(ProcFile&& other) noexcept;
+  ProcFile& operator=(ProcFile&& other) noexcept;
+  ProcFile(const ProcFile&) = delete;
+  ProcFile& operator=(const ProcFile&) = delete;
+
+  // The current contents, or an empty view if the file cannot be read. The
+  // view stays valid until the next Read on this file.
+  std::string_view Read();
+  bool HasPath() const { return !path_.empty(); }
+  void Close();
+
+ private:
+  std::string path_;
+  int fd_ = -1;
+  std::vector<char> data_;
+};
+
+// Allocation-free tokenizing helpers for the text returned by ProcBuffer.
+namespace ProcScan {
+// Removes and returns the next whitespace-separated token of `text`.
+std::string_view NextToken(std::string_view& text);
+// Removes and returns the next line of `text`, without its newline.
+std::string_view NextLine(std::string_view& text);
+// Returns the rest of the first line that starts with `key`, or an empty view.
+// Value(meminfo, "MemTotal:") yields "       16318412 kB".
+std::string_view Value(std::string_view text, std::string_view key);
+// Fields of /proc/<pid>/stat after the command name, which may itself hold
+// spaces and parentheses; the first token returned is field 3 (state).
+std::string_view StatFields(std::string_view stat);
+
+// Parses the leading number of `token` after skipping blanks; returns
+// `fallback` if there is none.
+template <typename T>
+T Number(std::string_view token, T fallback = T{}) {
+  while (!token.empty() && (token.front() == ' ' || token.front() == '\t'))
+    token.remove_prefix(1);
+  T value{};
+  auto result =
+      std::from_chars(token.data(), token.data() + token.size(), value);
+  return result.ec == std::errc{} ? value : fallback;
+}
+}  // namespace ProcScan
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+#include <vector>
+
+/*
+Process lifecycle events from the kernel's netlink proc connector, for
+keeping the set of pids up to date without listing /proc every tick.
+
+Fork events of whole processes (not threads, which /proc does not list) add
+to a sorted pid set; exec events are reported so cached command lines can be
+dropped. Exit events are ignored: a zombie, or a process whose leader thread
+exited before its other threads, is still listed in /proc, so a pid leaves
+the set only when the caller fails to read it.
+
+Subscribing needs CAP_NET_ADMIN and a kernel built with CONFIG_PROC_EVENTS.
+Outside the initial user, pid or network namespace the subscription may
+succeed and yet no events arrive, or carry pids this process cannot see, so
+the constructor forks a child and keeps the subscription only if the child's
+fork event arrives with the pid fork() returned. Callers must be ready to
+fall back to listing /proc: check Listening(), and rescan whenever Apply()
+reports lost events.
+*/
+class ProcEvents {
+ public:
+  ProcEvents();
+  ~ProcEvents();
+  ProcEvents(const ProcEvents&) = delete;
+  ProcEvents& operator=(const ProcEvents&) = delete;
+
+  bool Listening() const { return socket_ >= 0; }
+
+  // Adds the pids forked since the last call to `pids`, which must be
+  // sorted and stays so, and lists the pids that called exec in `execs`.
+  // Never blocks. Returns false if the kernel dropped events because they
+  // were not read in time, in which case `pids` may be incomplete.
+  bool Apply(std::vector<int>& pids, std::vector<int>& execs);
+  // Discards pending events, before listing /proc from scratch.
+  void Discard();
+
+  // The merge step of Apply(): adds `forks`, pids in event order, to the
+  // sorted `pids`, which stay sorted and list each pid once. Sorts `forks`;
+  // `merged` is scratch space kept by the caller so merging does not
+  // allocate once it has grown.
+  static void AddForks(std::vector<int>& pids, std::vector<int>& forks,
+                       std::vector<int>& merged);
+
+ private:
+  // Reads every pending message into forks_ and execs. Returns false on
+  // lost events.
+  bool Receive(std::vector<int>* execs);
+  // Whether a child forked now is reported with its pid within
+  // kDeliveryTimeoutMs.
+  bool Delivers();
+  static constexpr int kDeliveryTimeoutMs = 250;
+
+  int socket_ = -1;
+  // Pids forked since the last call; reused per call.
+  std::vector<int> forks_;
+  std::vector<int> merged_;
+};
+
+#endif
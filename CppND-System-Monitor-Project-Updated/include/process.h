@@ -1,29 +1,96 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include <memory>
 #include <string>
+
+#include "history.h"
+#include "linux_parser.h"
+#include "user_table.h"
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
+
+A Process is a record in System's process table and lives for as long as its
+pid does; Update() feeds it one /proc/<pid>/stat sample per tick.
 */
 class Process {
  public:
-  Process(int pid);
-  int Pid();                               // TODO: See src/process.cpp
+  // `users` resolves the owner's name and must outlive the record.
+  Process(int pid, long long starttime, UserTable* users);
+  // Reads this tick's /proc/<pid>/stat, through a descriptor kept open
+  // while the row is on screen. Safe to call for different records
+  // concurrently.
+  bool ReadStat(LinuxParser::PidStat& stat);
+  // `elapsedTicks` is the wall time since the previous sample and `uptime`
+  // the system uptime in seconds, both taken from the same tick.
+  void Update(const LinuxParser::PidStat& stat, long elapsedTicks,
+              double uptime);
+  // Start time in clock ticks after boot. A pid that comes back with another
+  // start time belongs to a different process.
+  long long StartTime() const { return starttime_; }
+  // The process called exec, so its command line, owner and memory figures
+  // must be read again.
+  void Exec();
+  int Pid() const;                         // TODO: See src/process.cpp
   std::string User();                      // TODO: See src/process.cpp
   std::string Command();                   // TODO: See src/process.cpp
   float CpuUtilization();                  // TODO: See src/process.cpp
   std::string Ram();                       // TODO: See src/process.cpp
+  // Proportional and unique set sizes in MB, "-" if unreadable.
+  std::string Pss();
+  std::string Uss();
+  // The same three figures in kB, -1 if unreadable.
+  long RamKb();
+  long PssKb();
+  long UssKb();
   long int UpTime();                       // TODO: See src/process.cpp
+  // Recent samples, kept only while the row is shown: the history starts
+  // when the row appears and is dropped when it leaves the screen.
+  struct History {
+    static constexpr std::size_t kLength = 60;
+    Ring<float, kLength> cpu;  // Fraction of one core.
+  };
+  const History* Tracked() const { return history_.get(); }
   bool operator<(Process const& a) const;  // TODO: See src/process.cpp
   bool operator>(Process const& a) const;
 
   // DONE: Declare any necessary private members
  private:
-	long lastActiveJiffies_ = 0;
-	long lastSystemJiffies_ = 0;
-	int pid_;
-	float cpu_;
+  int pid_;
+  long long starttime_;
+  long lastActiveJiffies_ = -1;  // -1 until the first sample.
+  float cpu_ = 0;
+  long uptime_ = 0;
+  UserTable* users_;
+  // Only displayed rows ask for the figures below, so each read also marks
+  // the record visible and starts its history.
+  void Show();
+  // Each figure is cached with its own age in ticks and read again once it
+  // is older than its limit: statm is a few numbers and read every tick,
+  // the uid rarely changes, and smaps_rollup makes the kernel walk every
+  // mapping of the process.
+  static constexpr int kStatusTicks = 10;
+  static constexpr int kSmapsTicks = 5;
+  const LinuxParser::PidStatm& Statm();
+  const LinuxParser::PidSmaps& Smaps();
+  LinuxParser::PidStatus status_ = {};
+  LinuxParser::PidStatm statm_ = {};
+  LinuxParser::PidSmaps smaps_ = {};
+  int statusAge_ = kStatusTicks;
+  bool statmLoaded_ = false;
+  int smapsAge_ = kSmapsTicks;
+  // Descriptors on the pid's files sampled every tick, held only while the
+  // row stays visible so the number of open files is bounded by the rows
+  // shown.
+  bool visible_ = false;
+  ProcFile statFile_;
+  ProcFile statmFile_;
+  std::unique_ptr<History> history_;
+  // The command line is read the first time it is shown and kept for the
+  // life of the record, or until an exec is reported.
+  std::string command_ = {};
+  bool commandLoaded_ = false;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,14 +1,30 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <vector>
+
+#include "linux_parser.h"
+
 class Processor {
  public:
+  // Folds in a new sample of the aggregate and per-core CPU times.
+  void Update(const LinuxParser::CpuTimes& times,
+              const LinuxParser::CoreTimes& cores);
+  // Busy fraction over the interval between the last two samples.
   float Utilization();  // TODO: See src/processor.cpp
+  // The same per core, indexed by core number.
+  const std::vector<float>& CoreUtilization() const { return cores_; }
 
   // TODO: Declare any necessary private members
  private:
-	long lastActiveJiffies_ = 0;
-	long lastJiffies_ = 0;
+  void UpdateCores(const LinuxParser::CoreTimes& cores);
+
+  long lastActiveJiffies_ = 0;
+  long lastJiffies_ = 0;
+  float utilization_ = 0;
+  std::vector<long> lastCoreActive_;
+  std::vector<long> lastCoreTotal_;
+  std::vector<float> cores_;
 };
 
-#endif
\ No newline at end of file
+#endif
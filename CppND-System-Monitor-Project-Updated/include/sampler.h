@@ -0,0 +1,104 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "history.h"
+#include "system.h"
+#include "throughput.h"
+
+// One row of the process table as displayed.
+struct ProcessRow {
+  int pid;
+  std::string user;
+  float cpu;  // Fraction of one core.
+  // Memory in kB, -1 if unreadable. LinuxParser::Ram() formats them.
+  long ram;  // RSS
+  long pss;
+  long uss;
+  long uptime;  // Seconds.
+  std::string command;
+  Sparkline<8> cpuHistory;
+};
+
+// Everything one frame shows. Published whole and never modified after, so
+// readers may keep one for as long as they like.
+struct DisplaySnapshot {
+  std::chrono::system_clock::time_point time;  // When sampling started.
+  std::string operatingSystem;
+  std::string kernel;
+  float cpu;
+  std::vector<float> cores;  // Utilisation per core, by core number.
+  float memory;
+  int totalProcesses;
+  int runningProcesses;
+  long uptime;
+  std::vector<ProcessRow> processes;  // Busiest first.
+  std::vector<DiskRate> disks;
+  std::vector<NetRate> interfaces;
+  // Newest points of every history tier, for sparklines.
+  static constexpr std::size_t kHistoryLength = 200;
+  std::array<Sparkline<kHistoryLength>, MetricHistory::kTiers> cpuHistory;
+  std::array<Sparkline<kHistoryLength>, MetricHistory::kTiers> memoryHistory;
+};
+
+/*
+Samples a System on a background thread at a fixed interval and publishes
+each result as a new immutable DisplaySnapshot through a triple buffer: the
+sampler fills its own slot and swaps it with the shared middle one, the
+reader swaps its slot with the middle one when that holds something newer.
+Both swaps are a single exchange on an atomic index, so neither side ever
+blocks the other and Latest() never waits for a /proc read in progress.
+*/
+class Sampler {
+ public:
+  // Called on the sampling thread with every snapshot as it is published.
+  // Must return quickly; hand the snapshot to another thread for real work.
+  using Listener =
+      std::function<void(const std::shared_ptr<const DisplaySnapshot>&)>;
+
+  // Samples `system`, which must outlive the sampler, every `interval` and
+  // keeps the `rows` busiest processes of each sample.
+  Sampler(System& system, std::chrono::milliseconds interval, int rows,
+          Listener listener = nullptr);
+  ~Sampler();
+  Sampler(const Sampler&) = delete;
+  Sampler& operator=(const Sampler&) = delete;
+
+  // The most recent sample; null until the first one completes. Must only
+  // be called from one thread at a time: the reader's slot is its own.
+  std::shared_ptr<const DisplaySnapshot> Latest() const;
+
+ private:
+  void Run();
+  std::shared_ptr<const DisplaySnapshot> Sample();
+  void Publish(std::shared_ptr<const DisplaySnapshot> snapshot);
+
+  System& system_;
+  const std::chrono::milliseconds interval_;
+  const int rows_;
+  const Listener listener_;
+  // Triple buffer. `middle_` holds the index of the shared slot, with kFresh
+  // set while it holds a snapshot the reader has not taken yet.
+  static constexpr unsigned kFresh = 4;
+  mutable std::array<std::shared_ptr<const DisplaySnapshot>, 3> slots_;
+  mutable std::atomic<unsigned> middle_{1};
+  unsigned back_ = 0;           // Sampler thread only.
+  mutable unsigned front_ = 2;  // Reader only.
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+  std::thread thread_;  // Last, so it starts after everything it uses.
+};
+
+#endif
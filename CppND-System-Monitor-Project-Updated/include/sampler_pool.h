@@ -0,0 +1,53 @@
+#ifndef SAMPLER_POOL_H
+#define SAMPLER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Fixed pool of threads that fans a loop out and joins it again, for reading
+many /proc/<pid> files at once. The calling thread takes part in every loop,
+so a pool of one thread runs the loop inline without starting any thread.
+Indices are handed out in small chunks from an atomic counter; the only lock
+is taken to start and finish a loop, never per index.
+*/
+class SamplerPool {
+ public:
+  explicit SamplerPool(int threads = DefaultThreads());
+  ~SamplerPool();
+  SamplerPool(const SamplerPool&) = delete;
+  SamplerPool& operator=(const SamplerPool&) = delete;
+
+  // Calls task(i) for every i in [0, count) and returns once all are done.
+  // Tasks for different indices run concurrently and must not share state
+  // other than through their own index.
+  void ForEach(std::size_t count, const std::function<void(std::size_t)>& task);
+
+  int Threads() const { return static_cast<int>(workers_.size()) + 1; }
+  // Hardware concurrency, capped at 4: beyond that the kernel's /proc
+  // locks, not the readers, limit throughput.
+  static int DefaultThreads();
+
+ private:
+  void Work();
+  void RunChunks();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  unsigned long generation_ = 0;  // Bumped for every loop; guarded by mutex_.
+  int busy_ = 0;                  // Workers still inside the current loop.
+  bool stop_ = false;
+
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::size_t count_ = 0;
+  std::atomic<std::size_t> next_{0};
+};
+
+#endif
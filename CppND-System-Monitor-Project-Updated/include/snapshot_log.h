@@ -0,0 +1,135 @@
+#ifndef SNAPSHOT_LOG_H
+#define SNAPSHOT_LOG_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "history.h"
+#include "sampler.h"
+
+/*
+Binary log of DisplaySnapshots for recording a box and replaying it later.
+
+The file starts with "SMON" and a varint format version, followed by
+records of a kind byte, a varint payload length and the payload. A keyframe
+('K') holds every figure in full; a delta ('D') holds only the differences
+from the record before it, as zigzag varints, so a figure that did not move
+costs one byte. Utilisations are stored in units of 1/10000 and process
+memory in kB. Strings (user and command of the process rows) go through a
+table that restarts at every keyframe: the first use writes the text, later
+ones its index. Disk and network rates follow the rows, compared by rank the same
+way, in bytes and tenths of a request per second.
+
+A keyframe is written every kKeyframeInterval records and whenever the
+core count, OS or kernel changes, so a reader can start decoding at any
+keyframe. A log may be appended to by a later run: its first record is a
+keyframe and it writes no second header.
+*/
+namespace SnapshotLog {
+constexpr char kMagic[4] = {'S', 'M', 'O', 'N'};
+constexpr int kVersion = 1;  // The only version Reader accepts.
+constexpr int kKeyframeInterval = 60;
+
+// State both ends of the log track between records.
+struct State {
+  long long time = 0;              // ms since the epoch.
+  std::vector<long long> figures;  // Fixed figures, then one per core.
+  struct Row {
+    long long pid = 0;
+    long long cpu = 0;
+    long long uptime = 0;
+    long long ram = 0;  // kB, like pss and uss.
+    long long pss = 0;
+    long long uss = 0;
+  };
+  std::vector<Row> rows;  // Process rows of the previous record, by rank.
+  // Rates of the previous record by rank: four per disk (read and write
+  // bytes, reads and writes), two per interface (received and sent bytes).
+  std::vector<long long> disks;
+  std::vector<long long> interfaces;
+  std::vector<std::string> strings;  // Table since the last keyframe.
+};
+
+class Writer {
+ public:
+  // `append` continues a log that already has a header.
+  explicit Writer(bool append = false) : headerWritten_(append) {}
+
+  // Appends the encoding of `snapshot` to `out`.
+  void Encode(const DisplaySnapshot& snapshot, std::string& out);
+
+ private:
+  void PutString(const std::string& text, std::string& out);
+
+  bool headerWritten_;
+  int sinceKeyframe_ = kKeyframeInterval;  // The first record is a keyframe.
+  std::string operatingSystem_;
+  std::string kernel_;
+  State state_;
+  std::unordered_map<std::string, std::size_t> stringIds_;
+  std::string payload_;  // Reused for every record.
+};
+
+/*
+Random access to a recorded log. Open() reads the file and indexes every
+record; Snapshot() then decodes forward from the nearest keyframe, or from
+the previous call's record when playing forward, so sequential playback
+decodes one record per frame. Sparklines are rebuilt from the index the way
+MetricHistory would have built them while recording; process rows keep the
+CPU history of the records decoded since they became visible.
+*/
+class Reader {
+ public:
+  // Returns false if the file cannot be read or is not a snapshot log of
+  // kVersion. A truncated last record, e.g. from a crash while writing, is
+  // ignored.
+  bool Open(const std::string& path);
+  // After Open(), even a failed one: the format version of the file, or 0
+  // if it does not start like a snapshot log.
+  int Version() const { return version_; }
+  // After Open(): the length of the header and the complete records, where
+  // a later run appending to the log has to continue.
+  std::size_t End() const { return end_; }
+
+  std::size_t Size() const { return index_.size(); }
+  std::chrono::system_clock::time_point Time(std::size_t record) const;
+  // The last record at or before `time`, or 0 if there is none.
+  std::size_t Find(std::chrono::system_clock::time_point time) const;
+  std::shared_ptr<const DisplaySnapshot> Snapshot(std::size_t record);
+
+ private:
+  struct Entry {
+    std::size_t offset;  // Of the payload.
+    std::size_t length;
+    bool keyframe;
+    long long time;
+  };
+
+  bool Decode(const Entry& entry);
+  template <std::size_t Length>
+  void FillHistory(const std::vector<float>& series, std::size_t record,
+                   int tier, Sparkline<Length>& sparkline) const;
+
+  std::string data_;
+  int version_ = 0;
+  std::size_t end_ = 0;
+  std::vector<Entry> index_;
+  std::vector<std::size_t> keyframes_;  // Record numbers, ascending.
+  // Per-record CPU and memory utilisation, for sparklines.
+  std::vector<float> cpu_;
+  std::vector<float> memory_;
+
+  // Decoder position: the record `current_` was decoded from, or Size().
+  std::size_t position_ = 0;
+  State state_;
+  DisplaySnapshot current_{};
+  std::unordered_map<int, Ring<float, 8>> rowHistory_;
+};
+}  // namespace SnapshotLog
+
+#endif
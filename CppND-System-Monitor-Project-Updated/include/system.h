@@ -1,17 +1,44 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "history.h"
+#include "linux_parser.h"
 #include "process.h"
+#include "proc_events.h"
 #include "processor.h"
+#include "sampler_pool.h"
+#include "throughput.h"
+#include "user_table.h"
 
 class System {
  public:
-  System();
+  // Per-pid files are read by a pool of `samplerThreads` threads. With
+  // `procEvents`, new and exited processes are learnt from the kernel's proc
+  // connector instead of listing /proc every tick, when it is available.
+  explicit System(int samplerThreads = SamplerPool::DefaultThreads(),
+                  bool procEvents = false);
+  // Samples /proc once. Cpu(), MemoryUtilization(), UpTime(), TotalProcesses(),
+  // RunningProcesses() and Io() all report from the latest sample.
+  void Refresh();
+  // Whether pids are tracked through proc connector events.
+  bool TracksProcEvents() const { return events_ != nullptr; }
+  // Every live process, highest CPU utilisation first. The pointers stay
+  // valid until the next Refresh().
+  std::vector<Process*>& Processes();  // TODO: See src/system.cpp
+  // Every live process, of which only the first `n` are guaranteed to be the
+  // busiest in order. Costs O(N + n log n) instead of a full sort.
+  std::vector<Process*>& TopProcesses(std::size_t n);
+  // One point per Refresh(), downsampled into coarser tiers.
+  const MetricHistory& CpuHistory() const { return cpuHistory_; }
+  const MetricHistory& MemoryHistory() const { return memoryHistory_; }
+  const std::vector<MetricHistory>& CoreHistory() const { return coreHistory_; }
   Processor& Cpu();                   // TODO: See src/system.cpp
-  std::vector<Process>& Processes();  // TODO: See src/system.cpp
+  // Disk and network rates over the last interval.
+  const Throughput& Io() const { return io_; }
   float MemoryUtilization();          // TODO: See src/system.cpp
   long UpTime();                      // TODO: See src/system.cpp
   int TotalProcesses();               // TODO: See src/system.cpp
@@ -22,7 +49,45 @@ class System {
   // TODO: Define any necessary private members
  private:
   Processor cpu_ = {};
+  Throughput io_ = {};
+  LinuxParser::SystemFiles files_;
+  LinuxParser::SystemSnapshot snapshot_ = {};
+  MetricHistory cpuHistory_;
+  MetricHistory memoryHistory_;
+  std::vector<MetricHistory> coreHistory_;
+  UserTable users_;
+  std::string kernel_ = {};
+  std::string operatingSystem_ = {};
+  void RecordHistory();
+  void ListPids();
+  void UpdateProcesses(long elapsedTicks);
+
+  // Process table ordered by pid. Records survive from tick to tick and are
+  // merged with a fresh pid listing; `retired_` is the spare table the merge
+  // writes into, so steady-state refreshes do not allocate.
   std::vector<Process> processes_ = {};
+  std::vector<Process> retired_ = {};
+  std::vector<Process*> byCpu_ = {};
+  std::size_t sorted_ = 0;  // Length of the ordered prefix of byCpu_.
+  // Sorted pids of the last tick's records, or of this tick's listing.
+  std::vector<int> pids_ = {};
+  // Proc connector subscription, if enabled and granted. Events keep pids_
+  // current between full listings of /proc, which still run every
+  // kRescanInterval ticks to catch anything the events missed.
+  static constexpr int kRescanInterval = 60;
+  std::unique_ptr<ProcEvents> events_;
+  std::vector<int> execs_ = {};
+  int sinceRescan_ = kRescanInterval;
+  // One slot per entry of pids_, filled in parallel: each worker writes only
+  // the slots of the indices it claimed, so no lock is needed.
+  struct Sample {
+    LinuxParser::PidStat stat;
+    bool ok;
+  };
+  std::vector<Sample> samples_ = {};
+  std::vector<Process*> matches_ = {};  // Existing record per pid, if any.
+  SamplerPool pool_;
+  long lastJiffies_ = 0;
 };
 
 #endif
\ No newline at end of file
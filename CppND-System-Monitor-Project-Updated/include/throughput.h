@@ -0,0 +1,56 @@
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+#include <string>
+#include <vector>
+
+#include "linux_parser.h"
+
+// Transfer rates of one disk over the last interval, per second.
+struct DiskRate {
+  std::string name;
+  float readBytes;
+  float writeBytes;
+  float reads;  // Completed requests.
+  float writes;
+};
+
+// Traffic of one network interface over the last interval, per second.
+struct NetRate {
+  std::string name;
+  float rxBytes;
+  float txBytes;
+};
+
+/*
+Turns the cumulative disk and network counters of successive
+SystemSnapshots into rates. Counters are matched by device name, so devices
+may come and go; one that appears reports nothing until its second sample.
+*/
+class Throughput {
+ public:
+  // Folds in the counters sampled at `uptime` seconds after boot.
+  void Update(const std::vector<LinuxParser::DiskCounters>& disks,
+              const std::vector<LinuxParser::NetCounters>& interfaces,
+              double uptime);
+  // In the order of the counters last passed to Update().
+  const std::vector<DiskRate>& Disks() const { return disks_; }
+  const std::vector<NetRate>& Interfaces() const { return interfaces_; }
+
+ private:
+  void UpdateDisks(const std::vector<LinuxParser::DiskCounters>& disks,
+                   double seconds);
+  void UpdateInterfaces(
+      const std::vector<LinuxParser::NetCounters>& interfaces, double seconds);
+
+  // The first sample has no predecessor, so, as for the CPU, it reports the
+  // average since boot.
+  bool first_ = true;
+  double lastUptime_ = 0;
+  std::vector<LinuxParser::DiskCounters> lastDisks_;
+  std::vector<LinuxParser::NetCounters> lastInterfaces_;
+  std::vector<DiskRate> disks_;
+  std::vector<NetRate> interfaces_;
+};
+
+#endif
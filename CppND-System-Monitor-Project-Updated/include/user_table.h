@@ -0,0 +1,38 @@
+#ifndef USER_TABLE_H
+#define USER_TABLE_H
+
+#include <sys/stat.h>
+#include <string>
+#include <unordered_map>
+
+#include "linux_parser.h"
+
+/*
+uid -> user name map loaded from /etc/passwd, or LinuxParser::PasswordPath()
+if redirected. The file is parsed once and only again when Refresh() sees
+that it was modified or replaced, so resolving a name costs a hash lookup
+instead of a scan of the file.
+*/
+class UserTable {
+ public:
+  explicit UserTable(std::string path = LinuxParser::PasswordPath());
+
+  // Reloads the table if the file changed since the last load. Returns
+  // whether it did.
+  bool Refresh();
+  // Name of `uid`, or the uid in decimal if the file does not list it.
+  const std::string& Name(int uid);
+
+ private:
+  void Load();
+
+  std::string path_;
+  // Identity of the loaded file; an edit changes mtime or size, and tools
+  // that write a new file and rename it over the old one change the inode.
+  struct timespec mtime_ = {};
+  off_t size_ = -1;
+  ino_t inode_ = 0;
+  std::unordered_map<int, std::string> names_;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// LEB128 varints with zigzag mapping for signed values, as used by the
+// monitor's binary formats: small magnitudes, including small negative
+// deltas, take a single byte.
+namespace Varint {
+inline std::uint64_t ZigZag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t UnZigZag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+inline void Put(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline void PutSigned(std::string& out, std::int64_t value) {
+  Put(out, ZigZag(value));
+}
+
+// Decodes one varint from [*cursor, end) and advances *cursor past it.
+// Returns false on truncated or overlong input.
+inline bool Get(const char** cursor, const char* end, std::uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && *cursor < end; shift += 7) {
+    const auto byte = static_cast<unsigned char>(*(*cursor)++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) return true;
+  }
+  return false;
+}
+
+inline bool GetSigned(const char** cursor, const char* end,
+                      std::int64_t& value) {
+  std::uint64_t raw;
+  if (!Get(cursor, end, raw)) return false;
+  value = UnZigZag(raw);
+  return true;
+}
+}  // namespace Varint
+
+#endif
@@ -0,0 +1,78 @@
+#include <curses.h>
+#include <algorithm>
+#include <string_view>
+
+#include "cell_grid.h"
+
+CellGrid::CellGrid(int rows, int columns)
+    : rows_(std::max(rows, 1)),
+      columns_(std::max(columns, 1)),
+      next_(static_cast<std::size_t>(rows_) * columns_, ' '),
+      shown_(next_.size(), 0) {}
+
+void CellGrid::Clear() { std::fill(next_.begin(), next_.end(), ' '); }
+
+void CellGrid::Box() {
+  const int bottom = rows_ - 1;
+  const int right = columns_ - 1;
+  for (int column = 1; column < right; ++column) {
+    At(0, column) = ACS_HLINE;
+    At(bottom, column) = ACS_HLINE;
+  }
+  for (int row = 1; row < bottom; ++row) {
+    At(row, 0) = ACS_VLINE;
+    At(row, right) = ACS_VLINE;
+  }
+  At(0, 0) = ACS_ULCORNER;
+  At(0, right) = ACS_URCORNER;
+  At(bottom, 0) = ACS_LLCORNER;
+  At(bottom, right) = ACS_LRCORNER;
+}
+
+int CellGrid::Put(int row, int column, std::string_view text,
+                  chtype attributes) {
+  if (row < 0 || row >= rows_ || column < 0) return column;
+  const int end = columns_ - 1;
+  int cell = column;
+  for (std::size_t i = 0; i < text.size() && cell < end; ++cell) {
+    unsigned char c = static_cast<unsigned char>(text[i++]);
+    if (c >= 0x80) {
+      // A lead byte takes its continuation bytes along; a stray
+      // continuation byte stands alone.
+      if (c >= 0xc0)
+        while (i < text.size() && (text[i] & 0xc0) == 0x80) ++i;
+      c = '?';
+    } else if (c == '\0') {
+      c = ' ';  // Separates the arguments of /proc/<pid>/cmdline.
+    } else if (c < 0x20 || c == 0x7f) {
+      c = '?';
+    }
+    At(row, cell) = c | attributes;
+  }
+  return std::max(column, cell);
+}
+
+void CellGrid::Put(int row, int column, chtype cell) {
+  if (row < 0 || row >= rows_ || column < 0 || column >= columns_) return;
+  At(row, column) = cell;
+}
+
+void CellGrid::Flush(WINDOW* window) {
+  for (int row = 0; row < rows_; ++row) {
+    const chtype* next = &next_[row * columns_];
+    chtype* shown = &shown_[row * columns_];
+    int column = 0;
+    while (column < columns_) {
+      if (next[column] == shown[column]) {
+        ++column;
+        continue;
+      }
+      int end = column + 1;
+      while (end < columns_ && next[end] != shown[end]) ++end;
+      mvwaddchnstr(window, row, column, next + column, end - column);
+      std::copy(next + column, next + end, shown + column);
+      column = end;
+    }
+  }
+  wnoutrefresh(window);
+}
@@ -0,0 +1,237 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include "exporter.h"
+
+namespace {
+long long Milliseconds(std::chrono::system_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+// Nine significant digits, enough that no float loses precision.
+void AppendNumber(std::string& out, double value) {
+  char text[32];
+  const int length = std::snprintf(text, sizeof(text), "%.9g", value);
+  out.append(text, length);
+}
+
+void AppendInteger(std::string& out, long long value) {
+  char text[24];
+  const int length = std::snprintf(text, sizeof(text), "%lld", value);
+  out.append(text, length);
+}
+
+// kB as MB, or null if unknown.
+void AppendJsonMegabytes(std::string& out, long kilobytes) {
+  if (kilobytes < 0) {
+    out += "null";
+  } else {
+    AppendNumber(out, kilobytes / 1000.0);
+  }
+}
+
+void AppendJsonString(std::string& out, const std::string& text) {
+  out += '"';
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out += escaped;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+}  // namespace
+
+Exporter::Exporter(std::FILE* file, Format format)
+    : file_(file),
+      format_(format),
+      log_(format == Format::kBinary && std::ftell(file) > 0),
+      thread_([this] { Run(); }) {}
+
+Exporter::~Exporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  ready_.notify_one();
+  thread_.join();
+}
+
+bool Exporter::ParseFormat(const std::string& name, Format& format) {
+  if (name == "csv") {
+    format = Format::kCsv;
+  } else if (name == "jsonl") {
+    format = Format::kJsonLines;
+  } else if (name == "binary") {
+    format = Format::kBinary;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void Exporter::Push(std::shared_ptr<const DisplaySnapshot> snapshot) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.size() >= kMaxPending) {
+      pending_.pop_front();
+      ++dropped_;
+    }
+    pending_.push_back(std::move(snapshot));
+  }
+  ready_.notify_one();
+}
+
+std::size_t Exporter::Dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void Exporter::Run() {
+  std::deque<std::shared_ptr<const DisplaySnapshot>> batch;
+  std::string out;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (pending_.empty()) return;  // Stopping and drained.
+      batch.swap(pending_);
+    }
+    // One write per batch; at high rates a batch holds many records.
+    out.clear();
+    for (const auto& snapshot : batch) Encode(*snapshot, out);
+    batch.clear();
+    std::fwrite(out.data(), 1, out.size(), file_);
+    std::fflush(file_);
+  }
+}
+
+void Exporter::Encode(const DisplaySnapshot& snapshot, std::string& out) {
+  switch (format_) {
+    case Format::kCsv:
+      EncodeCsv(snapshot, out);
+      break;
+    case Format::kJsonLines:
+      EncodeJson(snapshot, out);
+      break;
+    case Format::kBinary:
+      log_.Encode(snapshot, out);
+      break;
+  }
+}
+
+void Exporter::EncodeCsv(const DisplaySnapshot& snapshot, std::string& out) {
+  // The columns depend on the core count, so a change starts a new table.
+  if (csvCores_ != static_cast<long>(snapshot.cores.size())) {
+    csvCores_ = static_cast<long>(snapshot.cores.size());
+    out += "time_ms,cpu,memory,total_processes,running_processes,uptime";
+    for (std::size_t core = 0; core < snapshot.cores.size(); ++core) {
+      out += ",cpu";
+      AppendInteger(out, core);
+    }
+    out += '\n';
+  }
+  AppendInteger(out, Milliseconds(snapshot.time));
+  out += ',';
+  AppendNumber(out, snapshot.cpu);
+  out += ',';
+  AppendNumber(out, snapshot.memory);
+  out += ',';
+  AppendInteger(out, snapshot.totalProcesses);
+  out += ',';
+  AppendInteger(out, snapshot.runningProcesses);
+  out += ',';
+  AppendInteger(out, snapshot.uptime);
+  for (float core : snapshot.cores) {
+    out += ',';
+    AppendNumber(out, core);
+  }
+  out += '\n';
+}
+
+void Exporter::EncodeJson(const DisplaySnapshot& snapshot, std::string& out) {
+  out += "{\"time_ms\":";
+  AppendInteger(out, Milliseconds(snapshot.time));
+  out += ",\"cpu\":";
+  AppendNumber(out, snapshot.cpu);
+  out += ",\"memory\":";
+  AppendNumber(out, snapshot.memory);
+  out += ",\"total_processes\":";
+  AppendInteger(out, snapshot.totalProcesses);
+  out += ",\"running_processes\":";
+  AppendInteger(out, snapshot.runningProcesses);
+  out += ",\"uptime\":";
+  AppendInteger(out, snapshot.uptime);
+  out += ",\"cores\":[";
+  for (std::size_t core = 0; core < snapshot.cores.size(); ++core) {
+    if (core > 0) out += ',';
+    AppendNumber(out, snapshot.cores[core]);
+  }
+  out += "],\"processes\":[";
+  for (std::size_t i = 0; i < snapshot.processes.size(); ++i) {
+    const ProcessRow& process = snapshot.processes[i];
+    if (i > 0) out += ',';
+    out += "{\"pid\":";
+    AppendInteger(out, process.pid);
+    out += ",\"user\":";
+    AppendJsonString(out, process.user);
+    out += ",\"cpu\":";
+    AppendNumber(out, process.cpu);
+    out += ",\"rss_mb\":";
+    AppendJsonMegabytes(out, process.ram);
+    out += ",\"pss_mb\":";
+    AppendJsonMegabytes(out, process.pss);
+    out += ",\"uss_mb\":";
+    AppendJsonMegabytes(out, process.uss);
+    out += ",\"uptime\":";
+    AppendInteger(out, process.uptime);
+    out += ",\"command\":";
+    AppendJsonString(out, process.command);
+    out += '}';
+  }
+  out += "],\"disks\":[";
+  for (std::size_t i = 0; i < snapshot.disks.size(); ++i) {
+    const DiskRate& disk = snapshot.disks[i];
+    if (i > 0) out += ',';
+    out += "{\"name\":";
+    AppendJsonString(out, disk.name);
+    out += ",\"read_bps\":";
+    AppendNumber(out, disk.readBytes);
+    out += ",\"write_bps\":";
+    AppendNumber(out, disk.writeBytes);
+    out += ",\"reads\":";
+    AppendNumber(out, disk.reads);
+    out += ",\"writes\":";
+    AppendNumber(out, disk.writes);
+    out += '}';
+  }
+  out += "],\"interfaces\":[";
+  for (std::size_t i = 0; i < snapshot.interfaces.size(); ++i) {
+    const NetRate& interface = snapshot.interfaces[i];
+    if (i > 0) out += ',';
+    out += "{\"name\":";
+    AppendJsonString(out, interface.name);
+    out += ",\"rx_bps\":";
+    AppendNumber(out, interface.rxBytes);
+    out += ",\"tx_bps\":";
+    AppendNumber(out, interface.txBytes);
+    out += '}';
+  }
+  out += "]}\n";
+}
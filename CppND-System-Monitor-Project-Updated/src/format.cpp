@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <string>
 
 #include "format.h"
@@ -13,4 +14,30 @@ string Format::ElapsedTime(long seconds) {
     const long int minutes = (seconds%3600) / 60;
     const long int remainder = (seconds%3600) % 60;
     return std::to_string(hours) + ":" + std::to_string(minutes) + ":" + std::to_string(remainder);
- }
\ No newline at end of file
+ }
+
+int Format::ElapsedTime(long seconds, char* out, std::size_t size) {
+  const int length =
+      std::snprintf(out, size, "%ld:%ld:%ld", seconds / 3600,
+                    (seconds % 3600) / 60, (seconds % 3600) % 60);
+  return length < static_cast<int>(size) ? length : static_cast<int>(size) - 1;
+}
+
+int Format::Bytes(double bytes, char* out, std::size_t size) {
+  constexpr char kUnits[] = "KMGTP";
+  int length;
+  if (bytes < 1000) {
+    length = std::snprintf(out, size, "%.0f", bytes);
+  } else {
+    int unit = 0;
+    bytes /= 1024;
+    while (bytes >= 1000 && unit + 1 < static_cast<int>(sizeof(kUnits)) - 1) {
+      bytes /= 1024;
+      ++unit;
+    }
+    // One decimal while it fits, so "1.5K" but "23M".
+    length = std::snprintf(out, size, bytes < 9.95 ? "%.1f%c" : "%.0f%c",
+                           bytes, kUnits[unit]);
+  }
+  return length < static_cast<int>(size) ? length : static_cast<int>(size) - 1;
+}
@@ -0,0 +1,11 @@
+#include "history.h"
+
+void MetricHistory::Add(float value) {
+  for (int tier = 0; tier < kTiers; ++tier) {
+    pending_[tier] += value;
+    if (++pendingCount_[tier] < kSamplesPerPoint[tier]) continue;
+    tiers_[tier].Push(pending_[tier] / pendingCount_[tier]);
+    pending_[tier] = 0;
+    pendingCount_[tier] = 0;
+  }
+}
@@ -1,318 +1,438 @@
 #include <dirent.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <iomanip>
-#include <numeric>
 
 #include "linux_parser.h"
+#include "proc_buffer.h"
+#include "user_table.h"
 
-using std::stof;
 using std::string;
-using std::to_string;
+using std::string_view;
 using std::vector;
-using std::accumulate;
-using std::stol;
+
+static string& ProcRoot() {
+  static string root = LinuxParser::kProcDirectory;
+  return root;
+}
+
+const string& LinuxParser::ProcDirectory() { return ProcRoot(); }
+
+void LinuxParser::SetProcDirectory(const string& directory) {
+  ProcRoot() = directory.empty() || directory.back() == '/' ? directory
+                                                            : directory + '/';
+}
+
+static string& Passwd() {
+  static string path = LinuxParser::kPasswordPath;
+  return path;
+}
+
+const string& LinuxParser::PasswordPath() { return Passwd(); }
+
+void LinuxParser::SetPasswordPath(const string& path) { Passwd() = path; }
 
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::OperatingSystem() {
-  string line;
-  string key;
-  string value;
-  std::ifstream filestream(kOSPath);
-  if (filestream.is_open()) {
-    while (std::getline(filestream, line)) {
-      std::replace(line.begin(), line.end(), ' ', '_');
-      std::replace(line.begin(), line.end(), '=', ' ');
-      std::replace(line.begin(), line.end(), '"', ' ');
-      std::istringstream linestream(line);
-      while (linestream >> key >> value) {
-        if (key == "PRETTY_NAME") {
-          std::replace(value.begin(), value.end(), '_', ' ');
-          return value;
-        }
-      }
-    }
-  }
-  return value;
+  // Each reader owns its buffer, so views never alias another file.
+  static thread_local ProcBuffer buffer;
+  string_view value =
+      ProcScan::Value(buffer.Read(kOSPath.c_str()), "PRETTY_NAME=");
+  if (!value.empty() && value.front() == '"') value.remove_prefix(1);
+  if (!value.empty() && value.back() == '"') value.remove_suffix(1);
+  return string(value);
 }
 
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::Kernel() {
-  string os, version, kernel;
-  string line;
-  std::ifstream stream(kProcDirectory + kVersionFilename);
-  if (stream.is_open()) {
-    std::getline(stream, line);
-    std::istringstream linestream(line);
-    linestream >> os >> version >> kernel;
-  }
-  return kernel;
+  static thread_local ProcBuffer buffer;
+  string_view text = buffer.Read(ProcDirectory(), kVersionFilename);
+  ProcScan::NextToken(text);  // "Linux"
+  ProcScan::NextToken(text);  // "version"
+  return string(ProcScan::NextToken(text));
 }
 
 // BONUS: Update this to use std::filesystem
 vector<int> LinuxParser::Pids() {
   vector<int> pids;
-  DIR* directory = opendir(kProcDirectory.c_str());
+  Pids(pids);
+  return pids;
+}
+
+void LinuxParser::Pids(vector<int>& pids) {
+  pids.clear();
+  DIR* directory = opendir(ProcDirectory().c_str());
+  if (directory == nullptr) return;
   struct dirent* file;
   while ((file = readdir(directory)) != nullptr) {
-    // Is this a directory?
-    if (file->d_type == DT_DIR) {
-      // Is every character of the name a digit?
-      string filename(file->d_name);
-      if (std::all_of(filename.begin(), filename.end(), isdigit)) {
-        int pid = stoi(filename);
-        pids.push_back(pid);
-      }
-    }
+    if (file->d_type != DT_DIR) continue;
+    // Only directories whose whole name is a number are processes.
+    const char* name = file->d_name;
+    const char* end = name + std::strlen(name);
+    int pid = 0;
+    auto result = std::from_chars(name, end, pid);
+    if (result.ec == std::errc{} && result.ptr == end) pids.push_back(pid);
   }
   closedir(directory);
-  return pids;
 }
 
 // DONE: Read and return the system memory utilization
-float LinuxParser::MemoryUtilization() { 
-	float totalMem = 0;
-    float freeMem = 0;
-  	string line;
-  	string key;
-    string value;
-    std::ifstream fileStream(kProcDirectory + kMeminfoFilename);
-    if (fileStream.is_open()) {
-        while (std::getline(fileStream, line)) {
-            std::istringstream lineStream(line);
-            lineStream >> key >> value;
-            if (key == "MemTotal:") {
-                totalMem = stof(value);
-            } else if (key == "MemFree:") {
-                freeMem = stof(value);
-            }
-        }
-    }
-  	return (totalMem-freeMem)/totalMem;
+float LinuxParser::MemoryUtilization() {
+  static thread_local ProcBuffer buffer;
+  const string_view meminfo = buffer.Read(ProcDirectory(), kMeminfoFilename);
+  const float total =
+      ProcScan::Number<float>(ProcScan::Value(meminfo, "MemTotal:"));
+  const float free =
+      ProcScan::Number<float>(ProcScan::Value(meminfo, "MemFree:"));
+  return total > 0 ? (total - free) / total : 0;
 }
 
 // DONE: Read and return the system uptime
 long LinuxParser::UpTime() {
-  	string line;
-  	long upTime = 0;
-    std::ifstream stream(kProcDirectory + kUptimeFilename);    
-    if (stream.is_open()) {
-        std::getline(stream, line);
-        std::istringstream lineStream(line);
-        lineStream >> upTime;        
-    }
-    return upTime;
+  static thread_local ProcBuffer buffer;
+  string_view text = buffer.Read(ProcDirectory(), kUptimeFilename);
+  return static_cast<long>(
+      ProcScan::Number<double>(ProcScan::NextToken(text)));
 }
 
 // DONE: Read and return the number of jiffies for the system
-long LinuxParser::Jiffies() { 
-	return LinuxParser::ActiveJiffies() + LinuxParser::IdleJiffies();
+long LinuxParser::Jiffies() {
+  return LinuxParser::ActiveJiffies() + LinuxParser::IdleJiffies();
+}
+
+bool LinuxParser::ReadPidStat(int pid, PidStat& stat) {
+  static thread_local ProcBuffer buffer;
+  return ParsePidStat(buffer.ReadPid(pid, kStatFilename.c_str() + 1), stat);
+}
+
+bool LinuxParser::ParsePidStat(string_view text, PidStat& stat) {
+  string_view fields = ProcScan::StatFields(text);
+  if (fields.empty()) return false;
+  // Tokens are numbered from field 3 (state); see proc(5).
+  const string_view state = ProcScan::NextToken(fields);
+  if (state.empty()) return false;
+  stat.state = state.front();
+  for (int field = 4; field < 14; ++field) ProcScan::NextToken(fields);
+  stat.utime = ProcScan::Number<long>(ProcScan::NextToken(fields));
+  stat.stime = ProcScan::Number<long>(ProcScan::NextToken(fields));
+  stat.cutime = ProcScan::Number<long>(ProcScan::NextToken(fields));
+  stat.cstime = ProcScan::Number<long>(ProcScan::NextToken(fields));
+  for (int field = 18; field < 22; ++field) ProcScan::NextToken(fields);
+  stat.starttime = ProcScan::Number<long long>(ProcScan::NextToken(fields));
+  return true;
 }
 
 // DONE: Read and return the number of active jiffies for a PID
-// REMOVE: [[maybe_unused]] once you define the function
-long LinuxParser::ActiveJiffies(int pid) { 
-  	string notNecessary;
-  	string line;
-  	long uTime = 0;
-    long sTime = 0; 
-  	long cuTime = 0;
-  	long csTime = 0;
-  	std::ifstream fileStream(kProcDirectory + to_string(pid) + kStatFilename);
-  	if (fileStream.is_open()) {
-    	std::getline(fileStream, line);
-    	std::istringstream lineStream(line);
-      	// 13 useless valus
-    	for (int idx = 0; idx < 13; idx++) {
-          lineStream >> notNecessary;
-        }
-
-    	lineStream >> uTime >> sTime >> cuTime >> csTime;
-  	}
-  	return uTime + sTime + cuTime + csTime;
+long LinuxParser::ActiveJiffies(int pid) {
+  PidStat stat;
+  if (!ReadPidStat(pid, stat)) return 0;
+  return stat.utime + stat.stime + stat.cutime + stat.cstime;
 }
 
-// DONE: Read and return the number of active jiffies for the system
-long LinuxParser::ActiveJiffies() { 
-	vector<string> cpuUtilization = LinuxParser::CpuUtilization();
-  	long user = stol(cpuUtilization[CPUStates::kUser_]);
-    long nice = stol(cpuUtilization[CPUStates::kNice_]);
-    long system = stol(cpuUtilization[CPUStates::kSystem_]);
-    long irq = stol(cpuUtilization[CPUStates::kIRQ_]);
-    long softIrq = stol(cpuUtilization[CPUStates::kSoftIRQ_]);
-    long steal = stol(cpuUtilization[CPUStates::kSteal_]);
+// Parses the aggregate "cpu" line out of the text of /proc/stat.
+static bool ParseCpuTimes(string_view stat, LinuxParser::CpuTimes& times) {
+  string_view line = ProcScan::Value(stat, "cpu ");
+  if (line.empty()) return false;
+  for (long& time : times)
+    time = ProcScan::Number<long>(ProcScan::NextToken(line));
+  return true;
+}
+
+// Fills `cores` from the "cpuN" lines that follow the aggregate line of
+// /proc/stat and sets `online` to their number. Reallocates only when the
+// highest core number changes.
+static bool ParseCoreTimes(string_view stat, LinuxParser::CoreTimes& cores,
+                           int& online) {
+  constexpr int kStates = LinuxParser::kGuestNice_ + 1;
+  ProcScan::NextLine(stat);  // The aggregate "cpu " line.
+  // Core lines are consecutive; sizing needs the highest N first.
+  int highest = -1;
+  online = 0;
+  for (string_view lines = stat; !lines.empty();) {
+    string_view line = ProcScan::NextLine(lines);
+    if (line.substr(0, 3) != "cpu") break;
+    line.remove_prefix(3);
+    highest = std::max(highest, ProcScan::Number<int>(line, -1));
+    ++online;
+  }
+  if (online == 0) return false;
+  if (cores.count != highest + 1) {
+    cores.count = highest + 1;
+    cores.jiffies.assign(static_cast<std::size_t>(kStates) * cores.count, 0);
+  }
+  for (int i = 0; i < online; ++i) {
+    string_view line = ProcScan::NextLine(stat);
+    line.remove_prefix(3);
+    const int core = ProcScan::Number<int>(ProcScan::NextToken(line));
+    for (int state = 0; state < kStates; ++state)
+      cores.jiffies[static_cast<std::size_t>(state) * cores.count + core] =
+          ProcScan::Number<long>(ProcScan::NextToken(line));
+  }
+  return true;
+}
+
+bool LinuxParser::ReadCpuTimes(CpuTimes& times) {
+  static thread_local ProcBuffer buffer;
+  return ParseCpuTimes(buffer.Read(ProcDirectory(), kStatFilename),
+                       times);
+}
 
-	return user + nice + system + irq + softIrq + steal;
+long LinuxParser::ActiveJiffies(const CpuTimes& times) {
+  return times[kUser_] + times[kNice_] + times[kSystem_] + times[kIRQ_] +
+         times[kSoftIRQ_] + times[kSteal_];
+}
+
+long LinuxParser::IdleJiffies(const CpuTimes& times) {
+  return times[kIdle_] + times[kIOwait_];
+}
+
+// DONE: Read and return the number of active jiffies for the system
+long LinuxParser::ActiveJiffies() {
+  CpuTimes times{};
+  ReadCpuTimes(times);
+  return ActiveJiffies(times);
 }
 
 // DONE: Read and return the number of idle jiffies for the system
-long LinuxParser::IdleJiffies() { 
-	vector<string> cpuUtilization = LinuxParser::CpuUtilization();
-	long idle = stol(cpuUtilization[CPUStates::kIdle_]);
-  	long iowait = stol(cpuUtilization[CPUStates::kIOwait_]);
+long LinuxParser::IdleJiffies() {
+  CpuTimes times{};
+  ReadCpuTimes(times);
+  return IdleJiffies(times);
+}
+
+// Whether `name` is a partition of the disk `disk`: "sda1" of "sda", or
+// "nvme0n1p1" of "nvme0n1", since a 'p' separates the partition number when
+// the disk name ends in a digit.
+static bool IsPartition(string_view name, string_view disk) {
+  if (disk.empty() || name.size() <= disk.size() ||
+      name.substr(0, disk.size()) != disk)
+    return false;
+  name.remove_prefix(disk.size());
+  if (std::isdigit(static_cast<unsigned char>(disk.back())) &&
+      name.front() == 'p')
+    name.remove_prefix(1);
+  return !name.empty() &&
+         std::all_of(name.begin(), name.end(), [](char c) {
+           return std::isdigit(static_cast<unsigned char>(c));
+         });
+}
+
+// Fills `disks` from the text of /proc/diskstats, reusing its entries.
+// Partitions are listed right after their disk.
+static void ParseDiskstats(string_view text,
+                           vector<LinuxParser::DiskCounters>& disks) {
+  std::size_t count = 0;
+  string_view disk;  // The last device that was not a partition.
+  while (!text.empty()) {
+    string_view line = ProcScan::NextLine(text);
+    ProcScan::NextToken(line);  // Major number.
+    ProcScan::NextToken(line);  // Minor number.
+    const string_view name = ProcScan::NextToken(line);
+    if (name.empty() || IsPartition(name, disk)) continue;
+    disk = name;
+    if (name.substr(0, 4) == "loop" || name.substr(0, 3) == "ram") continue;
+    // Reads, reads merged, sectors read, ms reading, writes, writes merged,
+    // sectors written; see Documentation/admin-guide/iostats.rst.
+    unsigned long long fields[7];
+    for (unsigned long long& field : fields)
+      field = ProcScan::Number<unsigned long long>(ProcScan::NextToken(line));
+    if (count == disks.size()) disks.emplace_back();
+    LinuxParser::DiskCounters& counters = disks[count++];
+    counters.name.assign(name.data(), name.size());
+    counters.reads = fields[0];
+    counters.sectors_read = fields[2];
+    counters.writes = fields[4];
+    counters.sectors_written = fields[6];
+  }
+  disks.resize(count);
+}
+
+// Fills `interfaces` from the text of /proc/net/dev, reusing its entries.
+static void ParseNetDev(string_view text,
+                        vector<LinuxParser::NetCounters>& interfaces) {
+  std::size_t count = 0;
+  ProcScan::NextLine(text);  // Two lines of column headings.
+  ProcScan::NextLine(text);
+  while (!text.empty()) {
+    string_view line = ProcScan::NextLine(text);
+    // "  eth0: 930 13 ..."; old kernels leave no blank after the colon.
+    const std::size_t colon = line.find(':');
+    if (colon == string_view::npos) continue;
+    string_view name = line.substr(0, colon);
+    name.remove_prefix(std::min(name.find_first_not_of(' '), name.size()));
+    line.remove_prefix(colon + 1);
+    if (count == interfaces.size()) interfaces.emplace_back();
+    LinuxParser::NetCounters& counters = interfaces[count++];
+    counters.name.assign(name.data(), name.size());
+    counters.rx_bytes =
+        ProcScan::Number<unsigned long long>(ProcScan::NextToken(line));
+    // Received packets, errs, drop, fifo, frame, compressed, multicast.
+    for (int field = 0; field < 7; ++field) ProcScan::NextToken(line);
+    counters.tx_bytes =
+        ProcScan::Number<unsigned long long>(ProcScan::NextToken(line));
+  }
+  interfaces.resize(count);
+}
+
+LinuxParser::SystemFiles::SystemFiles()
+    : stat(ProcDirectory() + kStatFilename),
+      meminfo(ProcDirectory() + kMeminfoFilename),
+      uptime(ProcDirectory() + kUptimeFilename),
+      diskstats(ProcDirectory() + kDiskstatsFilename),
+      netdev(ProcDirectory() + kNetDevFilename) {}
+
+bool LinuxParser::ReadSystemSnapshot(SystemFiles& files,
+                                     SystemSnapshot& snapshot) {
+  const string_view stat = files.stat.Read();
+  if (!ParseCpuTimes(stat, snapshot.cpu)) return false;
+  if (!ParseCoreTimes(stat, snapshot.cores, snapshot.cpu_count)) return false;
+  snapshot.total_processes =
+      ProcScan::Number<int>(ProcScan::Value(stat, "processes "));
+  snapshot.running_processes =
+      ProcScan::Number<int>(ProcScan::Value(stat, "procs_running "));
 
-  	return idle + iowait;
+  const string_view meminfo = files.meminfo.Read();
+  snapshot.mem_total =
+      ProcScan::Number<long>(ProcScan::Value(meminfo, "MemTotal:"));
+  snapshot.mem_free =
+      ProcScan::Number<long>(ProcScan::Value(meminfo, "MemFree:"));
+
+  string_view uptime = files.uptime.Read();
+  snapshot.uptime = ProcScan::Number<double>(ProcScan::NextToken(uptime));
+
+  ParseDiskstats(files.diskstats.Read(), snapshot.disks);
+  ParseNetDev(files.netdev.Read(), snapshot.interfaces);
+  return true;
 }
 
 // DONE: Read and return CPU utilization
-vector<string> LinuxParser::CpuUtilization() { 
-	vector<string> cpuUtilization;
-	string line;
-	string typeOfData;
-  
-	std::ifstream fileStream(kProcDirectory + kStatFilename);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::istringstream lineStream(line);
-			while (lineStream >> typeOfData) {
-				if (typeOfData == "cpu") {
-					while (lineStream >> typeOfData) {
-                      cpuUtilization.push_back(typeOfData);
-                    }
-                  	return cpuUtilization;
-				}
-			}
-		}
-	}
-	return cpuUtilization;
+vector<string> LinuxParser::CpuUtilization() {
+  vector<string> cpuUtilization;
+  CpuTimes times{};
+  if (ReadCpuTimes(times))
+    for (long time : times) cpuUtilization.push_back(std::to_string(time));
+  return cpuUtilization;
 }
 
 // DONE: Read and return the total number of processes
-int LinuxParser::TotalProcesses() { 
-	string line;
-	string key;
-	int value = 0;
-	int totalProcs = 0;
-	std::ifstream fileStream(kProcDirectory + kStatFilename);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::istringstream lineStream(line);
-			while (lineStream >> key >> value) {
-				if (key == "processes") {
-					totalProcs = value;
-					break;
-				}
-			}
-		}
-	}
-	return totalProcs;
+int LinuxParser::TotalProcesses() {
+  static thread_local ProcBuffer buffer;
+  return ProcScan::Number<int>(ProcScan::Value(
+      buffer.Read(ProcDirectory(), kStatFilename), "processes "));
 }
 
 // DONE: Read and return the number of running processes
-int LinuxParser::RunningProcesses() { 
-	int runningProc = 0;
-	int value = 0;
-	string line; 
-	string key;
-	std::ifstream fileStream(kProcDirectory + kStatFilename);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::istringstream lineStream(line);
-			while (lineStream >> key >> value) {
-				if (key == "procs_running") {
-					runningProc = value;
-					break;
-				}
-			}
-		}
-	}
-	return runningProc;
+int LinuxParser::RunningProcesses() {
+  static thread_local ProcBuffer buffer;
+  return ProcScan::Number<int>(ProcScan::Value(
+      buffer.Read(ProcDirectory(), kStatFilename), "procs_running "));
 }
 
 // DONE: Read and return the command associated with a process
-// REMOVE: [[maybe_unused]] once you define the function
-string LinuxParser::Command(int pid) { 
-	string line;
-	std::ifstream fileStream(kProcDirectory + to_string(pid) + kCmdlineFilename);
-	if (fileStream.is_open()) {
-		std::getline(fileStream, line);
-		if (line != "") {
-			return line;
-		}
-	}
-	return "None";
+string LinuxParser::Command(int pid) {
+  static thread_local ProcBuffer buffer;
+  string_view cmdline = buffer.ReadPid(pid, kCmdlineFilename.c_str() + 1);
+  cmdline = cmdline.substr(0, cmdline.find('\n'));
+  return cmdline.empty() ? "None" : string(cmdline);
+}
+
+bool LinuxParser::ReadPidStatus(int pid, PidStatus& status) {
+  static thread_local ProcBuffer buffer;
+  return ParsePidStatus(buffer.ReadPid(pid, kStatusFilename.c_str() + 1),
+                        status);
+}
+
+bool LinuxParser::ParsePidStatus(string_view text, PidStatus& status) {
+  if (text.empty()) return false;
+  string_view uid = ProcScan::Value(text, "Uid:");
+  status.uid = ProcScan::Number<int>(ProcScan::NextToken(uid), -1);
+  return true;
+}
+
+bool LinuxParser::ReadPidStatm(int pid, PidStatm& statm) {
+  static thread_local ProcBuffer buffer(256);
+  return ParsePidStatm(buffer.ReadPid(pid, kStatmFilename.c_str() + 1),
+                       statm);
+}
+
+bool LinuxParser::ParsePidStatm(string_view text, PidStatm& statm) {
+  static const long pageKilobytes = sysconf(_SC_PAGESIZE) / 1024;
+  // Seven numbers separated by single spaces; the first three are needed.
+  const char* cursor = text.data();
+  const char* const end = cursor + text.size();
+  long pages[3];
+  for (long& field : pages) {
+    const auto result = std::from_chars(cursor, end, field);
+    if (result.ec != std::errc{}) return false;
+    cursor = result.ptr == end ? end : result.ptr + 1;
+  }
+  statm.size = pages[0] * pageKilobytes;
+  statm.resident = pages[1] * pageKilobytes;
+  statm.shared = pages[2] * pageKilobytes;
+  return true;
+}
+
+bool LinuxParser::ReadPidSmaps(int pid, PidSmaps& smaps) {
+  static thread_local ProcBuffer buffer(2048);
+  return ParsePidSmaps(
+      buffer.ReadPid(pid, kSmapsRollupFilename.c_str() + 1), smaps);
+}
+
+bool LinuxParser::ParsePidSmaps(string_view text, PidSmaps& smaps) {
+  const long pss = ProcScan::Number<long>(ProcScan::Value(text, "Pss:"), -1);
+  if (pss < 0) return false;
+  smaps.pss = pss;
+  smaps.uss =
+      ProcScan::Number<long>(ProcScan::Value(text, "Private_Clean:")) +
+      ProcScan::Number<long>(ProcScan::Value(text, "Private_Dirty:"));
+  return true;
+}
+
+string LinuxParser::PidPath(int pid, const char* file) {
+  return ProcDirectory() + std::to_string(pid) + '/' + file;
+}
+
+string LinuxParser::Ram(long kilobytes) {
+  if (kilobytes < 0) return "-";
+  if (kilobytes == 0) return "0";
+  char megabytes[32];
+  std::snprintf(megabytes, sizeof(megabytes), "%.1f",
+                static_cast<float>(kilobytes) / 1000);
+  return megabytes;
 }
 
 // DONE: Read and return the memory used by a process
-// REMOVE: [[maybe_unused]] once you define the function
-string LinuxParser::Ram(int pid) { 
-	string line;
-	string key;
-	string value;
-
-	std::stringstream ramStream;
-
-	std::ifstream fileStream(kProcDirectory + to_string(pid) + kStatusFilename);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::istringstream lineStream(line);
-			lineStream >> key >> value;
-			if (key == "VmSize:") {
-				ramStream << std::fixed << std::setprecision(1) << stof(value) / 1000;
-				return ramStream.str();
-			}
-		}
-	}
-	return "0";
+string LinuxParser::Ram(int pid) {
+  PidStatm statm;
+  ReadPidStatm(pid, statm);
+  return Ram(statm.resident);
 }
 
 // DONE: Read and return the user ID associated with a process
-// REMOVE: [[maybe_unused]] once you define the function
 string LinuxParser::Uid(int pid) {
-	string line;
-	string key;
-	string value;
-
-	std::ifstream fileStream(kProcDirectory + to_string(pid) + kStatusFilename);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::istringstream lineStream(line);
-			lineStream >> key >> value;
-			if (key == "Uid:") {
-				return value;
-			}
-		}
-	}
-	return "0";
+  PidStatus status;
+  if (!ReadPidStatus(pid, status) || status.uid < 0) return "0";
+  return std::to_string(status.uid);
 }
 
 // DONE: Read and return the user associated with a process
-// REMOVE: [[maybe_unused]] once you define the function
-string LinuxParser::User(int pid) { 
-	string uid;
-	string line;
-	string username;
-	string password;
-	std::ifstream fileStream(kPasswordPath);
-	if (fileStream.is_open()) {
-		while (std::getline(fileStream, line)) {
-			std::replace(line.begin(), line.end(), ':', ' ');
-			std::istringstream lineStream(line);
-			lineStream >> username >> password >> uid;
-			if (uid == LinuxParser::Uid(pid)) {
-				return username;
-			}
-		}
-	}
-	return username;
+string LinuxParser::User(int pid) {
+  static thread_local UserTable users;
+  users.Refresh();
+  PidStatus status;
+  if (!ReadPidStatus(pid, status) || status.uid < 0) return string();
+  return users.Name(status.uid);
 }
 
 // DONE: Read and return the uptime of a process
-// REMOVE: [[maybe_unused]] once you define the function
 long LinuxParser::UpTime(int pid) {
-	long startTime;
-	string line; 
-	string notNecessary;
-	std::ifstream fileStream(kProcDirectory + to_string(pid) + kStatFilename);
-	if (fileStream.is_open()) {
-		std::getline(fileStream, line);
-		std::istringstream lineStream(line);
-		for (int i = 0; i < 21; i++) {
-			lineStream >> notNecessary;
-		}
-		lineStream >> startTime;
-		return LinuxParser::UpTime() - startTime / sysconf(_SC_CLK_TCK);
-	}
-	return 0;
+  PidStat stat;
+  if (!ReadPidStat(pid, stat)) return 0;
+  return LinuxParser::UpTime() - stat.starttime / sysconf(_SC_CLK_TCK);
 }
@@ -1,7 +1,261 @@
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "exporter.h"
 #include "ncurses_display.h"
+#include "sampler.h"
+#include "snapshot_log.h"
 #include "system.h"
 
-int main() {
-  System system;
-  NCursesDisplay::Display(system);
-}
\ No newline at end of file
+namespace {
+void Usage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [-s sample_ms] [-r redraw_ms] [-n rows] [-t threads]"
+               " [--events]\n"
+            << "       " << program
+            << " --headless [--format csv|jsonl|binary] [--output file]"
+               " [-s sample_ms] [-n rows] [-t threads] [-d seconds]\n"
+            << "       " << program << " --replay file [--speed x] [-n rows]\n"
+            << "  -s  interval between /proc samples (default 1000)\n"
+            << "  -r  interval between screen redraws (default 250)\n"
+            << "  -n  processes listed (default 10)\n"
+            << "  -t  sampler threads (default: cores, at most 4)\n"
+            << "  -d  headless: stop after this many seconds (default: "
+               "until SIGINT or SIGTERM)\n"
+            << "  --headless  write samples to --output (default stdout) "
+               "instead of drawing\n"
+            << "  --events  track processes through the kernel's proc "
+               "connector (needs CAP_NET_ADMIN)\n"
+            << "  --record  also append every sample to a binary log\n"
+            << "  --replay  play back a log recorded with --record\n"
+            << "Press q to quit.\n";
+}
+
+struct HeadlessOptions {
+  bool enabled = false;
+  bool exporting = false;  // --format or --output given.
+  Exporter::Format format = Exporter::Format::kCsv;
+  std::string output;  // Empty for stdout.
+  int seconds = 0;     // 0 runs until signalled.
+};
+
+// Opens the --record log for appending; a new recording continues after
+// whatever an earlier run left in it. Refuses a file that is not a log of the
+// current format, and cuts off a last record left incomplete by a crash.
+std::FILE* OpenRecording(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "ab");
+  if (file == nullptr) {
+    std::perror(path.c_str());
+    return nullptr;
+  }
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  if (size <= 0) return file;
+
+  SnapshotLog::Reader log;
+  log.Open(path);
+  if (log.Version() != SnapshotLog::kVersion) {
+    if (log.Version() == 0)
+      std::cerr << path << ": not a monitor recording, not appending to it\n";
+    else
+      std::cerr << path << ": recorded in format version " << log.Version()
+                << ", this monitor writes version " << SnapshotLog::kVersion
+                << "; record to a new file\n";
+    std::fclose(file);
+    return nullptr;
+  }
+  if (log.End() < static_cast<std::size_t>(size)) {
+    std::cerr << path << ": dropping " << size - log.End()
+              << " bytes of an incomplete last record\n";
+    if (ftruncate(fileno(file), static_cast<off_t>(log.End())) != 0) {
+      std::perror(path.c_str());
+      std::fclose(file);
+      return nullptr;
+    }
+    std::fseek(file, 0, SEEK_END);
+  }
+  return file;
+}
+
+// SIGINT and SIGTERM, which end a headless run.
+sigset_t StopSignals() {
+  sigset_t stop;
+  sigemptyset(&stop);
+  sigaddset(&stop, SIGINT);
+  sigaddset(&stop, SIGTERM);
+  return stop;
+}
+
+// Samples without a terminal, streaming every snapshot to the exporter until
+// the duration passes or SIGINT/SIGTERM arrives. Returns the exit status.
+// The stop signals must already be blocked in every thread.
+int RunHeadless(System& system, const NCursesDisplay::Options& options,
+                const HeadlessOptions& headless, Exporter* recorder) {
+  const sigset_t stop = StopSignals();
+
+  // With only --record, the log is the output.
+  const bool exporting = headless.exporting || recorder == nullptr;
+  std::FILE* file = stdout;
+  if (exporting && !headless.output.empty()) {
+    file = std::fopen(headless.output.c_str(), "wb");
+    if (file == nullptr) {
+      std::perror(headless.output.c_str());
+      return 1;
+    }
+  }
+  {
+    std::unique_ptr<Exporter> exporter;
+    if (exporting) exporter = std::make_unique<Exporter>(file, headless.format);
+    Sampler sampler(system, options.sampleInterval, options.rows,
+                    [&exporter, recorder](const auto& snapshot) {
+                      if (exporter) exporter->Push(snapshot);
+                      if (recorder) recorder->Push(snapshot);
+                    });
+    if (headless.seconds > 0) {
+      const timespec timeout{headless.seconds, 0};
+      while (sigtimedwait(&stop, nullptr, &timeout) < 0 && errno == EINTR) {
+      }
+    } else {
+      int signal;
+      sigwait(&stop, &signal);
+    }
+    // The sampler stops first, then the exporters drain what they queued.
+    if (exporter && exporter->Dropped() > 0)
+      std::cerr << "dropped " << exporter->Dropped() << " samples\n";
+  }
+  if (file != stdout) std::fclose(file);
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  NCursesDisplay::Options options;
+  HeadlessOptions headless;
+  std::string record;
+  std::string replay;
+  double speed = 1;
+  bool events = false;
+  int threads = SamplerPool::DefaultThreads();
+  for (int i = 1; i < argc; ++i) {
+    const char* flag = argv[i];
+    if (std::strcmp(flag, "--headless") == 0) {
+      headless.enabled = true;
+      continue;
+    }
+    if (std::strcmp(flag, "--events") == 0) {
+      events = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      Usage(argv[0]);
+      return 1;
+    }
+    if (std::strcmp(flag, "--format") == 0) {
+      if (!Exporter::ParseFormat(argv[++i], headless.format)) {
+        Usage(argv[0]);
+        return 1;
+      }
+      headless.exporting = true;
+      continue;
+    }
+    if (std::strcmp(flag, "--output") == 0) {
+      headless.output = argv[++i];
+      headless.exporting = true;
+      continue;
+    }
+    if (std::strcmp(flag, "--record") == 0) {
+      record = argv[++i];
+      continue;
+    }
+    if (std::strcmp(flag, "--replay") == 0) {
+      replay = argv[++i];
+      continue;
+    }
+    if (std::strcmp(flag, "--speed") == 0) {
+      speed = std::atof(argv[++i]);
+      if (speed <= 0) {
+        Usage(argv[0]);
+        return 1;
+      }
+      continue;
+    }
+    if (std::strlen(flag) != 2 || flag[0] != '-') {
+      Usage(argv[0]);
+      return 1;
+    }
+    const int value = std::atoi(argv[++i]);
+    if (value <= 0) {
+      Usage(argv[0]);
+      return 1;
+    }
+    switch (flag[1]) {
+      case 's':
+        options.sampleInterval = std::chrono::milliseconds(value);
+        break;
+      case 'r':
+        options.redrawInterval = std::chrono::milliseconds(value);
+        break;
+      case 'n':
+        options.rows = value;
+        break;
+      case 't':
+        threads = value;
+        break;
+      case 'd':
+        headless.seconds = value;
+        break;
+      default:
+        Usage(argv[0]);
+        return 1;
+    }
+  }
+  if (!replay.empty()) {
+    SnapshotLog::Reader log;
+    if (!log.Open(replay)) {
+      std::cerr << replay << ": not a readable monitor recording\n";
+      return 1;
+    }
+    NCursesDisplay::Replay(log, options, speed);
+    return 0;
+  }
+
+  if (headless.enabled) {
+    // Block the stop signals before any thread starts, so every thread
+    // inherits the mask and they are only ever taken by RunHeadless.
+    const sigset_t stop = StopSignals();
+    pthread_sigmask(SIG_BLOCK, &stop, nullptr);
+  }
+  // Recording shares the export path: the sampler only queues snapshots and
+  // a writer thread encodes and appends them.
+  std::FILE* recording = nullptr;
+  std::unique_ptr<Exporter> recorder;
+  if (!record.empty()) {
+    if ((recording = OpenRecording(record)) == nullptr) return 1;
+    recorder = std::make_unique<Exporter>(recording, Exporter::Format::kBinary);
+  }
+  System system(threads, events);
+  if (events && !system.TracksProcEvents())
+    std::cerr << "proc connector unavailable; listing /proc every sample\n";
+  int status = 0;
+  if (headless.enabled) {
+    status = RunHeadless(system, options, headless, recorder.get());
+  } else if (recorder) {
+    NCursesDisplay::Display(system, options,
+                            [&recorder](const auto& snapshot) {
+                              recorder->Push(snapshot);
+                            });
+  } else {
+    NCursesDisplay::Display(system, options);
+  }
+  recorder.reset();
+  if (recording != nullptr) std::fclose(recording);
+  return status;
+}
@@ -1,110 +1,524 @@
 #include <curses.h>
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "cell_grid.h"
 #include "format.h"
+#include "linux_parser.h"
 #include "ncurses_display.h"
+#include "sampler.h"
+#include "snapshot_log.h"
 #include "system.h"
 
 using std::string;
 using std::to_string;
 
-// 50 bars uniformly displayed from 0 - 100 %
-// 2% is one bar(|)
-std::string NCursesDisplay::ProgressBar(float percent) {
-  std::string result{"0%"};
-  int size{50};
-  float bars{percent * size};
+namespace {
+// "0%", 50 bars, then the percentage; written to `out`, which must hold
+// kProgressBarLength + 1 characters.
+constexpr int kProgressBarLength{2 + 50 + 1 + 4 + 5};
 
-  for (int i{0}; i < size; ++i) {
-    result += i <= bars ? '|' : ' ';
+int FormatProgressBar(float percent, char* out) {
+  int length = 0;
+  out[length++] = '0';
+  out[length++] = '%';
+  // 50 bars uniformly displayed from 0 - 100 %
+  // 2% is one bar(|)
+  const int size{50};
+  const float bars{percent * size};
+  for (int i{0}; i < size; ++i) out[length++] = i <= bars ? '|' : ' ';
+  out[length++] = ' ';
+  // The figure is the start of "%f", as to_string() would give it.
+  char figure[64];
+  const int figureLength =
+      std::snprintf(figure, sizeof(figure), "%f", percent * 100);
+  int digits = 4;
+  if (percent < 0.1 || percent == 1.0) {
+    out[length++] = ' ';
+    digits = 3;
   }
+  digits = std::min(digits, figureLength);
+  std::memcpy(out + length, figure, digits);
+  length += digits;
+  std::memcpy(out + length, "/100%", 5);
+  length += 5;
+  return length;
+}
+}  // namespace
+
+std::string NCursesDisplay::ProgressBar(float percent) {
+  char bar[kProgressBarLength + 1];
+  return std::string(bar, FormatProgressBar(percent, bar));
+}
+
+namespace {
+// Per-core cells start where the progress bars do.
+constexpr int kStripColumn{10};
+// Color pairs 3 to 6 shade the heat strip from idle to saturated.
+constexpr int kHeatPairs{3};
+
+// Glyphs from idle to saturated, shared by the heat strip and sparklines.
+constexpr char kRamp[] = " .:-=+*#%@";
+
+int RampStep(float load) {
+  return std::min(9, static_cast<int>(std::clamp(load, 0.0f, 1.0f) * 10));
+}
+
+// Cells per strip row in a window `width` columns wide, clear of the border.
+int StripCells(int width) { return std::max(1, width - kStripColumn - 2); }
+
+// Draws the newest values that fit in `width` cells from (y, x), oldest on
+// the left.
+void DrawSparkline(CellGrid& grid, int y, int x, const float* values,
+                   std::size_t size, int width, chtype attributes) {
+  const std::size_t shown = std::min<std::size_t>(size, width);
+  const float* newest = values + size - shown;
+  for (std::size_t i = 0; i < shown; ++i)
+    grid.Put(y, x + static_cast<int>(i),
+             static_cast<chtype>(kRamp[RampStep(newest[i])]) | attributes);
+}
 
-  string display{to_string(percent * 100).substr(0, 4)};
-  if (percent < 0.1 || percent == 1.0)
-    display = " " + to_string(percent * 100).substr(0, 3);
-  return result + " " + display + "/100%";
+// "10s" for one point per 10 seconds, "2m" for two minutes.
+std::string PointSpan(std::chrono::milliseconds interval, int tier) {
+  const long ms = interval.count() * MetricHistory::kSamplesPerPoint[tier];
+  if (ms < 1000) return to_string(ms) + "ms";
+  if (ms < 60000 || ms % 60000 != 0) return to_string(ms / 1000) + "s";
+  return to_string(ms / 60000) + "m";
 }
 
-void NCursesDisplay::DisplaySystem(System& system, WINDOW* window) {
+// Writes `label` followed by `value` at (row, column).
+void PutNumber(CellGrid& grid, int row, int column, std::string_view label,
+               long value) {
+  char text[24];
+  const int length = std::snprintf(text, sizeof(text), "%ld", value);
+  column = grid.Put(row, column, label);
+  grid.Put(row, column, std::string_view(text, length));
+}
+}  // namespace
+
+int NCursesDisplay::HeatStripRows(int cores, int width) {
+  return (cores + StripCells(width) - 1) / StripCells(width);
+}
+
+// One cell per core, wrapped over as many rows as needed. Each cell shows
+// the core's utilisation both as a glyph from a 10-step ramp and as one of
+// four colors, so even hundreds of cores read as a heat map at a glance.
+void NCursesDisplay::DisplayCores(const std::vector<float>& cores,
+                                  CellGrid& grid, int row) {
+  const int width = StripCells(grid.Columns());
+  grid.Put(row, 2, "Cores:");
+  for (std::size_t core = 0; core < cores.size(); ++core) {
+    const float load = std::clamp(cores[core], 0.0f, 1.0f);
+    const int pair = kHeatPairs + std::min(3, static_cast<int>(load * 4));
+    const int y = row + static_cast<int>(core) / width;
+    const int x = kStripColumn + static_cast<int>(core) % width;
+    grid.Put(y, x,
+             static_cast<chtype>(kRamp[RampStep(load)]) | COLOR_PAIR(pair));
+  }
+}
+
+void NCursesDisplay::DisplaySystem(const DisplaySnapshot& snapshot,
+                                   CellGrid& grid, int tier) {
   int row{0};
-  mvwprintw(window, ++row, 2, ("OS: " + system.OperatingSystem()).c_str());
-  mvwprintw(window, ++row, 2, ("Kernel: " + system.Kernel()).c_str());
-  mvwprintw(window, ++row, 2, "CPU: ");
-  wattron(window, COLOR_PAIR(1));
-  mvwprintw(window, row, 10, "");
-  wprintw(window, ProgressBar(system.Cpu().Utilization()).c_str());
-  wattroff(window, COLOR_PAIR(1));
-  mvwprintw(window, ++row, 2, "Memory: ");
-  wattron(window, COLOR_PAIR(1));
-  mvwprintw(window, row, 10, "");
-  wprintw(window, ProgressBar(system.MemoryUtilization()).c_str());
-  wattroff(window, COLOR_PAIR(1));
-  mvwprintw(window, ++row, 2,
-            ("Total Processes: " + to_string(system.TotalProcesses())).c_str());
-  mvwprintw(
-      window, ++row, 2,
-      ("Running Processes: " + to_string(system.RunningProcesses())).c_str());
-  mvwprintw(window, ++row, 2,
-            ("Up Time: " + Format::ElapsedTime(system.UpTime())).c_str());
-  wrefresh(window);
-}
-
-void NCursesDisplay::DisplayProcesses(std::vector<Process>& processes,
-                                      WINDOW* window, int n) {
+  char text[kProgressBarLength + 1];
+  grid.Put(++row, 2, "OS: ");
+  grid.Put(row, 6, snapshot.operatingSystem);
+  grid.Put(++row, 2, "Kernel: ");
+  grid.Put(row, 10, snapshot.kernel);
+  grid.Put(++row, 2, "CPU: ");
+  grid.Put(row, 10,
+           std::string_view(text, FormatProgressBar(snapshot.cpu, text)),
+           COLOR_PAIR(1));
+  grid.Put(++row, 2, "Memory: ");
+  grid.Put(row, 10,
+           std::string_view(text, FormatProgressBar(snapshot.memory, text)),
+           COLOR_PAIR(1));
+  PutNumber(grid, ++row, 2, "Total Processes: ", snapshot.totalProcesses);
+  PutNumber(grid, ++row, 2, "Running Processes: ", snapshot.runningProcesses);
+  grid.Put(++row, 2, "Up Time: ");
+  grid.Put(row, 11,
+           std::string_view(text, Format::ElapsedTime(snapshot.uptime, text,
+                                                      sizeof(text))));
+  const int cells = StripCells(grid.Columns());
+  const auto& cpu = snapshot.cpuHistory[tier];
+  const auto& memory = snapshot.memoryHistory[tier];
+  grid.Put(++row, 2, "CPU ~");
+  DrawSparkline(grid, row, kStripColumn, cpu.values.data(), cpu.size, cells,
+                COLOR_PAIR(1));
+  grid.Put(++row, 2, "Mem ~");
+  DrawSparkline(grid, row, kStripColumn, memory.values.data(), memory.size,
+                cells, COLOR_PAIR(1));
+  if (!snapshot.cores.empty()) DisplayCores(snapshot.cores, grid, ++row);
+}
+
+void NCursesDisplay::DisplayProcesses(const std::vector<ProcessRow>& processes,
+                                      CellGrid& grid, int n) {
   int row{0};
   int const pid_column{2};
   int const user_column{9};
   int const cpu_column{16};
   int const ram_column{26};
-  int const time_column{35};
-  int const command_column{46};
-  wattron(window, COLOR_PAIR(2));
-  mvwprintw(window, ++row, pid_column, "PID");
-  mvwprintw(window, row, user_column, "USER");
-  mvwprintw(window, row, cpu_column, "CPU[%%]");
-  mvwprintw(window, row, ram_column, "RAM[MB]");
-  mvwprintw(window, row, time_column, "TIME+");
-  mvwprintw(window, row, command_column, "COMMAND");
-  wattroff(window, COLOR_PAIR(2));
+  int const pss_column{34};
+  int const uss_column{42};
+  int const time_column{50};
+  int const history_column{61};
+  int const command_column{71};
+  grid.Put(++row, pid_column, "PID", COLOR_PAIR(2));
+  grid.Put(row, user_column, "USER", COLOR_PAIR(2));
+  grid.Put(row, cpu_column, "CPU[%]", COLOR_PAIR(2));
+  grid.Put(row, ram_column, "RSS[MB]", COLOR_PAIR(2));
+  grid.Put(row, pss_column, "PSS", COLOR_PAIR(2));
+  grid.Put(row, uss_column, "USS", COLOR_PAIR(2));
+  grid.Put(row, time_column, "TIME+", COLOR_PAIR(2));
+  grid.Put(row, history_column, "CPU~", COLOR_PAIR(2));
+  grid.Put(row, command_column, "COMMAND", COLOR_PAIR(2));
   int const num_processes = int(processes.size()) > n ? n : processes.size();
+  char text[64];
   for (int i = 0; i < num_processes; ++i) {
-    mvwprintw(window, ++row, pid_column, to_string(processes[i].Pid()).c_str());
-    mvwprintw(window, row, user_column, processes[i].User().c_str());
-    float cpu = processes[i].CpuUtilization() * 100;
-    mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
-    mvwprintw(window, row, ram_column, processes[i].Ram().c_str());
-    mvwprintw(window, row, time_column,
-              Format::ElapsedTime(processes[i].UpTime()).c_str());
-    mvwprintw(window, row, command_column,
-              processes[i].Command().substr(0, window->_maxx - 46).c_str());
+    const ProcessRow& process = processes[i];
+    PutNumber(grid, ++row, pid_column, "", process.pid);
+    grid.Put(row, user_column, process.user);
+    // The first four characters of "%f", as to_string() would give them.
+    const int cpuLength =
+        std::snprintf(text, sizeof(text), "%f", process.cpu * 100);
+    grid.Put(row, cpu_column, std::string_view(text, std::min(cpuLength, 4)));
+    grid.Put(row, ram_column, LinuxParser::Ram(process.ram));
+    grid.Put(row, pss_column, LinuxParser::Ram(process.pss));
+    grid.Put(row, uss_column, LinuxParser::Ram(process.uss));
+    grid.Put(row, time_column,
+             std::string_view(text, Format::ElapsedTime(process.uptime, text,
+                                                        sizeof(text))));
+    DrawSparkline(grid, row, history_column,
+                  process.cpuHistory.values.data(), process.cpuHistory.size,
+                  command_column - history_column - 2, A_NORMAL);
+    grid.Put(row, command_column, process.command);
+  }
+}
+
+namespace {
+// Devices listed in each half of the device window.
+constexpr int kDeviceRows{4};
+
+// Fills `top` with the indices of the up to kDeviceRows devices with the
+// highest `load`, highest first and in list order among equals; returns how
+// many there are.
+template <typename Device, typename Load>
+int Busiest(const std::vector<Device>& devices, Load load,
+            std::size_t (&top)[kDeviceRows]) {
+  int count = 0;
+  for (std::size_t i = 0; i < devices.size(); ++i) {
+    const float value = load(devices[i]);
+    int slot = count;
+    while (slot > 0 && load(devices[top[slot - 1]]) < value) --slot;
+    if (slot == kDeviceRows) continue;
+    if (count < kDeviceRows) ++count;
+    for (int j = count - 1; j > slot; --j) top[j] = top[j - 1];
+    top[slot] = i;
+  }
+  return count;
+}
+
+// Writes `bytes` per second at (row, column).
+void PutBytes(CellGrid& grid, int row, int column, float bytes) {
+  char text[16];
+  grid.Put(row, column,
+           std::string_view(text, Format::Bytes(bytes, text, sizeof(text))));
+}
+}  // namespace
+
+void NCursesDisplay::DisplayDevices(const std::vector<DiskRate>& disks,
+                                    const std::vector<NetRate>& interfaces,
+                                    CellGrid& grid) {
+  int const disk_column{2};
+  int const read_column{10};
+  int const write_column{18};
+  int const reads_column{27};
+  int const writes_column{33};
+  int const net_column{41};
+  int const rx_column{52};
+  int const tx_column{60};
+  const int rows = std::min(kDeviceRows, grid.Rows() - 3);
+  grid.Put(1, disk_column, "DISK", COLOR_PAIR(2));
+  grid.Put(1, read_column, "READ/s", COLOR_PAIR(2));
+  grid.Put(1, write_column, "WRITE/s", COLOR_PAIR(2));
+  grid.Put(1, reads_column, "R/s", COLOR_PAIR(2));
+  grid.Put(1, writes_column, "W/s", COLOR_PAIR(2));
+  grid.Put(1, net_column, "NET", COLOR_PAIR(2));
+  grid.Put(1, rx_column, "RX/s", COLOR_PAIR(2));
+  grid.Put(1, tx_column, "TX/s", COLOR_PAIR(2));
+  char text[16];
+  std::size_t top[kDeviceRows];
+  const int diskCount = std::min(
+      rows, Busiest(disks, [](const DiskRate& disk) {
+        return disk.readBytes + disk.writeBytes;
+      }, top));
+  for (int i = 0; i < diskCount; ++i) {
+    const DiskRate& disk = disks[top[i]];
+    const int row = 2 + i;
+    grid.Put(row, disk_column,
+             std::string_view(disk.name).substr(
+                 0, read_column - disk_column - 1));
+    PutBytes(grid, row, read_column, disk.readBytes);
+    PutBytes(grid, row, write_column, disk.writeBytes);
+    grid.Put(row, reads_column,
+             std::string_view(text, std::snprintf(text, sizeof(text), "%.0f",
+                                                  disk.reads)));
+    grid.Put(row, writes_column,
+             std::string_view(text, std::snprintf(text, sizeof(text), "%.0f",
+                                                  disk.writes)));
+  }
+  const int interfaceCount = std::min(
+      rows, Busiest(interfaces, [](const NetRate& interface) {
+        return interface.rxBytes + interface.txBytes;
+      }, top));
+  for (int i = 0; i < interfaceCount; ++i) {
+    const NetRate& interface = interfaces[top[i]];
+    const int row = 2 + i;
+    grid.Put(row, net_column,
+             std::string_view(interface.name).substr(
+                 0, rx_column - net_column - 1));
+    PutBytes(grid, row, rx_column, interface.rxBytes);
+    PutBytes(grid, row, tx_column, interface.txBytes);
   }
 }
 
-void NCursesDisplay::Display(System& system, int n) {
+namespace {
+// The three windows of a frame, stacked: system, devices and processes, and
+// what each currently shows.
+struct Screen {
+  WINDOW* system;
+  WINDOW* devices;
+  WINDOW* processes;
+  CellGrid systemCells;
+  CellGrid deviceCells;
+  CellGrid processCells;
+};
+
+Screen OpenScreen(int cores, int rows, std::chrono::milliseconds redraw) {
   initscr();      // start ncurses
   noecho();       // do not print input values
   cbreak();       // terminate ncurses on ctrl + c
   start_color();  // enable color
+  curs_set(0);    // hide the cursor
+  keypad(stdscr, TRUE);
+  // getch() waits at most one redraw interval, so it paces the frames.
+  timeout(static_cast<int>(redraw.count()));
+  // getch() refreshes stdscr, and its first refresh clears the terminal.
+  // Done here, before any frame, so it cannot wipe cells the CellGrids
+  // believe are shown.
+  refresh();
+  init_pair(1, COLOR_BLUE, COLOR_BLACK);
+  init_pair(2, COLOR_GREEN, COLOR_BLACK);
+  init_pair(kHeatPairs, COLOR_BLUE, COLOR_BLACK);
+  init_pair(kHeatPairs + 1, COLOR_GREEN, COLOR_BLACK);
+  init_pair(kHeatPairs + 2, COLOR_YELLOW, COLOR_BLACK);
+  init_pair(kHeatPairs + 3, COLOR_RED, COLOR_BLACK);
 
   int x_max{getmaxx(stdscr)};
-  WINDOW* system_window = newwin(9, x_max - 1, 0, 0);
+  // Seven rows of figures, two sparklines, the heat strip and the border.
+  WINDOW* system_window = newwin(
+      11 + NCursesDisplay::HeatStripRows(cores, x_max - 1), x_max - 1, 0, 0);
+  // Headings, the devices and the border.
+  WINDOW* device_window =
+      newwin(3 + kDeviceRows, x_max - 1, system_window->_maxy + 1, 0);
   WINDOW* process_window =
-      newwin(3 + n, x_max - 1, system_window->_maxy + 1, 0);
-
-  while (1) {
-    init_pair(1, COLOR_BLUE, COLOR_BLACK);
-    init_pair(2, COLOR_GREEN, COLOR_BLACK);
-    box(system_window, 0, 0);
-    box(process_window, 0, 0);
-    DisplaySystem(system, system_window);
-    DisplayProcesses(system.Processes(), process_window, n);
-    wrefresh(system_window);
-    wrefresh(process_window);
-    refresh();
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-  }
+      newwin(3 + rows, x_max - 1,
+             system_window->_maxy + 1 + device_window->_maxy + 1, 0);
+  return {system_window, device_window, process_window,
+          CellGrid(getmaxy(system_window), getmaxx(system_window)),
+          CellGrid(getmaxy(device_window), getmaxx(device_window)),
+          CellGrid(getmaxy(process_window), getmaxx(process_window))};
+}
+
+void CloseScreen(Screen& screen) {
+  delwin(screen.processes);
+  delwin(screen.devices);
+  delwin(screen.system);
   endwin();
 }
+
+// Composes the frame and sends curses only the cells that changed.
+// `caption` and then `status` go on the bottom border of the system window,
+// `footer` on that of the process window.
+void DrawFrame(Screen& screen, const DisplaySnapshot& snapshot, int rows,
+               int tier, std::string_view caption,
+               std::string_view status = {}, std::string_view footer = {}) {
+  CellGrid& system = screen.systemCells;
+  CellGrid& devices = screen.deviceCells;
+  CellGrid& processes = screen.processCells;
+  system.Clear();
+  devices.Clear();
+  processes.Clear();
+  system.Box();
+  devices.Box();
+  processes.Box();
+  NCursesDisplay::DisplaySystem(snapshot, system, tier);
+  system.Put(system.Rows() - 1, system.Put(system.Rows() - 1, 2, caption),
+             status);
+  NCursesDisplay::DisplayDevices(snapshot.disks, snapshot.interfaces,
+                                 devices);
+  NCursesDisplay::DisplayProcesses(snapshot.processes, processes, rows);
+  processes.Put(processes.Rows() - 1, 2, footer);
+  system.Flush(screen.system);
+  devices.Flush(screen.devices);
+  processes.Flush(screen.processes);
+  doupdate();
+}
+
+string HistoryCaption(std::chrono::milliseconds interval, int tier) {
+  return " history: " + PointSpan(interval, tier) + " per point, t to change ";
+}
+
+// "16:39:01" in local time.
+string ClockTime(std::chrono::system_clock::time_point time) {
+  const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+  std::tm local;
+  localtime_r(&seconds, &local);
+  char text[16];
+  std::strftime(text, sizeof(text), "%H:%M:%S", &local);
+  return text;
+}
+}  // namespace
+
+void NCursesDisplay::Display(System& system, const Options& options,
+                             Sampler::Listener listener) {
+  const int n = options.rows;
+  Screen screen =
+      OpenScreen(system.Cpu().CoreUtilization().size(), n,
+                 options.redrawInterval);
+  // Sampling runs on its own thread from here on; a slow /proc read delays
+  // the next sample, never a redraw or a key press.
+  Sampler sampler(system, options.sampleInterval, n, std::move(listener));
+  int tier = 0;
+  string caption = HistoryCaption(options.sampleInterval, tier);
+  // Redraws outnumber samples, so most frames would repeat the last one.
+  std::shared_ptr<const DisplaySnapshot> shown;
+  bool stale = true;
+  while (true) {
+    std::shared_ptr<const DisplaySnapshot> snapshot = sampler.Latest();
+    if (snapshot != nullptr && (snapshot != shown || stale)) {
+      DrawFrame(screen, *snapshot, n, tier, caption);
+      shown = std::move(snapshot);
+      stale = false;
+    }
+    const int key = getch();
+    if (key == 'q' || key == 'Q') break;
+    if (key == 't' || key == 'T') {
+      tier = (tier + 1) % MetricHistory::kTiers;
+      caption = HistoryCaption(options.sampleInterval, tier);
+      stale = true;
+    }
+  }
+  CloseScreen(screen);
+}
+
+void NCursesDisplay::Replay(SnapshotLog::Reader& log, const Options& options,
+                            double speed) {
+  using std::chrono::milliseconds;
+  using std::chrono::steady_clock;
+  const int n = options.rows;
+  const std::size_t last = log.Size() - 1;
+  const auto start = log.Time(0);
+  const auto end = log.Time(last);
+  // The recording's mean sample interval stands in for -s in the caption.
+  const milliseconds interval = std::max(
+      milliseconds(1),
+      std::chrono::duration_cast<milliseconds>(end - start) /
+          static_cast<long>(std::max<std::size_t>(last, 1)));
+  std::shared_ptr<const DisplaySnapshot> first = log.Snapshot(0);
+  Screen screen = OpenScreen(first ? first->cores.size() : 0, n,
+                             options.redrawInterval);
+
+  // Playback position as an offset into the recording, advanced by wall
+  // time times the speed.
+  std::chrono::duration<double, std::milli> position{0};
+  const std::chrono::duration<double, std::milli> length = end - start;
+  bool paused = false;
+  int tier = 0;
+  string caption = HistoryCaption(interval, tier);
+  struct Frame {
+    std::size_t record;
+    int tier;
+    bool paused;
+    double speed;
+    bool operator!=(const Frame& other) const {
+      return record != other.record || tier != other.tier ||
+             paused != other.paused || speed != other.speed;
+    }
+  } shown{log.Size(), 0, false, 0};
+  auto previous = steady_clock::now();
+  while (true) {
+    const auto now = steady_clock::now();
+    if (!paused) position += (now - previous) * speed;
+    previous = now;
+    if (position >= length) {
+      position = length;
+      paused = true;
+    }
+    const std::size_t record = log.Find(
+        start + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    position));
+    // Decoding and composing are skipped while the frame would not change.
+    const Frame frame{record, tier, paused, speed};
+    std::shared_ptr<const DisplaySnapshot> snapshot;
+    if (frame != shown && (snapshot = log.Snapshot(record)) != nullptr) {
+      shown = frame;
+      char status[64];
+      const int statusLength = std::min<int>(
+          sizeof(status) - 1,
+          std::snprintf(status, sizeof(status), " replay %s x%g%s ",
+                        ClockTime(snapshot->time).c_str(), speed,
+                        paused ? " paused" : ""));
+      DrawFrame(screen, *snapshot, n, tier, caption,
+                std::string_view(status, statusLength),
+                " space pause, arrows seek 10s/1m, +/- speed, g/G ends ");
+    }
+    const int key = getch();
+    if (key == 'q' || key == 'Q') break;
+    switch (key) {
+      case 't':
+      case 'T':
+        tier = (tier + 1) % MetricHistory::kTiers;
+        caption = HistoryCaption(interval, tier);
+        break;
+      case ' ':
+        paused = !paused;
+        break;
+      case '+':
+        speed = std::min(speed * 2, 1024.0);
+        break;
+      case '-':
+        speed = std::max(speed / 2, 1.0 / 16);
+        break;
+      case KEY_RIGHT:
+        position += std::chrono::seconds(10);
+        break;
+      case KEY_LEFT:
+        position -= std::chrono::seconds(10);
+        break;
+      case KEY_UP:
+        position += std::chrono::minutes(1);
+        break;
+      case KEY_DOWN:
+        position -= std::chrono::minutes(1);
+        break;
+      case 'g':
+        position = position.zero();
+        break;
+      case 'G':
+        position = length;
+        break;
+    }
+    if (position < position.zero()) position = position.zero();
+    if (position > length) position = length;
+  }
+  CloseScreen(screen);
+}
@@ -0,0 +1,146 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+#include "linux_parser.h"
+#include "proc_buffer.h"
+
+ProcBuffer::ProcBuffer(std::size_t capacity) : data_(capacity) {}
+
+std::string_view ProcBuffer::Read(const char* path) {
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return {};
+  // Files under /proc report a size of 0, and seq_file based ones (maps,
+  // diskstats, net/dev, ...) return at most a page per read(), so a short
+  // read does not mean end of file: read until read() returns 0, growing the
+  // buffer whenever it fills up.
+  std::size_t size = 0;
+  while (true) {
+    if (size == data_.size()) data_.resize(data_.size() * 2);
+    const ssize_t n = read(fd, data_.data() + size, data_.size() - size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) {
+      close(fd);
+      return {};
+    }
+    if (n == 0) break;
+    size += static_cast<std::size_t>(n);
+  }
+  close(fd);
+  return {data_.data(), size};
+}
+
+std::string_view ProcBuffer::Read(std::string_view directory,
+                                  std::string_view file) {
+  char path[PATH_MAX];
+  if (directory.size() + file.size() >= sizeof(path)) return {};
+  std::memcpy(path, directory.data(), directory.size());
+  std::memcpy(path + directory.size(), file.data(), file.size());
+  path[directory.size() + file.size()] = '\0';
+  return Read(path);
+}
+
+std::string_view ProcBuffer::ReadPid(int pid, const char* file) {
+  char path[PATH_MAX];
+  const std::string& root = LinuxParser::ProcDirectory();
+  const std::size_t length = std::strlen(file);
+  // Root, at most 10 digits, a slash, the file name and the terminator.
+  if (root.size() + 12 + length >= sizeof(path)) return {};
+  std::memcpy(path, root.data(), root.size());
+  char* end = std::to_chars(path + root.size(), path + sizeof(path), pid).ptr;
+  *end++ = '/';
+  std::memcpy(end, file, length + 1);
+  return Read(path);
+}
+
+ProcFile::ProcFile(std::string path, std::size_t capacity)
+    : path_(std::move(path)), data_(capacity) {}
+
+ProcFile::~ProcFile() { Close(); }
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : path_(std::move(other.path_)),
+      fd_(std::exchange(other.fd_, -1)),
+      data_(std::move(other.data_)) {}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    path_ = std::move(other.path_);
+    fd_ = std::exchange(other.fd_, -1);
+    data_ = std::move(other.data_);
+  }
+  return *this;
+}
+
+void ProcFile::Close() {
+  if (fd_ >= 0) close(fd_);
+  fd_ = -1;
+}
+
+std::string_view ProcFile::Read() {
+  if (fd_ < 0) {
+    if (path_.empty()) return {};
+    fd_ = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) return {};
+  }
+  // As in ProcBuffer::Read, only a read of 0 bytes marks the end.
+  std::size_t size = 0;
+  while (true) {
+    if (size == data_.size()) data_.resize(data_.size() * 2);
+    const ssize_t n = pread(fd_, data_.data() + size, data_.size() - size,
+                            static_cast<off_t>(size));
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) {
+      // Typically ESRCH once the process behind a /proc/<pid> file exits.
+      Close();
+      return {};
+    }
+    if (n == 0) break;
+    size += static_cast<std::size_t>(n);
+  }
+  return {data_.data(), size};
+}
+
+namespace ProcScan {
+
+static bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+}
+
+std::string_view NextToken(std::string_view& text) {
+  std::size_t begin = 0;
+  while (begin < text.size() && IsSpace(text[begin])) ++begin;
+  std::size_t end = begin;
+  while (end < text.size() && !IsSpace(text[end])) ++end;
+  std::string_view token = text.substr(begin, end - begin);
+  text.remove_prefix(end);
+  return token;
+}
+
+std::string_view NextLine(std::string_view& text) {
+  const std::size_t end = text.find('\n');
+  std::string_view line = text.substr(0, end);
+  text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+  return line;
+}
+
+std::string_view Value(std::string_view text, std::string_view key) {
+  while (!text.empty()) {
+    std::string_view line = NextLine(text);
+    if (line.substr(0, key.size()) == key) return line.substr(key.size());
+  }
+  return {};
+}
+
+std::string_view StatFields(std::string_view stat) {
+  const std::size_t close = stat.rfind(')');
+  if (close == std::string_view::npos) return {};
+  return stat.substr(close + 1);
+}
+
+}  // namespace ProcScan
@@ -0,0 +1,172 @@
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "proc_events.h"
+
+namespace {
+// Sends a (un)subscribe request for the proc connector's multicast group.
+bool Subscribe(int socket, proc_cn_mcast_op op) {
+  // nlmsghdr, then cn_msg whose payload is the operation.
+  constexpr std::size_t kLength =
+      NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+  alignas(nlmsghdr) char request[NLMSG_SPACE(kLength)] = {};
+  auto* header = reinterpret_cast<nlmsghdr*>(request);
+  header->nlmsg_len = kLength;
+  header->nlmsg_type = NLMSG_DONE;
+  header->nlmsg_pid = getpid();
+  auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(proc_cn_mcast_op);
+  std::memcpy(message->data, &op, sizeof(op));
+  return send(socket, request, kLength, 0) ==
+         static_cast<ssize_t>(kLength);
+}
+}  // namespace
+
+ProcEvents::ProcEvents() {
+  socket_ = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                   NETLINK_CONNECTOR);
+  if (socket_ < 0) return;
+  // A fork storm between two ticks must fit in the socket buffer; past it
+  // the kernel drops events and the next Apply() asks for a rescan.
+  const int buffer = 4 << 20;
+  if (setsockopt(socket_, SOL_SOCKET, SO_RCVBUFFORCE, &buffer,
+                 sizeof(buffer)) != 0)
+    setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+  sockaddr_nl address{};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = CN_IDX_PROC;
+  if (bind(socket_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      !Subscribe(socket_, PROC_CN_MCAST_LISTEN) || !Delivers()) {
+    close(socket_);
+    socket_ = -1;
+  }
+}
+
+bool ProcEvents::Delivers() {
+  const pid_t child = fork();
+  if (child < 0) return false;
+  if (child == 0) _exit(0);
+  waitpid(child, nullptr, 0);
+
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kDeliveryTimeoutMs);
+  bool delivered = false;
+  while (true) {
+    Receive(nullptr);
+    if (std::find(forks_.begin(), forks_.end(), child) != forks_.end()) {
+      delivered = true;
+      break;
+    }
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (left.count() <= 0) break;
+    pollfd ready{socket_, POLLIN, 0};
+    poll(&ready, 1, static_cast<int>(left.count()));
+  }
+  // The events received meanwhile predate the first listing of /proc.
+  forks_.clear();
+  return delivered;
+}
+
+ProcEvents::~ProcEvents() {
+  if (socket_ < 0) return;
+  Subscribe(socket_, PROC_CN_MCAST_IGNORE);
+  close(socket_);
+}
+
+bool ProcEvents::Receive(std::vector<int>* execs) {
+  bool complete = true;
+  alignas(nlmsghdr) char buffer[16384];
+  while (true) {
+    sockaddr_nl sender{};
+    socklen_t senderLength = sizeof(sender);
+    const ssize_t n =
+        recvfrom(socket_, buffer, sizeof(buffer), 0,
+                 reinterpret_cast<sockaddr*>(&sender), &senderLength);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == ENOBUFS) {  // Overflowed; later events still arrive.
+        complete = false;
+        continue;
+      }
+      break;  // EAGAIN: nothing more pending.
+    }
+    if (sender.nl_pid != 0) continue;  // Only the kernel sends events.
+    int length = static_cast<int>(n);
+    for (auto* header = reinterpret_cast<nlmsghdr*>(buffer);
+         NLMSG_OK(header, length); header = NLMSG_NEXT(header, length)) {
+      if (header->nlmsg_type == NLMSG_NOOP) continue;
+      if (header->nlmsg_type == NLMSG_ERROR ||
+          header->nlmsg_type == NLMSG_OVERRUN) {
+        complete = false;
+        continue;
+      }
+      const auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+      if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC)
+        continue;
+      const auto* event = reinterpret_cast<const proc_event*>(message->data);
+      // /proc lists thread group leaders only, so thread events are noise.
+      switch (event->what) {
+        case proc_event::PROC_EVENT_FORK: {
+          const auto& fork = event->event_data.fork;
+          if (fork.child_pid == fork.child_tgid)
+            forks_.push_back(fork.child_tgid);
+          break;
+        }
+        case proc_event::PROC_EVENT_EXEC:
+          if (execs != nullptr)
+            execs->push_back(event->event_data.exec.process_tgid);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return complete;
+}
+
+bool ProcEvents::Apply(std::vector<int>& pids, std::vector<int>& execs) {
+  execs.clear();
+  forks_.clear();
+  if (socket_ < 0) return false;
+  const bool complete = Receive(&execs);
+  if (forks_.empty()) return complete;
+  AddForks(pids, forks_, merged_);
+
+  std::sort(execs.begin(), execs.end());
+  execs.erase(std::unique(execs.begin(), execs.end()), execs.end());
+  return complete;
+}
+
+void ProcEvents::AddForks(std::vector<int>& pids, std::vector<int>& forks,
+                          std::vector<int>& merged) {
+  // A forked pid may already be listed, e.g. reused after an exit the
+  // caller has not noticed yet; it is listed once either way.
+  std::sort(forks.begin(), forks.end());
+  merged.clear();
+  std::set_union(pids.begin(), pids.end(), forks.begin(), forks.end(),
+                 std::back_inserter(merged));
+  merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+  pids.swap(merged);
+}
+
+void ProcEvents::Discard() {
+  if (socket_ < 0) return;
+  forks_.clear();
+  Receive(nullptr);
+  forks_.clear();
+}
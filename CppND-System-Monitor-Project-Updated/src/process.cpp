@@ -11,32 +11,127 @@ using std::string;
 using std::to_string;
 using std::vector;
 
-Process::Process(const int pid) : pid_(pid), cpu_(CpuUtilization()) {}
+Process::Process(const int pid, const long long starttime, UserTable* users)
+    : pid_(pid), starttime_(starttime), users_(users) {}
+
+bool Process::ReadStat(LinuxParser::PidStat& stat) {
+  if (!visible_) return LinuxParser::ReadPidStat(pid_, stat);
+  if (!statFile_.HasPath())
+    statFile_ = ProcFile(LinuxParser::PidPath(pid_, "stat"));
+  // A failed read may mean the pid was reused; the path read then returns
+  // the new process and its different start time retires this record.
+  return LinuxParser::ParsePidStat(statFile_.Read(), stat) ||
+         LinuxParser::ReadPidStat(pid_, stat);
+}
+
+void Process::Update(const LinuxParser::PidStat& stat, const long elapsedTicks,
+                     const double uptime) {
+  static const long hertz = sysconf(_SC_CLK_TCK);
+  const long activeJiffies =
+      stat.utime + stat.stime + stat.cutime + stat.cstime;
+  uptime_ = static_cast<long>(uptime) - static_cast<long>(starttime_ / hertz);
+
+  // A process seen for the first time has no previous sample, so it reports
+  // its average over its lifetime instead of over the last interval.
+  long ticks = elapsedTicks;
+  long jiffies = activeJiffies - lastActiveJiffies_;
+  if (lastActiveJiffies_ < 0) {
+    ticks = static_cast<long>(uptime * hertz - starttime_);
+    jiffies = activeJiffies;
+  }
+  cpu_ = ticks > 0 ? static_cast<float>(jiffies) / ticks : 0;
+  lastActiveJiffies_ = activeJiffies;
+  statmLoaded_ = false;
+  ++statusAge_;
+  ++smapsAge_;
+  if (!visible_) {
+    statFile_ = ProcFile();
+    statmFile_ = ProcFile();
+    history_.reset();
+  }
+  if (history_) history_->cpu.Push(cpu_);
+  visible_ = false;
+}
+
+void Process::Exec() {
+  commandLoaded_ = false;
+  statusAge_ = kStatusTicks;
+  smapsAge_ = kSmapsTicks;
+}
+
+void Process::Show() {
+  visible_ = true;
+  if (!history_) history_ = std::make_unique<History>();
+}
+
+const LinuxParser::PidStatm& Process::Statm() {
+  Show();
+  if (!statmLoaded_) {
+    if (!statmFile_.HasPath())
+      statmFile_ = ProcFile(LinuxParser::PidPath(pid_, "statm"), 256);
+    statm_ = {};
+    // Falls back to a plain read if the descriptor cannot be opened, e.g.
+    // when so many rows are shown that the file limit is reached.
+    if (!LinuxParser::ParsePidStatm(statmFile_.Read(), statm_))
+      LinuxParser::ReadPidStatm(pid_, statm_);
+    statmLoaded_ = true;
+  }
+  return statm_;
+}
+
+const LinuxParser::PidSmaps& Process::Smaps() {
+  // Kernel threads and zombies have no memory to walk.
+  if (Statm().resident == 0) {
+    smaps_ = {0, 0};
+  } else if (smapsAge_ >= kSmapsTicks) {
+    smaps_ = {};
+    LinuxParser::ReadPidSmaps(pid_, smaps_);
+    smapsAge_ = 0;
+  }
+  return smaps_;
+}
 
 // DONE: Return this process's ID
-int Process::Pid() { return pid_; }
+int Process::Pid() const { return pid_; }
 
 // DONE: Return this process's CPU utilization
-float Process::CpuUtilization() { 
-	long activeJiffies = LinuxParser::ActiveJiffies(pid_);
-	float seconds = (float) Process::UpTime();
-	if (seconds == 0) {
-		return 0;
-	}
-	return ((activeJiffies / sysconf(_SC_CLK_TCK)) / seconds);
-}
+float Process::CpuUtilization() { return cpu_; }
 
 // DONE: Return the command that generated this process
-string Process::Command() { return LinuxParser::Command(pid_); }
+string Process::Command() {
+  if (!commandLoaded_) {
+    command_ = LinuxParser::Command(pid_);
+    commandLoaded_ = true;
+  }
+  return command_;
+}
 
 // DONE: Return this process's memory utilization
-string Process::Ram() { return LinuxParser::Ram(pid_); }
+string Process::Ram() { return LinuxParser::Ram(RamKb()); }
+
+string Process::Pss() { return LinuxParser::Ram(PssKb()); }
+
+string Process::Uss() { return LinuxParser::Ram(UssKb()); }
+
+long Process::RamKb() { return Statm().resident; }
+
+long Process::PssKb() { return Smaps().pss; }
+
+long Process::UssKb() { return Smaps().uss; }
 
 // DONE: Return the user (name) that generated this process
-string Process::User() { return LinuxParser::User(pid_); }
+string Process::User() {
+  Show();
+  if (statusAge_ >= kStatusTicks) {
+    status_ = {};
+    LinuxParser::ReadPidStatus(pid_, status_);
+    statusAge_ = 0;
+  }
+  return status_.uid < 0 ? string() : users_->Name(status_.uid);
+}
 
 // DONE: Return the age of this process (in seconds)
-long int Process::UpTime() { return LinuxParser::UpTime(pid_); }
+long int Process::UpTime() { return uptime_; }
 
 // DONE: Overload the "less than" comparison operator for Process objects
 // REMOVE: [[maybe_unused]] once you define the function
@@ -46,4 +141,4 @@ bool Process::operator<(Process const& a) const {
 
 bool Process::operator>(Process const& a) const { 
   return cpu_ > a.cpu_; 
-}
\ No newline at end of file
+}
@@ -1,28 +1,90 @@
-#include <unistd.h>
-
 #include "linux_parser.h"
 #include "processor.h"
 
-// DONE: Return the aggregate CPU utilization
-float Processor::Utilization() { 
-	const long jiffies = LinuxParser::Jiffies();
-	const long activeJiffies = LinuxParser::ActiveJiffies();
-
-	if (lastActiveJiffies_ == 0 && lastJiffies_ == 0) {
-		lastActiveJiffies_ = activeJiffies;	
-		lastJiffies_ = jiffies;
-		return lastActiveJiffies_ / lastJiffies_;
-	}
+void Processor::Update(const LinuxParser::CpuTimes& times,
+                       const LinuxParser::CoreTimes& cores) {
+  const long activeJiffies = LinuxParser::ActiveJiffies(times);
+  const long jiffies = activeJiffies + LinuxParser::IdleJiffies(times);
 
+  // The first sample has no predecessor, so it reports the average since
+  // boot.
   const float activeJiffiesDiff = activeJiffies - lastActiveJiffies_;
   const float jiffiesDiff = jiffies - lastJiffies_;
 
   lastActiveJiffies_ = activeJiffies;
   lastJiffies_ = jiffies;
 
-  if (activeJiffiesDiff == 0) {
-    return 0.0;
-  } else {
-  	return activeJiffiesDiff / jiffiesDiff;
+  utilization_ = jiffiesDiff > 0 ? activeJiffiesDiff / jiffiesDiff : 0;
+  UpdateCores(cores);
+}
+
+namespace {
+// Interval utilisation of `count` cores from columns of the CoreTimes
+// matrix. Straight-line arithmetic over contiguous arrays that cannot
+// alias, so the compiler runs it several cores at a time.
+void CoreDeltas(const long* __restrict user, const long* __restrict nice,
+                const long* __restrict system, const long* __restrict idle,
+                const long* __restrict iowait, const long* __restrict irq,
+                const long* __restrict softirq, const long* __restrict steal,
+                long* __restrict lastActive, long* __restrict lastTotal,
+                float* __restrict utilization, std::size_t count) {
+  for (std::size_t core = 0; core < count; ++core) {
+    const long active = user[core] + nice[core] + system[core] + irq[core] +
+                        softirq[core] + steal[core];
+    const long total = active + idle[core] + iowait[core];
+    // Deltas over one interval fit in 32 bits (2^31 jiffies are 248 days
+    // at 100 Hz), and int32 -> float converts in SIMD where int64 -> float
+    // needs AVX-512. An idle interval has both deltas 0.
+    const int activeDiff = static_cast<int>(active - lastActive[core]);
+    const int totalDiff = static_cast<int>(total - lastTotal[core]);
+    lastActive[core] = active;
+    lastTotal[core] = total;
+    utilization[core] = static_cast<float>(activeDiff) /
+                        static_cast<float>(totalDiff > 0 ? totalDiff : 1);
+  }
+}
+
+// Utilisation since boot, for a first sample: the counters themselves can
+// exceed 32 bits, so this pass stays in 64 bits. It also seeds the last
+// values for CoreDeltas.
+void CoreTotals(const LinuxParser::CoreTimes& cores, long* lastActive,
+                long* lastTotal, float* utilization) {
+  using namespace LinuxParser;
+  for (int core = 0; core < cores.count; ++core) {
+    const long active =
+        cores.State(kUser_)[core] + cores.State(kNice_)[core] +
+        cores.State(kSystem_)[core] + cores.State(kIRQ_)[core] +
+        cores.State(kSoftIRQ_)[core] + cores.State(kSteal_)[core];
+    const long total =
+        active + cores.State(kIdle_)[core] + cores.State(kIOwait_)[core];
+    lastActive[core] = active;
+    lastTotal[core] = total;
+    utilization[core] = total > 0 ? static_cast<float>(
+                                        static_cast<double>(active) / total)
+                                  : 0;
+  }
+}
+}  // namespace
+
+void Processor::UpdateCores(const LinuxParser::CoreTimes& cores) {
+  const std::size_t count = cores.count;
+  if (cores_.size() != count) {
+    // First sample, or the set of cores changed: as for the aggregate,
+    // report the average since boot.
+    lastCoreActive_.resize(count);
+    lastCoreTotal_.resize(count);
+    cores_.resize(count);
+    CoreTotals(cores, lastCoreActive_.data(), lastCoreTotal_.data(),
+               cores_.data());
+    return;
   }
-}
\ No newline at end of file
+  using namespace LinuxParser;
+  CoreDeltas(cores.State(kUser_), cores.State(kNice_), cores.State(kSystem_),
+             cores.State(kIdle_), cores.State(kIOwait_), cores.State(kIRQ_),
+             cores.State(kSoftIRQ_), cores.State(kSteal_),
+             lastCoreActive_.data(), lastCoreTotal_.data(), cores_.data(),
+             count);
+}
+
+// DONE: Return the aggregate CPU utilization
+float Processor::Utilization() { return utilization_; }
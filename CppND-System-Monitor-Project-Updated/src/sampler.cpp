@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "sampler.h"
+
+Sampler::Sampler(System& system, std::chrono::milliseconds interval, int rows,
+                 Listener listener)
+    : system_(system),
+      interval_(interval),
+      rows_(rows),
+      listener_(std::move(listener)),
+      thread_([this] { Run(); }) {}
+
+Sampler::~Sampler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+std::shared_ptr<const DisplaySnapshot> Sampler::Latest() const {
+  // Acquire pairs with the sampler's release, so the slot taken over is
+  // fully written.
+  if (middle_.load(std::memory_order_relaxed) & kFresh)
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~kFresh;
+  return slots_[front_];
+}
+
+void Sampler::Publish(std::shared_ptr<const DisplaySnapshot> snapshot) {
+  slots_[back_] = std::move(snapshot);
+  back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & ~kFresh;
+}
+
+void Sampler::Run() {
+  auto next = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    lock.unlock();
+    std::shared_ptr<const DisplaySnapshot> snapshot = Sample();
+    Publish(snapshot);
+    if (listener_) listener_(snapshot);
+    lock.lock();
+    // Ticks stay on a fixed grid; a sample that overran skips the ticks it
+    // missed instead of firing them back to back.
+    next += interval_;
+    const auto now = std::chrono::steady_clock::now();
+    if (next < now) next = now;
+    wake_.wait_until(lock, next, [this] { return stop_; });
+  }
+}
+
+std::shared_ptr<const DisplaySnapshot> Sampler::Sample() {
+  auto snapshot = std::make_shared<DisplaySnapshot>();
+  snapshot->time = std::chrono::system_clock::now();
+  system_.Refresh();
+  snapshot->operatingSystem = system_.OperatingSystem();
+  snapshot->kernel = system_.Kernel();
+  snapshot->cpu = system_.Cpu().Utilization();
+  snapshot->cores = system_.Cpu().CoreUtilization();
+  snapshot->memory = system_.MemoryUtilization();
+  snapshot->totalProcesses = system_.TotalProcesses();
+  snapshot->runningProcesses = system_.RunningProcesses();
+  snapshot->uptime = system_.UpTime();
+  snapshot->disks = system_.Io().Disks();
+  snapshot->interfaces = system_.Io().Interfaces();
+  for (int tier = 0; tier < MetricHistory::kTiers; ++tier) {
+    snapshot->cpuHistory[tier].Assign(system_.CpuHistory().Tier(tier));
+    snapshot->memoryHistory[tier].Assign(system_.MemoryHistory().Tier(tier));
+  }
+
+  const std::vector<Process*>& processes = system_.TopProcesses(rows_);
+  const std::size_t rows = std::min<std::size_t>(rows_, processes.size());
+  snapshot->processes.reserve(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    Process& process = *processes[i];
+    snapshot->processes.push_back({process.Pid(), process.User(),
+                                   process.CpuUtilization(), process.RamKb(),
+                                   process.PssKb(), process.UssKb(),
+                                   process.UpTime(), process.Command(), {}});
+    // Reading the row's figures above started its history.
+    if (const Process::History* history = process.Tracked())
+      snapshot->processes.back().cpuHistory.Assign(history->cpu);
+  }
+  return snapshot;
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <thread>
+
+#include "sampler_pool.h"
+
+namespace {
+// Indices claimed per atomic increment; large enough to keep the counter
+// off the hot path, small enough to balance the tail.
+constexpr std::size_t kChunk = 32;
+}  // namespace
+
+int SamplerPool::DefaultThreads() {
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  return std::clamp(hardware, 1, 4);
+}
+
+SamplerPool::SamplerPool(int threads) {
+  for (int i = 1; i < threads; ++i) workers_.emplace_back([this] { Work(); });
+}
+
+SamplerPool::~SamplerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+void SamplerPool::ForEach(std::size_t count,
+                          const std::function<void(std::size_t)>& task) {
+  if (workers_.empty() || count <= kChunk) {
+    for (std::size_t i = 0; i < count; ++i) task(i);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_.store(0, std::memory_order_relaxed);
+    busy_ = static_cast<int>(workers_.size());
+    ++generation_;
+  }
+  start_.notify_all();
+  RunChunks();
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0; });
+  task_ = nullptr;
+}
+
+void SamplerPool::Work() {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+    RunChunks();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_ > 0) continue;
+    }
+    done_.notify_one();
+  }
+}
+
+void SamplerPool::RunChunks() {
+  while (true) {
+    const std::size_t begin =
+        next_.fetch_add(kChunk, std::memory_order_relaxed);
+    if (begin >= count_) return;
+    const std::size_t end = std::min(begin + kChunk, count_);
+    for (std::size_t i = begin; i < end; ++i) (*task_)(i);
+  }
+}
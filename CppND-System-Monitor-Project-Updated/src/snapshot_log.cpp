@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "snapshot_log.h"
+#include "varint.h"
+
+namespace SnapshotLog {
+
+namespace {
+// cpu, memory, total processes, running processes, uptime; cores follow.
+constexpr std::size_t kFixedFigures = 5;
+constexpr double kScale = 10000;
+
+long long Scaled(float fraction) { return std::llround(fraction * kScale); }
+float Unscaled(long long value) { return static_cast<float>(value / kScale); }
+
+long long Milliseconds(std::chrono::system_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+std::chrono::system_clock::time_point TimePoint(long long ms) {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::milliseconds(ms)));
+}
+
+void PutRaw(const std::string& text, std::string& out) {
+  Varint::Put(out, text.size());
+  out += text;
+}
+
+bool GetRaw(const char** cursor, const char* end, std::string& text) {
+  std::uint64_t length;
+  if (!Varint::Get(cursor, end, length) ||
+      length > static_cast<std::uint64_t>(end - *cursor))
+    return false;
+  text.assign(*cursor, length);
+  *cursor += length;
+  return true;
+}
+
+// Reads a zigzag delta and adds it to `value`.
+bool GetDelta(const char** cursor, const char* end, long long& value) {
+  std::int64_t delta;
+  if (!Varint::GetSigned(cursor, end, delta)) return false;
+  value += delta;
+  return true;
+}
+}  // namespace
+
+void Writer::PutString(const std::string& text, std::string& out) {
+  const auto [it, added] =
+      stringIds_.try_emplace(text, state_.strings.size());
+  Varint::Put(out, it->second);
+  if (!added) return;
+  state_.strings.push_back(text);
+  PutRaw(text, out);
+}
+
+void Writer::Encode(const DisplaySnapshot& snapshot, std::string& out) {
+  if (!headerWritten_) {
+    out.append(kMagic, sizeof(kMagic));
+    Varint::Put(out, kVersion);
+    headerWritten_ = true;
+  }
+  const std::size_t figures = kFixedFigures + snapshot.cores.size();
+  const bool keyframe = sinceKeyframe_ >= kKeyframeInterval ||
+                        figures != state_.figures.size() ||
+                        snapshot.operatingSystem != operatingSystem_ ||
+                        snapshot.kernel != kernel_;
+  const long long time = Milliseconds(snapshot.time);
+  payload_.clear();
+  if (keyframe) {
+    // Deltas against zero are the values themselves.
+    Varint::Put(payload_, time);
+    Varint::Put(payload_, snapshot.cores.size());
+    state_.figures.assign(figures, 0);
+    state_.rows.clear();
+    state_.disks.clear();
+    state_.interfaces.clear();
+    state_.strings.clear();
+    stringIds_.clear();
+    sinceKeyframe_ = 0;
+  } else {
+    Varint::PutSigned(payload_, time - state_.time);
+  }
+  ++sinceKeyframe_;
+  state_.time = time;
+
+  auto put = [this](long long value, long long& previous) {
+    Varint::PutSigned(payload_, value - previous);
+    previous = value;
+  };
+  std::vector<long long>& previous = state_.figures;
+  put(Scaled(snapshot.cpu), previous[0]);
+  put(Scaled(snapshot.memory), previous[1]);
+  put(snapshot.totalProcesses, previous[2]);
+  put(snapshot.runningProcesses, previous[3]);
+  put(snapshot.uptime, previous[4]);
+  for (std::size_t core = 0; core < snapshot.cores.size(); ++core)
+    put(Scaled(snapshot.cores[core]), previous[kFixedFigures + core]);
+
+  if (keyframe) {
+    operatingSystem_ = snapshot.operatingSystem;
+    kernel_ = snapshot.kernel;
+    PutRaw(operatingSystem_, payload_);
+    PutRaw(kernel_, payload_);
+  }
+
+  // Rows are compared by rank; the busiest processes mostly keep theirs
+  // from one sample to the next.
+  Varint::Put(payload_, snapshot.processes.size());
+  state_.rows.resize(snapshot.processes.size());
+  for (std::size_t i = 0; i < snapshot.processes.size(); ++i) {
+    const ProcessRow& process = snapshot.processes[i];
+    State::Row& row = state_.rows[i];
+    put(process.pid, row.pid);
+    put(Scaled(process.cpu), row.cpu);
+    put(process.uptime, row.uptime);
+    put(process.ram, row.ram);
+    put(process.pss, row.pss);
+    put(process.uss, row.uss);
+    PutString(process.user, payload_);
+    PutString(process.command, payload_);
+  }
+
+  Varint::Put(payload_, snapshot.disks.size());
+  state_.disks.resize(snapshot.disks.size() * 4);
+  for (std::size_t i = 0; i < snapshot.disks.size(); ++i) {
+    const DiskRate& disk = snapshot.disks[i];
+    long long* previous = &state_.disks[i * 4];
+    PutString(disk.name, payload_);
+    put(std::llround(disk.readBytes), previous[0]);
+    put(std::llround(disk.writeBytes), previous[1]);
+    put(std::llround(disk.reads * 10), previous[2]);
+    put(std::llround(disk.writes * 10), previous[3]);
+  }
+  Varint::Put(payload_, snapshot.interfaces.size());
+  state_.interfaces.resize(snapshot.interfaces.size() * 2);
+  for (std::size_t i = 0; i < snapshot.interfaces.size(); ++i) {
+    const NetRate& interface = snapshot.interfaces[i];
+    long long* previous = &state_.interfaces[i * 2];
+    PutString(interface.name, payload_);
+    put(std::llround(interface.rxBytes), previous[0]);
+    put(std::llround(interface.txBytes), previous[1]);
+  }
+
+  out += keyframe ? 'K' : 'D';
+  Varint::Put(out, payload_.size());
+  out += payload_;
+}
+
+bool Reader::Open(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) return false;
+  data_.clear();
+  char chunk[1 << 16];
+  std::size_t n;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+    data_.append(chunk, n);
+  std::fclose(file);
+
+  index_.clear();
+  keyframes_.clear();
+  cpu_.clear();
+  memory_.clear();
+  position_ = 0;
+  version_ = 0;
+  end_ = 0;
+  const char* cursor = data_.data();
+  const char* const end = cursor + data_.size();
+  std::uint64_t version;
+  if (data_.size() < sizeof(kMagic) ||
+      std::memcmp(cursor, kMagic, sizeof(kMagic)) != 0)
+    return false;
+  cursor += sizeof(kMagic);
+  if (!Varint::Get(&cursor, end, version) || version == 0 ||
+      version > INT_MAX)
+    return false;
+  version_ = static_cast<int>(version);
+  if (version_ != kVersion) return false;
+  end_ = static_cast<std::size_t>(cursor - data_.data());
+
+  // Only the leading figures of each payload are decoded here: the time,
+  // and the CPU and memory utilisation that sparklines need.
+  long long time = 0, cpu = 0, memory = 0;
+  while (cursor < end) {
+    const char kind = *cursor++;
+    std::uint64_t length;
+    if ((kind != 'K' && kind != 'D') || !Varint::Get(&cursor, end, length) ||
+        length > static_cast<std::uint64_t>(end - cursor))
+      break;
+    const Entry entry{static_cast<std::size_t>(cursor - data_.data()),
+                      static_cast<std::size_t>(length), kind == 'K', 0};
+    const char* field = cursor;
+    const char* const fieldsEnd = cursor + length;
+    cursor = fieldsEnd;
+    if (entry.keyframe) {
+      std::uint64_t absolute, cores;
+      if (!Varint::Get(&field, fieldsEnd, absolute) ||
+          !Varint::Get(&field, fieldsEnd, cores))
+        break;
+      time = static_cast<long long>(absolute);
+      cpu = memory = 0;
+    } else {
+      if (index_.empty() || !GetDelta(&field, fieldsEnd, time)) break;
+    }
+    if (!GetDelta(&field, fieldsEnd, cpu) ||
+        !GetDelta(&field, fieldsEnd, memory))
+      break;
+    if (entry.keyframe) keyframes_.push_back(index_.size());
+    index_.push_back(entry);
+    index_.back().time = time;
+    cpu_.push_back(Unscaled(cpu));
+    memory_.push_back(Unscaled(memory));
+    end_ = entry.offset + entry.length;
+  }
+  position_ = index_.size();
+  return !index_.empty();
+}
+
+std::chrono::system_clock::time_point Reader::Time(std::size_t record) const {
+  return TimePoint(index_[record].time);
+}
+
+std::size_t Reader::Find(std::chrono::system_clock::time_point time) const {
+  const long long ms = Milliseconds(time);
+  auto after = std::upper_bound(
+      index_.begin(), index_.end(), ms,
+      [](long long value, const Entry& entry) { return value < entry.time; });
+  return after == index_.begin() ? 0 : after - index_.begin() - 1;
+}
+
+bool Reader::Decode(const Entry& entry) {
+  const char* cursor = data_.data() + entry.offset;
+  const char* const end = cursor + entry.length;
+  DisplaySnapshot& snapshot = current_;
+  if (entry.keyframe) {
+    std::uint64_t time, cores;
+    if (!Varint::Get(&cursor, end, time) ||
+        !Varint::Get(&cursor, end, cores) ||
+        cores > static_cast<std::uint64_t>(end - cursor))
+      return false;
+    state_.time = static_cast<long long>(time);
+    state_.figures.assign(kFixedFigures + cores, 0);
+    state_.rows.clear();
+    state_.disks.clear();
+    state_.interfaces.clear();
+    state_.strings.clear();
+  } else if (!GetDelta(&cursor, end, state_.time)) {
+    return false;
+  }
+  snapshot.time = TimePoint(state_.time);
+  for (long long& figure : state_.figures)
+    if (!GetDelta(&cursor, end, figure)) return false;
+  const std::vector<long long>& figures = state_.figures;
+  snapshot.cpu = Unscaled(figures[0]);
+  snapshot.memory = Unscaled(figures[1]);
+  snapshot.totalProcesses = static_cast<int>(figures[2]);
+  snapshot.runningProcesses = static_cast<int>(figures[3]);
+  snapshot.uptime = static_cast<long>(figures[4]);
+  snapshot.cores.resize(figures.size() - kFixedFigures);
+  for (std::size_t core = 0; core < snapshot.cores.size(); ++core)
+    snapshot.cores[core] = Unscaled(figures[kFixedFigures + core]);
+  if (entry.keyframe && (!GetRaw(&cursor, end, snapshot.operatingSystem) ||
+                         !GetRaw(&cursor, end, snapshot.kernel)))
+    return false;
+
+  auto getString = [&](std::string& text) {
+    std::uint64_t id;
+    if (!Varint::Get(&cursor, end, id) || id > state_.strings.size())
+      return false;
+    if (id < state_.strings.size()) {
+      text = state_.strings[id];
+      return true;
+    }
+    if (!GetRaw(&cursor, end, text)) return false;
+    state_.strings.push_back(text);
+    return true;
+  };
+  std::uint64_t rows;
+  if (!Varint::Get(&cursor, end, rows) ||
+      rows > static_cast<std::uint64_t>(end - cursor))
+    return false;
+  state_.rows.resize(rows);
+  snapshot.processes.resize(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    State::Row& row = state_.rows[i];
+    ProcessRow& process = snapshot.processes[i];
+    if (!GetDelta(&cursor, end, row.pid) ||
+        !GetDelta(&cursor, end, row.cpu) ||
+        !GetDelta(&cursor, end, row.uptime) ||
+        !GetDelta(&cursor, end, row.ram) || !GetDelta(&cursor, end, row.pss) ||
+        !GetDelta(&cursor, end, row.uss) || !getString(process.user) ||
+        !getString(process.command))
+      return false;
+    process.pid = static_cast<int>(row.pid);
+    process.cpu = Unscaled(row.cpu);
+    process.uptime = static_cast<long>(row.uptime);
+    process.ram = static_cast<long>(row.ram);
+    process.pss = static_cast<long>(row.pss);
+    process.uss = static_cast<long>(row.uss);
+  }
+
+  std::uint64_t disks, interfaces;
+  if (!Varint::Get(&cursor, end, disks) ||
+      disks > static_cast<std::uint64_t>(end - cursor))
+    return false;
+  state_.disks.resize(disks * 4);
+  snapshot.disks.resize(disks);
+  for (std::size_t i = 0; i < disks; ++i) {
+    long long* figures = &state_.disks[i * 4];
+    DiskRate& disk = snapshot.disks[i];
+    if (!getString(disk.name)) return false;
+    for (int figure = 0; figure < 4; ++figure)
+      if (!GetDelta(&cursor, end, figures[figure])) return false;
+    disk.readBytes = static_cast<float>(figures[0]);
+    disk.writeBytes = static_cast<float>(figures[1]);
+    disk.reads = static_cast<float>(figures[2]) / 10;
+    disk.writes = static_cast<float>(figures[3]) / 10;
+  }
+  if (!Varint::Get(&cursor, end, interfaces) ||
+      interfaces > static_cast<std::uint64_t>(end - cursor))
+    return false;
+  state_.interfaces.resize(interfaces * 2);
+  snapshot.interfaces.resize(interfaces);
+  for (std::size_t i = 0; i < interfaces; ++i) {
+    long long* figures = &state_.interfaces[i * 2];
+    NetRate& interface = snapshot.interfaces[i];
+    if (!getString(interface.name) || !GetDelta(&cursor, end, figures[0]) ||
+        !GetDelta(&cursor, end, figures[1]))
+      return false;
+    interface.rxBytes = static_cast<float>(figures[0]);
+    interface.txBytes = static_cast<float>(figures[1]);
+  }
+
+  // As while recording, a row's history lasts only while it is listed.
+  std::unordered_map<int, Ring<float, 8>> history;
+  history.reserve(rows);
+  for (ProcessRow& process : snapshot.processes) {
+    auto it = rowHistory_.find(process.pid);
+    Ring<float, 8>& ring = history[process.pid];
+    if (it != rowHistory_.end()) ring = it->second;
+    ring.Push(process.cpu);
+    process.cpuHistory.Assign(ring);
+  }
+  rowHistory_.swap(history);
+  return true;
+}
+
+// The newest points of history tier `tier` as MetricHistory held them
+// after `record`: the means of consecutive groups of samples counted from
+// the first record.
+template <std::size_t Length>
+void Reader::FillHistory(const std::vector<float>& series, std::size_t record,
+                         int tier, Sparkline<Length>& sparkline) const {
+  const std::size_t group = MetricHistory::kSamplesPerPoint[tier];
+  const std::size_t points = (record + 1) / group;
+  const std::size_t shown = std::min(points, Length);
+  for (std::size_t i = 0; i < shown; ++i) {
+    const std::size_t first = (points - shown + i) * group;
+    float sum = 0;
+    for (std::size_t j = first; j < first + group; ++j) sum += series[j];
+    sparkline.values[i] = sum / group;
+  }
+  sparkline.size = shown;
+}
+
+std::shared_ptr<const DisplaySnapshot> Reader::Snapshot(std::size_t record) {
+  if (record >= index_.size()) return nullptr;
+  // Playing forward continues from the last record decoded; anything else
+  // starts over at a keyframe, early enough for the row sparklines to fill.
+  if (position_ >= index_.size() || record < position_ ||
+      record - position_ > kKeyframeInterval) {
+    const std::size_t warmup = record >= 7 ? record - 7 : 0;
+    auto keyframe =
+        std::upper_bound(keyframes_.begin(), keyframes_.end(), warmup);
+    position_ = keyframe == keyframes_.begin() ? 0 : *std::prev(keyframe);
+    rowHistory_.clear();
+    if (!Decode(index_[position_])) {
+      position_ = index_.size();
+      return nullptr;
+    }
+  }
+  while (position_ < record) {
+    if (!Decode(index_[++position_])) {
+      position_ = index_.size();
+      return nullptr;
+    }
+  }
+
+  auto snapshot = std::make_shared<DisplaySnapshot>(current_);
+  for (int tier = 0; tier < MetricHistory::kTiers; ++tier) {
+    FillHistory(cpu_, record, tier, snapshot->cpuHistory[tier]);
+    FillHistory(memory_, record, tier, snapshot->memoryHistory[tier]);
+  }
+  return snapshot;
+}
+
+}  // namespace SnapshotLog
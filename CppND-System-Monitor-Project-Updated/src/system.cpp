@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "linux_parser.h"
@@ -16,38 +17,154 @@ using std::string;
 using std::vector;
 using std::sort;
 
-System::System() { cpu_ = Processor(); }
+// The kernel and OS names cannot change while the monitor runs.
+System::System(int samplerThreads, bool procEvents)
+    : kernel_(LinuxParser::Kernel()),
+      operatingSystem_(LinuxParser::OperatingSystem()),
+      pool_(samplerThreads) {
+  // Events describe the live system, so not a redirected /proc tree.
+  if (procEvents &&
+      LinuxParser::ProcDirectory() == LinuxParser::kProcDirectory) {
+    events_ = std::make_unique<ProcEvents>();
+    if (!events_->Listening()) events_.reset();
+  }
+  Refresh();
+}
+
+void System::Refresh() {
+  if (!LinuxParser::ReadSystemSnapshot(files_, snapshot_)) return;
+  cpu_.Update(snapshot_.cpu, snapshot_.cores);
+  io_.Update(snapshot_.disks, snapshot_.interfaces, snapshot_.uptime);
+  RecordHistory();
+  users_.Refresh();
+  // /proc/stat counts jiffies summed over all cores.
+  const long jiffies = LinuxParser::ActiveJiffies(snapshot_.cpu) +
+                       LinuxParser::IdleJiffies(snapshot_.cpu);
+  UpdateProcesses((jiffies - lastJiffies_) / snapshot_.cpu_count);
+  lastJiffies_ = jiffies;
+}
+
+void System::RecordHistory() {
+  cpuHistory_.Add(cpu_.Utilization());
+  memoryHistory_.Add(MemoryUtilization());
+  const std::vector<float>& cores = cpu_.CoreUtilization();
+  // A changed core count starts the per-core histories over.
+  if (coreHistory_.size() != cores.size())
+    coreHistory_.assign(cores.size(), {});
+  for (std::size_t core = 0; core < cores.size(); ++core)
+    coreHistory_[core].Add(cores[core]);
+}
+
+// Brings pids_ up to date, from events when they can be trusted and by
+// listing /proc otherwise.
+void System::ListPids() {
+  if (events_ != nullptr && sinceRescan_ < kRescanInterval) {
+    if (events_->Apply(pids_, execs_)) {
+      ++sinceRescan_;
+      // Exec keeps the pid and start time but replaces the command line.
+      auto record = processes_.begin();
+      for (int pid : execs_) {
+        while (record != processes_.end() && record->Pid() < pid) ++record;
+        if (record != processes_.end() && record->Pid() == pid) record->Exec();
+      }
+      return;
+    }
+  }
+  // Events pending from before the listing are reflected in it; anything
+  // after is applied on top next tick, which is harmless either way since
+  // applying events is idempotent.
+  if (events_ != nullptr) events_->Discard();
+  LinuxParser::Pids(pids_);
+  std::sort(pids_.begin(), pids_.end());
+  sinceRescan_ = 0;
+}
+
+void System::UpdateProcesses(const long elapsedTicks) {
+  ListPids();
+
+  // The reads dominate the cost, so only they run in parallel; the merge
+  // below is a single pass over memory.
+  // Pair each pid with its record first, so that records holding an open
+  // stat file read through it. Records left unpaired belong to processes
+  // that have exited.
+  matches_.resize(pids_.size());
+  auto record = processes_.begin();
+  for (std::size_t i = 0; i < pids_.size(); ++i) {
+    while (record != processes_.end() && record->Pid() < pids_[i]) ++record;
+    matches_[i] = record != processes_.end() && record->Pid() == pids_[i]
+                      ? &*record
+                      : nullptr;
+  }
+  samples_.resize(pids_.size());
+  pool_.ForEach(pids_.size(), [this](std::size_t i) {
+    Sample& sample = samples_[i];
+    sample.ok = matches_[i] != nullptr
+                    ? matches_[i]->ReadStat(sample.stat)
+                    : LinuxParser::ReadPidStat(pids_[i], sample.stat);
+  });
+
+  // pids_ keeps only the pids that could be read, for events to update.
+  std::size_t live = 0;
+  for (std::size_t i = 0; i < pids_.size(); ++i) {
+    const int pid = pids_[i];
+    const LinuxParser::PidStat& stat = samples_[i].stat;
+    Process* match = matches_[i];
+    if (!samples_[i].ok) continue;  // Exited since the listing.
+    pids_[live++] = pid;
+    if (match != nullptr && match->StartTime() == stat.starttime) {
+      retired_.push_back(std::move(*match));
+    } else {
+      // New pid, or a reused one whose old record must not leak its counts.
+      retired_.emplace_back(pid, stat.starttime, &users_);
+    }
+    retired_.back().Update(stat, elapsedTicks, snapshot_.uptime);
+  }
+  pids_.resize(live);
+  processes_.swap(retired_);
+  retired_.clear();  // Closes any files the exited records still held.
+
+  // Ordered on demand; the display only ever needs its visible rows.
+  byCpu_.clear();
+  for (Process& process : processes_) byCpu_.push_back(&process);
+  sorted_ = 0;
+}
 
 // DONE: Return the system's CPU
 Processor& System::Cpu() { return cpu_; }
 
 // DONE: Return a container composed of the system's processes
-vector<Process>& System::Processes() { 
-	processes_ = {};
-	vector<int> pids = LinuxParser::Pids();
-
-	for (int pid : pids) {
-		processes_.push_back(Process(pid));
-	}
-	std::sort(processes_.begin(), processes_.end(), std::greater<Process>());
-	
-	return processes_;
+vector<Process*>& System::Processes() { return TopProcesses(byCpu_.size()); }
+
+vector<Process*>& System::TopProcesses(size_t n) {
+  n = std::min(n, byCpu_.size());
+  if (n <= sorted_) return byCpu_;
+  auto busier = [](const Process* a, const Process* b) { return *a > *b; };
+  auto top = byCpu_.begin() + n;
+  if (top != byCpu_.end())
+    std::nth_element(byCpu_.begin(), top, byCpu_.end(), busier);
+  std::sort(byCpu_.begin(), top, busier);
+  sorted_ = n;
+  return byCpu_;
 }
 
 // DONE: Return the system's kernel identifier (string)
-std::string System::Kernel() { return LinuxParser::Kernel(); }
+std::string System::Kernel() { return kernel_; }
 
 // DONE: Return the system's memory utilization
-float System::MemoryUtilization() { return LinuxParser::MemoryUtilization(); }
+float System::MemoryUtilization() {
+  if (snapshot_.mem_total <= 0) return 0;
+  return static_cast<float>(snapshot_.mem_total - snapshot_.mem_free) /
+         snapshot_.mem_total;
+}
 
 // DONE: Return the operating system name
-std::string System::OperatingSystem() { return LinuxParser::OperatingSystem();  }
+std::string System::OperatingSystem() { return operatingSystem_; }
 
 // DONE: Return the number of processes actively running on the system
-int System::RunningProcesses() { return LinuxParser::RunningProcesses(); }
+int System::RunningProcesses() { return snapshot_.running_processes; }
 
 // DONE: Return the total number of processes on the system
-int System::TotalProcesses() { return LinuxParser::TotalProcesses(); }
+int System::TotalProcesses() { return snapshot_.total_processes; }
 
 // DONE: Return the number of seconds since the system started running
-long int System::UpTime() { return LinuxParser::UpTime(); }
\ No newline at end of file
+long int System::UpTime() { return static_cast<long>(snapshot_.uptime); }
\ No newline at end of file
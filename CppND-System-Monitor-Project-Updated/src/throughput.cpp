@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "linux_parser.h"
+#include "throughput.h"
+
+namespace {
+// Increase of a counter from `previous` to `current`. Counters that are 32
+// bits wide in the kernel (diskstats on 32-bit kernels, the statistics of
+// some network drivers) wrap around at 2^32; one that steps back from the top
+// quarter of that range to below it wrapped. Any other counter that goes
+// backwards was reset, e.g. by bouncing the interface or reloading its
+// driver, and counts as idle.
+double Delta(unsigned long long previous, unsigned long long current) {
+  if (current >= previous) return static_cast<double>(current - previous);
+  constexpr unsigned long long kWrap = 1ULL << 32;
+  constexpr unsigned long long kNearWrap = 0xC0000000ULL;
+  if (previous >= kNearWrap && previous < kWrap && current < kWrap)
+    return static_cast<double>(current + kWrap - previous);
+  return 0;
+}
+
+// The previous counters of the device at `index` of the current list, or
+// null if it has none. Devices rarely change, so it is normally at the same
+// index.
+template <typename Counters>
+const Counters* Previous(const std::vector<Counters>& last,
+                         const std::string& name, std::size_t index) {
+  if (index < last.size() && last[index].name == name) return &last[index];
+  for (const Counters& counters : last)
+    if (counters.name == name) return &counters;
+  return nullptr;
+}
+}  // namespace
+
+void Throughput::Update(
+    const std::vector<LinuxParser::DiskCounters>& disks,
+    const std::vector<LinuxParser::NetCounters>& interfaces, double uptime) {
+  const double seconds = uptime - lastUptime_;
+  UpdateDisks(disks, seconds);
+  UpdateInterfaces(interfaces, seconds);
+  // Copied, not swapped: assigning reuses both lists' storage.
+  lastDisks_ = disks;
+  lastInterfaces_ = interfaces;
+  lastUptime_ = uptime;
+  first_ = false;
+}
+
+void Throughput::UpdateDisks(
+    const std::vector<LinuxParser::DiskCounters>& disks, double seconds) {
+  constexpr double kSectorBytes = 512;
+  const LinuxParser::DiskCounters boot{};
+  disks_.resize(disks.size());
+  for (std::size_t i = 0; i < disks.size(); ++i) {
+    const LinuxParser::DiskCounters& now = disks[i];
+    const LinuxParser::DiskCounters* before =
+        first_ ? &boot : Previous(lastDisks_, now.name, i);
+    DiskRate& rate = disks_[i];
+    rate.name = now.name;
+    if (before == nullptr || seconds <= 0) {
+      rate.readBytes = rate.writeBytes = rate.reads = rate.writes = 0;
+      continue;
+    }
+    rate.readBytes = static_cast<float>(
+        Delta(before->sectors_read, now.sectors_read) * kSectorBytes /
+        seconds);
+    rate.writeBytes = static_cast<float>(
+        Delta(before->sectors_written, now.sectors_written) * kSectorBytes /
+        seconds);
+    rate.reads = static_cast<float>(Delta(before->reads, now.reads) / seconds);
+    rate.writes =
+        static_cast<float>(Delta(before->writes, now.writes) / seconds);
+  }
+}
+
+void Throughput::UpdateInterfaces(
+    const std::vector<LinuxParser::NetCounters>& interfaces, double seconds) {
+  const LinuxParser::NetCounters boot{};
+  interfaces_.resize(interfaces.size());
+  for (std::size_t i = 0; i < interfaces.size(); ++i) {
+    const LinuxParser::NetCounters& now = interfaces[i];
+    const LinuxParser::NetCounters* before =
+        first_ ? &boot : Previous(lastInterfaces_, now.name, i);
+    NetRate& rate = interfaces_[i];
+    rate.name = now.name;
+    if (before == nullptr || seconds <= 0) {
+      rate.rxBytes = rate.txBytes = 0;
+      continue;
+    }
+    rate.rxBytes =
+        static_cast<float>(Delta(before->rx_bytes, now.rx_bytes) / seconds);
+    rate.txBytes =
+        static_cast<float>(Delta(before->tx_bytes, now.tx_bytes) / seconds);
+  }
+}
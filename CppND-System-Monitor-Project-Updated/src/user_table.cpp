@@ -0,0 +1,50 @@
+#include <sys/stat.h>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "proc_buffer.h"
+#include "user_table.h"
+
+UserTable::UserTable(std::string path) : path_(std::move(path)) { Refresh(); }
+
+bool UserTable::Refresh() {
+  struct stat status;
+  if (stat(path_.c_str(), &status) != 0) return false;
+  if (status.st_mtim.tv_sec == mtime_.tv_sec &&
+      status.st_mtim.tv_nsec == mtime_.tv_nsec && status.st_size == size_ &&
+      status.st_ino == inode_)
+    return false;
+  mtime_ = status.st_mtim;
+  size_ = status.st_size;
+  inode_ = status.st_ino;
+  Load();
+  return true;
+}
+
+void UserTable::Load() {
+  ProcBuffer buffer;
+  std::string_view passwd = buffer.Read(path_.c_str());
+  names_.clear();
+  // name:password:uid:gid:...
+  while (!passwd.empty()) {
+    std::string_view line = ProcScan::NextLine(passwd);
+    const std::size_t name_end = line.find(':');
+    const std::size_t uid_begin = line.find(':', name_end + 1);
+    if (name_end == std::string_view::npos ||
+        uid_begin == std::string_view::npos)
+      continue;
+    std::string_view uid = line.substr(uid_begin + 1);
+    uid = uid.substr(0, uid.find(':'));
+    const int id = ProcScan::Number<int>(uid, -1);
+    // The first entry for a uid wins, as with getpwuid().
+    if (id >= 0) names_.emplace(id, line.substr(0, name_end));
+  }
+}
+
+const std::string& UserTable::Name(int uid) {
+  auto found = names_.find(uid);
+  if (found == names_.end())
+    found = names_.emplace(uid, std::to_string(uid)).first;
+  return found->second;
+}
@@ -0,0 +1,48 @@
+#include <string>
+#include <string_view>
+
+#include "cell_grid.h"
+#include "test_check.h"
+
+static std::string Row(const CellGrid& grid, int row) {
+  std::string text;
+  for (int column = 0; column < grid.Columns(); ++column)
+    text += static_cast<char>(grid.Cell(row, column) & A_CHARTEXT);
+  return text;
+}
+
+// Multibyte UTF-8 characters take one cell each, so the text after them
+// keeps its column.
+static void TestUtf8TakesOneCellPerCharacter() {
+  CellGrid grid(1, 12);
+  CHECK(grid.Put(0, 0, "caf\xc3\xa9 \xe2\x82\xac\xf0\x9f\x98\x80x") == 8);
+  CHECK(Row(grid, 0) == "caf? ??x    ");
+}
+
+static void TestControlAndStrayBytes() {
+  CellGrid grid(1, 10);
+  CHECK(grid.Put(0, 1, "a\tb\x80\x7f" "c") == 7);
+  CHECK(Row(grid, 0) == " a?b??c   ");
+}
+
+// The arguments of a command line are separated by NULs.
+static void TestNulShowsAsSpace() {
+  CellGrid grid(1, 10);
+  CHECK(grid.Put(0, 0, std::string_view("ls\0-l\0", 6)) == 6);
+  CHECK(Row(grid, 0) == "ls -l     ");
+}
+
+// Text stops short of the right border column.
+static void TestClipsAtBorder() {
+  CellGrid grid(1, 6);
+  CHECK(grid.Put(0, 2, "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9") == 5);
+  CHECK(Row(grid, 0) == "  ??? ");
+}
+
+int main() {
+  TestUtf8TakesOneCellPerCharacter();
+  TestControlAndStrayBytes();
+  TestNulShowsAsSpace();
+  TestClipsAtBorder();
+  return TestFailures();
+}
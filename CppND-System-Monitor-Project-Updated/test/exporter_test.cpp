@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exporter.h"
+#include "sampler.h"
+#include "test_check.h"
+
+static DisplaySnapshot Sample(std::size_t cores) {
+  DisplaySnapshot snapshot{};
+  snapshot.time =
+      std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+  snapshot.cpu = 0.123456f;
+  snapshot.cores.assign(cores, 0.5f);
+  snapshot.memory = 0.5f;
+  snapshot.uptime = 100;
+  snapshot.processes.push_back(
+      {42, "root", 0.25f, 12345, 678, -1, 7, "init", {}});
+  return snapshot;
+}
+
+// Everything the exporter wrote for `snapshots`, once it has drained.
+static std::string Export(Exporter::Format format,
+                          const std::vector<DisplaySnapshot>& snapshots) {
+  std::FILE* file = std::tmpfile();
+  if (file == nullptr) return {};
+  {
+    Exporter exporter(file, format);
+    for (const DisplaySnapshot& snapshot : snapshots)
+      exporter.Push(std::make_shared<DisplaySnapshot>(snapshot));
+  }
+  std::string text;
+  std::rewind(file);
+  char buffer[4096];
+  std::size_t length;
+  while ((length = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    text.append(buffer, length);
+  std::fclose(file);
+  return text;
+}
+
+// Memory goes out as numbers, or null when unreadable, next to the
+// process's uptime; figures keep more than four digits.
+static void TestJsonFigures() {
+  const std::string json = Export(Exporter::Format::kJsonLines, {Sample(1)});
+  CHECK(json.find("\"cpu\":0.123456") != std::string::npos);
+  CHECK(json.find("\"rss_mb\":12.345,\"pss_mb\":0.678,\"uss_mb\":null,"
+                  "\"uptime\":7,") != std::string::npos);
+}
+
+// A change in the core count changes the columns, so it gets a new header.
+static void TestCsvHeaderFollowsCores() {
+  const std::string csv =
+      Export(Exporter::Format::kCsv, {Sample(1), Sample(1), Sample(2)});
+  const std::string header =
+      "time_ms,cpu,memory,total_processes,running_processes,uptime";
+  const std::size_t first = csv.find(header + ",cpu0\n");
+  CHECK(first == 0);
+  const std::size_t second = csv.find(header + ",cpu0,cpu1\n");
+  CHECK(second != std::string::npos && second > first);
+  CHECK(csv.find(header, first + 1) == second);
+}
+
+int main() {
+  TestJsonFigures();
+  TestCsvHeaderFollowsCores();
+  return TestFailures();
+}
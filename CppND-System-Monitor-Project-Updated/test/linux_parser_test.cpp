@@ -0,0 +1,125 @@
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "linux_parser.h"
+#include "short_reads.h"
+#include "test_check.h"
+
+static void Write(const std::string& path, const std::string& data) {
+  std::ofstream(path, std::ios::trunc) << data;
+}
+
+// `disks` disks "vdN" with two partitions each, then loop and ram devices,
+// in the 20-field layout of current kernels.
+static std::string Diskstats(int disks) {
+  std::string text;
+  auto line = [&text](int minor, const std::string& name, int n) {
+    text += " 252 " + std::to_string(minor) + " " + name + " " +
+            std::to_string(n) + " 0 " + std::to_string(8 * n) + " 3 " +
+            std::to_string(2 * n) + " 0 " + std::to_string(16 * n) +
+            " 5 0 6 7 0 0 0 0 0 0 0 0\n";
+  };
+  for (int disk = 0; disk < disks; ++disk) {
+    const std::string name = "vd" + std::to_string(disk);
+    line(disk * 16, name, disk + 1);
+    line(disk * 16 + 1, name + "p1", 1000);
+    line(disk * 16 + 2, name + "p2", 1000);
+  }
+  line(0, "loop0", 1000);
+  line(0, "ram0", 1000);
+  return text;
+}
+
+static std::string NetDev(int interfaces) {
+  std::string text =
+      "Inter-|   Receive                                                |  "
+      "Transmit\n"
+      " face |bytes    packets errs drop fifo frame compressed multicast|"
+      "bytes    packets errs drop fifo colls carrier compressed\n";
+  for (int i = 0; i < interfaces; ++i)
+    text += "  veth" + std::to_string(i) + ": " + std::to_string(100 * i) +
+            " 1 0 0 0 0 0 0 " + std::to_string(200 * i) + " 2 0 0 0 0 0 0\n";
+  return text;
+}
+
+// Both files run well past a page; every device after the first read must
+// still be parsed.
+static void TestDevicesPastFirstPage(const std::string& root) {
+  constexpr int kDisks = 60, kInterfaces = 200;
+  const std::string diskstats = Diskstats(kDisks);
+  const std::string netdev = NetDev(kInterfaces);
+  CHECK(diskstats.size() > 2 * kShortReadChunk);
+  CHECK(netdev.size() > 2 * kShortReadChunk);
+  Write(root + "/stat",
+        "cpu  1 2 3 4 5 6 7 8 9 10\ncpu0 1 2 3 4 5 6 7 8 9 10\n"
+        "processes 10\nprocs_running 1\n");
+  Write(root + "/meminfo", "MemTotal: 1000 kB\nMemFree: 250 kB\n");
+  Write(root + "/uptime", "123.45 100.00\n");
+  Write(root + "/diskstats", diskstats);
+  Write(root + "/net/dev", netdev);
+
+  LinuxParser::SetProcDirectory(root);
+  LinuxParser::SystemFiles files;
+  LinuxParser::SystemSnapshot snapshot;
+  CHECK(LinuxParser::ReadSystemSnapshot(files, snapshot));
+  CHECK(snapshot.disks.size() == kDisks);
+  for (int disk = 0; disk < kDisks && disk < int(snapshot.disks.size());
+       ++disk) {
+    const LinuxParser::DiskCounters& counters = snapshot.disks[disk];
+    CHECK(counters.name == "vd" + std::to_string(disk));
+    CHECK(counters.reads == unsigned(disk + 1));
+    CHECK(counters.sectors_read == unsigned(8 * (disk + 1)));
+    CHECK(counters.writes == unsigned(2 * (disk + 1)));
+    CHECK(counters.sectors_written == unsigned(16 * (disk + 1)));
+  }
+  CHECK(snapshot.interfaces.size() == kInterfaces);
+  for (int i = 0; i < kInterfaces && i < int(snapshot.interfaces.size());
+       ++i) {
+    const LinuxParser::NetCounters& counters = snapshot.interfaces[i];
+    CHECK(counters.name == "veth" + std::to_string(i));
+    CHECK(counters.rx_bytes == unsigned(100 * i));
+    CHECK(counters.tx_bytes == unsigned(200 * i));
+  }
+
+  // The open files are re-read in place on the next snapshot.
+  Write(root + "/diskstats", Diskstats(1));
+  Write(root + "/net/dev", NetDev(1));
+  CHECK(LinuxParser::ReadSystemSnapshot(files, snapshot));
+  CHECK(snapshot.disks.size() == 1);
+  CHECK(snapshot.interfaces.size() == 1);
+}
+
+// A stat line cut off after the command has no state to read.
+static void TestTruncatedPidStat() {
+  LinuxParser::PidStat stat;
+  CHECK(!LinuxParser::ParsePidStat("123 (x)\n", stat));
+  CHECK(!LinuxParser::ParsePidStat("123 (x) ", stat));
+  CHECK(LinuxParser::ParsePidStat(
+      "123 (a b) S 1 123 123 0 -1 4194560 10 0 0 0 7 3 1 2 20 0 1 0 42 0 0\n",
+      stat));
+  CHECK(stat.state == 'S');
+  CHECK(stat.utime == 7 && stat.stime == 3);
+  CHECK(stat.cutime == 1 && stat.cstime == 2);
+  CHECK(stat.starttime == 42);
+}
+
+int main() {
+  char directory[] = "/tmp/linux_parser_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  const std::string root = directory;
+  mkdir((root + "/net").c_str(), 0700);
+  TestDevicesPastFirstPage(root);
+  TestTruncatedPidStat();
+  for (const char* file :
+       {"/stat", "/meminfo", "/uptime", "/diskstats", "/net/dev"})
+    std::remove((root + file).c_str());
+  rmdir((root + "/net").c_str());
+  rmdir(directory);
+  return TestFailures();
+}
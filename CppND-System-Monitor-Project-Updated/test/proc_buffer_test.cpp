@@ -0,0 +1,58 @@
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "proc_buffer.h"
+#include "short_reads.h"
+#include "test_check.h"
+
+// A file of `lines` diskstats-like lines, well over a page for large counts.
+static std::string Contents(int lines) {
+  std::string text;
+  for (int i = 0; i < lines; ++i)
+    text += "   8       " + std::to_string(i) + " sd" + std::to_string(i) +
+            " 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17\n";
+  return text;
+}
+
+static void TestReadsPastShortReads(const std::string& path) {
+  for (int lines : {1, 80, 1000}) {
+    const std::string text = Contents(lines);
+    std::ofstream(path, std::ios::trunc) << text;
+
+    ProcBuffer buffer;
+    CHECK(buffer.Read(path.c_str()) == text);
+    // The buffer has grown; a smaller file still reads whole.
+    std::ofstream(path, std::ios::trunc) << "short\n";
+    CHECK(buffer.Read(path.c_str()) == "short\n");
+
+    std::ofstream(path, std::ios::trunc) << text;
+    ProcFile file(path);
+    CHECK(file.Read() == text);
+    CHECK(file.Read() == text);  // Re-read through the open descriptor.
+  }
+}
+
+static void TestMissingFile(const std::string& directory) {
+  ProcBuffer buffer;
+  CHECK(buffer.Read((directory + "/missing").c_str()).empty());
+  ProcFile file(directory + "/missing");
+  CHECK(file.Read().empty());
+}
+
+int main() {
+  char directory[] = "/tmp/proc_buffer_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  const std::string path = std::string(directory) + "/diskstats";
+  TestReadsPastShortReads(path);
+  TestMissingFile(directory);
+  std::remove(path.c_str());
+  rmdir(directory);
+  return TestFailures();
+}
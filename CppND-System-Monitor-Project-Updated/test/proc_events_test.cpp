@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <vector>
+
+#include "proc_events.h"
+#include "test_check.h"
+
+static std::vector<int> AddForks(std::vector<int> pids,
+                                 std::vector<int> forks) {
+  std::vector<int> merged;
+  ProcEvents::AddForks(pids, forks, merged);
+  return pids;
+}
+
+// A process that forked and exited within one tick is still added: exits
+// are left to the failed stat read that follows.
+static void TestForkThenExit() {
+  CHECK(AddForks({1, 9}, {5}) == std::vector<int>({1, 5, 9}));
+}
+
+// A pid reused after an exit that was not acted on is already listed, and
+// its fork must not list it twice.
+static void TestExitThenFork() {
+  CHECK(AddForks({1, 5, 9}, {5}) == std::vector<int>({1, 5, 9}));
+}
+
+static void TestDuplicateFork() {
+  CHECK(AddForks({1, 9}, {5, 5}) == std::vector<int>({1, 5, 9}));
+  CHECK(AddForks({}, {3, 3, 3}) == std::vector<int>({3}));
+}
+
+// Forks arrive in event order, not pid order, as pids wrap around.
+static void TestStaysSorted() {
+  const std::vector<int> pids =
+      AddForks({2, 40, 300, 4000}, {32000, 7, 301, 2, 1, 50000, 41});
+  CHECK(pids == std::vector<int>(
+                    {1, 2, 7, 40, 41, 300, 301, 4000, 32000, 50000}));
+  CHECK(std::is_sorted(pids.begin(), pids.end()));
+  CHECK(AddForks({1, 2, 3}, {}) == std::vector<int>({1, 2, 3}));
+}
+
+int main() {
+  TestForkThenExit();
+  TestExitThenFork();
+  TestDuplicateFork();
+  TestStaysSorted();
+  return TestFailures();
+}
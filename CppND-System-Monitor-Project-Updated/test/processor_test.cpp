@@ -0,0 +1,53 @@
+#include <cmath>
+
+#include "linux_parser.h"
+#include "processor.h"
+#include "test_check.h"
+
+using LinuxParser::CoreTimes;
+
+static CoreTimes Cores(int count) {
+  CoreTimes cores;
+  cores.count = count;
+  cores.jiffies.assign((LinuxParser::kGuestNice_ + 1) * count, 0);
+  return cores;
+}
+
+static long& At(CoreTimes& cores, LinuxParser::CPUStates state, int core) {
+  return cores.jiffies[state * cores.count + core];
+}
+
+static bool Near(float a, float b) { return std::fabs(a - b) < 1e-4f; }
+
+// Counters past 2^31 jiffies (248 days at 100 Hz) on the first sample, and
+// again when the number of cores changes, report the average since boot.
+static void TestFirstSampleOfLongUptime() {
+  Processor processor;
+  LinuxParser::CpuTimes total{};
+  CoreTimes cores = Cores(2);
+  At(cores, LinuxParser::kUser_, 0) = 3000000000L;
+  At(cores, LinuxParser::kIdle_, 0) = 1000000000L;
+  At(cores, LinuxParser::kIdle_, 1) = 4000000000L;
+  processor.Update(total, cores);
+  CHECK(Near(processor.CoreUtilization()[0], 0.75f));
+  CHECK(Near(processor.CoreUtilization()[1], 0.f));
+
+  At(cores, LinuxParser::kUser_, 0) += 10;
+  At(cores, LinuxParser::kIdle_, 0) += 30;
+  At(cores, LinuxParser::kSystem_, 1) += 40;
+  processor.Update(total, cores);
+  CHECK(Near(processor.CoreUtilization()[0], 0.25f));
+  CHECK(Near(processor.CoreUtilization()[1], 1.f));
+
+  CoreTimes more = Cores(3);
+  At(more, LinuxParser::kUser_, 2) = 3000000000L;
+  At(more, LinuxParser::kIdle_, 2) = 3000000000L;
+  processor.Update(total, more);
+  CHECK(processor.CoreUtilization().size() == 3);
+  CHECK(Near(processor.CoreUtilization()[2], 0.5f));
+}
+
+int main() {
+  TestFirstSampleOfLongUptime();
+  return TestFailures();
+}
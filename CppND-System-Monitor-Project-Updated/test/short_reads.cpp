@@ -0,0 +1,25 @@
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "short_reads.h"
+
+namespace {
+template <typename Function>
+Function Next(const char* name) {
+  return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+}  // namespace
+
+extern "C" {
+ssize_t read(int fd, void* buffer, size_t size) {
+  static auto next = Next<ssize_t (*)(int, void*, size_t)>("read");
+  return next(fd, buffer, std::min(size, kShortReadChunk));
+}
+
+ssize_t pread(int fd, void* buffer, size_t size, off_t offset) {
+  static auto next = Next<ssize_t (*)(int, void*, size_t, off_t)>("pread");
+  return next(fd, buffer, std::min(size, kShortReadChunk), offset);
+}
+}
@@ -0,0 +1,12 @@
+#ifndef SHORT_READS_H
+#define SHORT_READS_H
+
+#include <cstddef>
+
+// Files under /proc built on seq_file return at most a page per read(), and
+// usually less: a record that would not fit is left for the next call. A
+// test linked with short_reads.cpp has read and pread interposed to serve
+// every file that way, at most kShortReadChunk bytes per call.
+constexpr std::size_t kShortReadChunk = 4000;
+
+#endif
@@ -0,0 +1,91 @@
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "sampler.h"
+#include "snapshot_log.h"
+#include "test_check.h"
+
+static DisplaySnapshot Sample(int second) {
+  DisplaySnapshot snapshot{};
+  snapshot.time = std::chrono::system_clock::time_point(
+      std::chrono::seconds(1700000000 + second));
+  snapshot.operatingSystem = "Debian";
+  snapshot.kernel = "6.1";
+  snapshot.cpu = 0.25f;
+  snapshot.cores = {0.5f, 0.f};
+  snapshot.memory = 0.5f;
+  snapshot.uptime = 100 + second;
+  snapshot.processes.push_back(
+      {42, "root", 0.1f, 1000, 500, -1, 7, "init", {}});
+  snapshot.disks.push_back({"sda", 4096, 0, 1, 0});
+  snapshot.interfaces.push_back({"eth0", 100, 200});
+  return snapshot;
+}
+
+static void Write(const std::string& path, const std::string& data) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+// A log cut off inside its last record still opens, and End() marks where
+// the complete records stop, so an appending run can truncate there.
+static void TestEndOfCompleteRecords(const std::string& path) {
+  SnapshotLog::Writer writer;
+  std::string data;
+  for (int second = 0; second < 3; ++second) writer.Encode(Sample(second), data);
+  Write(path, data);
+  SnapshotLog::Reader reader;
+  CHECK(reader.Open(path));
+  CHECK(reader.Version() == SnapshotLog::kVersion);
+  CHECK(reader.Size() == 3);
+  CHECK(reader.End() == data.size());
+
+  Write(path, data.substr(0, data.size() - 2));
+  CHECK(reader.Open(path));
+  CHECK(reader.Size() == 2);
+  const std::size_t end = reader.End();
+  CHECK(end < data.size() - 2);
+
+  // Appending a new run's records after the cut decodes as one log.
+  SnapshotLog::Writer appended(true);
+  std::string more = data.substr(0, end);
+  appended.Encode(Sample(10), more);
+  Write(path, more);
+  CHECK(reader.Open(path));
+  CHECK(reader.Size() == 3);
+  auto last = reader.Snapshot(2);
+  CHECK(last != nullptr && last->uptime == 110);
+  CHECK(last != nullptr && last->processes.size() == 1 &&
+        last->processes[0].command == "init");
+  CHECK(last != nullptr && last->processes.size() == 1 &&
+        last->processes[0].ram == 1000 && last->processes[0].uss == -1);
+}
+
+static void TestRejectsOtherFiles(const std::string& path) {
+  SnapshotLog::Reader reader;
+  Write(path, "hello\n");
+  CHECK(!reader.Open(path));
+  CHECK(reader.Version() == 0);
+
+  Write(path, std::string("SMON\x7f", 5));
+  CHECK(!reader.Open(path));
+  CHECK(reader.Version() != SnapshotLog::kVersion);
+}
+
+int main() {
+  char directory[] = "/tmp/snapshot_log_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  const std::string path = std::string(directory) + "/monitor.log";
+  TestEndOfCompleteRecords(path);
+  TestRejectsOtherFiles(path);
+  std::remove(path.c_str());
+  rmdir(directory);
+  return TestFailures();
+}
@@ -0,0 +1,109 @@
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "linux_parser.h"
+#include "process.h"
+#include "system.h"
+#include "test_check.h"
+
+static void Write(const std::string& path, const std::string& data) {
+  std::ofstream(path, std::ios::trunc) << data;
+}
+
+// Two cores, `user` jiffies summed over both and nothing else.
+static void WriteStat(const std::string& root, long user) {
+  const std::string half = std::to_string(user / 2);
+  Write(root + "/stat", "cpu  " + std::to_string(user) +
+                            " 0 0 0 0 0 0 0 0 0\ncpu0 " + half +
+                            " 0 0 0 0 0 0 0 0 0\ncpu1 " + half +
+                            " 0 0 0 0 0 0 0 0 0\nprocesses 2\n"
+                            "procs_running 1\n");
+}
+
+static void WritePid(const std::string& root, int pid, long utime,
+                     long long starttime) {
+  const std::string directory = root + "/" + std::to_string(pid);
+  mkdir(directory.c_str(), 0700);
+  Write(directory + "/stat", std::to_string(pid) + " (x) S 1 " +
+                                 std::to_string(pid) + " 0 0 -1 0 0 0 0 0 " +
+                                 std::to_string(utime) + " 0 0 0 20 0 1 0 " +
+                                 std::to_string(starttime) + " 0 0\n");
+}
+
+static void RemovePid(const std::string& root, int pid) {
+  const std::string directory = root + "/" + std::to_string(pid);
+  std::remove((directory + "/stat").c_str());
+  rmdir(directory.c_str());
+}
+
+static Process* Find(System& system, int pid) {
+  for (Process* process : system.Processes())
+    if (process->Pid() == pid) return process;
+  return nullptr;
+}
+
+static bool Near(float value, double expected) {
+  return std::fabs(value - expected) < 1e-6;
+}
+
+// A record keeps its previous sample from tick to tick, so its CPU is the
+// interval's; a pid that comes back with another start time gets a new
+// record that carries nothing over, and a pid that is gone is dropped.
+static void TestRecordsAcrossTicks(const std::string& root) {
+  const long hertz = sysconf(_SC_CLK_TCK);
+  // 100 s of uptime; both processes started at 50 s.
+  Write(root + "/uptime", "100.00 0.00\n");
+  WriteStat(root, 1000);
+  WritePid(root, 10, 10, 50 * hertz);
+  WritePid(root, 20, 0, 50 * hertz);
+
+  LinuxParser::SetProcDirectory(root);
+  System system(2);
+  Process* process = Find(system, 10);
+  CHECK(process != nullptr && system.Processes().size() == 2);
+  // First sample: the average over the 50 s the process has lived.
+  CHECK(process != nullptr && Near(process->CpuUtilization(),
+                                   10.0 / (50 * hertz)));
+
+  // 200 jiffies over two cores is an interval of 100 ticks, of which the
+  // process spent 50 on a CPU.
+  WriteStat(root, 1200);
+  WritePid(root, 10, 60, 50 * hertz);
+  RemovePid(root, 20);
+  system.Refresh();
+  process = Find(system, 10);
+  CHECK(process != nullptr && Near(process->CpuUtilization(), 0.5));
+  CHECK(Find(system, 20) == nullptr && system.Processes().size() == 1);
+
+  // Pid 10 reused by a process started at 90 s: its 70 jiffies are over
+  // its own 10 s, not 10 more jiffies of the old record's interval.
+  WriteStat(root, 1400);
+  WritePid(root, 10, 70, 90 * hertz);
+  system.Refresh();
+  process = Find(system, 10);
+  CHECK(process != nullptr && process->StartTime() == 90 * hertz);
+  CHECK(process != nullptr && Near(process->CpuUtilization(),
+                                   70.0 / (10 * hertz)));
+
+  RemovePid(root, 10);
+  for (const char* file : {"/stat", "/uptime"})
+    std::remove((root + file).c_str());
+}
+
+int main() {
+  char directory[] = "/tmp/system_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  const std::string root = directory;
+  Write(root + "/meminfo", "MemTotal: 1000 kB\nMemFree: 250 kB\n");
+  TestRecordsAcrossTicks(root);
+  std::remove((root + "/meminfo").c_str());
+  rmdir(directory);
+  return TestFailures();
+}
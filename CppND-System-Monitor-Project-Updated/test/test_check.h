@@ -0,0 +1,22 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+
+// Minimal assertions for the test executables: a failed CHECK is reported
+// and counted, and main() returns TestFailures() so ctest sees the result.
+inline int& TestFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                 \
+  do {                                                                   \
+    if (!(condition)) {                                                  \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: "     \
+                << #condition << std::endl;                              \
+      ++TestFailures();                                                  \
+    }                                                                    \
+  } while (false)
+
+#endif
@@ -0,0 +1,52 @@
+#include <vector>
+
+#include "linux_parser.h"
+#include "test_check.h"
+#include "throughput.h"
+
+using LinuxParser::DiskCounters;
+using LinuxParser::NetCounters;
+
+// Rates of eth0 after its received bytes go from `previous` to `current`
+// in one second.
+static float ReceiveRate(unsigned long long previous,
+                         unsigned long long current) {
+  Throughput throughput;
+  const std::vector<DiskCounters> disks;
+  std::vector<NetCounters> interfaces{{"eth0", previous, 0}};
+  throughput.Update(disks, interfaces, 10);  // Since boot.
+  interfaces[0].rx_bytes = current;
+  throughput.Update(disks, interfaces, 11);
+  return throughput.Interfaces()[0].rxBytes;
+}
+
+// A 32-bit counter near the top of its range that steps back wrapped.
+static void TestWrapOf32BitCounter() {
+  CHECK(ReceiveRate(0xFFFFFF00ULL, 0x100ULL) == 512.f);
+  CHECK(ReceiveRate(0xC0000000ULL, 0x10ULL) == 0x40000010ULL);
+}
+
+// A counter reset while still small, e.g. an interface bounced at 1 GB
+// received, is idle rather than a jump of almost 4 GB.
+static void TestResetIsIdle() {
+  CHECK(ReceiveRate(1000000000ULL, 1000ULL) == 0.f);
+  CHECK(ReceiveRate(0xBFFFFFFFULL, 0ULL) == 0.f);
+  CHECK(ReceiveRate(1ULL << 40, 1000ULL) == 0.f);
+}
+
+static void TestDiskSectorsWrap() {
+  Throughput throughput;
+  std::vector<DiskCounters> disks{{"sda", 0, 0xFFFFFFF0ULL, 0, 0}};
+  const std::vector<NetCounters> interfaces;
+  throughput.Update(disks, interfaces, 10);
+  disks[0].sectors_read = 0x10;
+  throughput.Update(disks, interfaces, 12);
+  CHECK(throughput.Disks()[0].readBytes == 0x20 * 512 / 2);
+}
+
+int main() {
+  TestWrapOf32BitCounter();
+  TestResetIsIdle();
+  TestDiskSectorsWrap();
+  return TestFailures();
+}